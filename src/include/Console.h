@@ -208,6 +208,15 @@
    bool checkAdaptation(bool &status);
    /** Indicates whether model is in adaptive mode */
    bool isAdapting() const;
+   /**
+    * Sets the temperatures of the chains for parallel tempering. An
+    * empty vector turns parallel tempering off. This is the only
+    * interface to parallel tempering: there is no corresponding
+    * command in the terminal parser.
+    *
+    * @see Model#setTemperatures
+    */
+   bool setTemperatures(std::vector<double> const &temp);
    /** Clears the model */
    void clearModel();
    /**
@@ -227,6 +227,7 @@
 #define lchoose		jags_lchoose
 #define lgammafn	jags_lgammafn
 #define lgammafn_sign	jags_lgammafn_sign
+#define lfactorial	jags_lfactorial
 #define lgamma1p	jags_lgamma1p
 #define log1pmx		jags_log1pmx
 #define logspace_add	jags_logspace_add
@@ -545,6 +546,7 @@ double	lbeta(double, double);
 
 double	choose(double, double);
 double	lchoose(double, double);
+double	lfactorial(double); /* log(x!), tabulated for small integer x */
 
 	/* Bessel Functions */
 
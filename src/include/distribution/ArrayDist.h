@@ -117,6 +117,27 @@ public:
      */
     virtual unsigned long df(std::vector<std::vector<unsigned long> > const &dims)
 	const;
+    /**
+     * Calculates the derivatives of the full log density with respect
+     * to x and the parameters.
+     *
+     * @param gx Array of size length to which the derivatives with
+     * respect to x are written.
+     *
+     * @param gpar Vector of length npar(). Each element points to an
+     * array, with the size of the corresponding parameter, to which
+     * the derivatives with respect to the parameter are written.
+     *
+     * @returns true if the derivatives were calculated. The default
+     * implementation returns false, indicating that the distribution
+     * does not provide derivatives.
+     */
+    virtual bool 
+	gradLogDensity(double *gx, std::vector<double *> const &gpar,
+		       double const *x, unsigned long length,
+		       std::vector<double const *> const &parameters,
+		       std::vector<std::vector<unsigned long> > const &dims,
+		       double const *lbound, double const *ubound) const;
     /**
      * Returns the support of an unbounded distribution
      */
@@ -73,6 +73,27 @@ class ScalarDist : public Distribution
 			    std::vector<double const *> const &parameters,
 			    double const *lbound, double const *ubound)
       const = 0;
+  /**
+   * Calculates the derivatives of the full log density with respect
+   * to x and the parameters.
+   *
+   * @param gx Pointer to which the derivative with respect to x is
+   * written. For discrete-valued distributions this is zero.
+   *
+   * @param gpar Array of length npar() to which the derivatives with
+   * respect to the parameters are written.
+   *
+   * @returns true if the derivatives were calculated. The default
+   * implementation returns false, indicating that the distribution
+   * does not provide derivatives. Truncated distributions are not
+   * supported, because the normalizing constant depends on the
+   * parameters, so implementations should return false if either
+   * lbound or ubound is not NULL.
+   */
+  virtual bool gradLogDensity(double *gx, double *gpar, double x,
+			      std::vector<double const *> const &parameters,
+			      double const *lbound, double const *ubound)
+      const;
   /**
    * Draws a random sample 
    */
@@ -122,6 +122,29 @@ class VectorDist : public Distribution
      * case, the df member function must be overrideen.
      */
     virtual unsigned long df(std::vector<unsigned long> const &lengths) const;
+    /**
+     * Calculates the derivatives of the full log density with respect
+     * to x and the parameters.
+     *
+     * @param gx Array of size length to which the derivatives with
+     * respect to x are written. For discrete-valued distributions
+     * these are zero.
+     *
+     * @param gpar Vector of length npar(). Each element points to an
+     * array, of the length given by the corresponding element of
+     * lengths, to which the derivatives with respect to the parameter
+     * are written.
+     *
+     * @returns true if the derivatives were calculated. The default
+     * implementation returns false, indicating that the distribution
+     * does not provide derivatives.
+     */
+    virtual bool gradLogDensity(double *gx, std::vector<double *> const &gpar,
+				double const *x, unsigned long length,
+				std::vector<double const *> const &parameters,
+				std::vector<unsigned long> const &lengths,
+				double const *lbound, double const *ubound)
+	const;
     /**
      * Returns a Monte Carlo estimate of the Kullback-Leibler
      * divergence between distributions with two different parameter
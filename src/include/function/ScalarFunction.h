@@ -26,6 +26,21 @@ public:
      */
     virtual bool 
 	checkParameterValue(std::vector<double const *> const &args) const;
+    /**
+     * Calculates the partial derivatives of the function with respect
+     * to each of its arguments.
+     *
+     * @param grad Array of length args.size() to which the
+     * derivatives are written.
+     *
+     * @param args Vector of arguments
+     *
+     * @returns true if the derivatives were calculated. The default
+     * implementation returns false, indicating that the function is
+     * not differentiable.
+     */
+    virtual bool gradient(double *grad,
+			  std::vector<double const *> const &args) const;
     /**
      * Tests whether the function preserves power transformations,
      * i.e.  can be expressed as f(x) = a*b^x for some value of a,b,
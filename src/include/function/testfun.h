@@ -3,6 +3,7 @@
 
 #include "ScalarFunction.h"
 #include "VectorFunction.h"
+#include "LinkFunction.h"
 
 /*
   Function in JAGS are set up to take vectors of pointers as
@@ -69,6 +70,14 @@ bool checkargs(jags::ScalarFunction const *f, double x, double y);
 double eval(jags::ScalarFunction const *f, double x, double y, double z);
 bool checkargs(jags::ScalarFunction const *f, double x, double y, double z);
 
+//Check the gradient of a scalar function against central finite
+//differences at the given arguments
+void checkGradient(jags::ScalarFunction const *f,
+		   std::vector<double> const &x);
+
+//Check the gradient of the inverse link function at eta
+void checkGradient(jags::LinkFunction const *f, double eta);
+
 /* Tests for vector functions */
 
 //Convert a double to a vector of length 1
@@ -71,6 +71,13 @@ public:
      * this function always returns true.
      */
     bool checkParentValues(unsigned int chain) const;
+    /**
+     * The derivatives are passed back to the corresponding elements
+     * of the parents.
+     */
+    bool accumulateGradient(double const *adj,
+			    std::vector<double *> const &parent_adj,
+			    unsigned int chain) const;
     /**
      * An aggregate node is named after its first and last parents
      */
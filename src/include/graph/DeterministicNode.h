@@ -121,6 +121,27 @@ public:
      * @param chain Number of chain from which to draw sample
      */
     virtual void deterministicSample(unsigned int chain) = 0;
+    /**
+     * Reverse-mode differentiation step. Given the derivatives of
+     * some scalar quantity with respect to the value of this node,
+     * adds the implied derivatives with respect to the values of the
+     * parents.
+     *
+     * @param adj Array of size length() containing the derivatives
+     * with respect to the value of this node
+     *
+     * @param parent_adj Vector of the same length as parents(). Each
+     * element points to an array, of the same size as the parent, to
+     * which the derivatives are added, or is NULL if the derivatives
+     * with respect to that parent are not required.
+     *
+     * @returns true if the derivatives were calculated. The default
+     * implementation returns false, indicating that the node is not
+     * differentiable.
+     */
+    virtual bool accumulateGradient(double const *adj,
+				    std::vector<double *> const &parent_adj,
+				    unsigned int chain) const;
 
    /**
     * Returns the log of the density of a StochasticNode
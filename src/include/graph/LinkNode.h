@@ -29,6 +29,13 @@ public:
      * value in the range [-Inf, Inf].
      */
     bool checkParentValues(unsigned int chain) const;
+    /**
+     * Link nodes are always differentiable.
+     * @see LinkFunction#grad
+     */
+    bool accumulateGradient(double const *adj,
+			    std::vector<double *> const &parent_adj,
+			    unsigned int chain) const;
     /**
      * Returns the linear predictor
      */
@@ -32,6 +32,12 @@ public:
      * @see ScalarFunction#checkParameterValue.
      */
     bool checkParentValues(unsigned int chain) const;
+    /**
+     * @see ScalarFunction#gradient
+     */
+    bool accumulateGradient(double const *adj,
+			    std::vector<double *> const &parent_adj,
+			    unsigned int chain) const;
     //DeterministicNode *clone(std::vector<Node const *> const &parents) const;
 };
 
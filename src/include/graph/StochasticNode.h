@@ -181,6 +181,26 @@ public:
     virtual unsigned long df() const = 0;
     virtual double KL(unsigned int chain1, unsigned int chain2, RNG *rng,
 		      unsigned int nrep) const = 0;
+    /**
+     * Adds the derivatives of the log density of the node, with
+     * respect to its value and the values of its parents, to the
+     * supplied arrays. This is a step in the reverse-mode calculation
+     * of derivatives of a GraphView.
+     *
+     * @param gx Array of size length() or NULL if the derivatives
+     * with respect to the value of the node are not required
+     *
+     * @param gpar Vector of the same length as parents(). Each
+     * element points to an array, of the same size as the parent, or
+     * is NULL if the derivatives with respect to that parent are not
+     * required.
+     *
+     * @returns true if the derivatives were calculated. The default
+     * implementation returns false.
+     */
+    virtual bool accumulateGradient(double *gx, 
+				    std::vector<double *> const &gpar,
+				    unsigned int chain) const;
     void unlinkParents();
 	
     /**
@@ -29,6 +29,8 @@ public:
     void truncatedSample(RNG *rng, unsigned int chain,
 			 double const *lower, double const *upper);
     bool checkParentValues(unsigned int chain) const;
+    bool accumulateGradient(double *gx, std::vector<double *> const &gpar,
+			    unsigned int chain) const;
     //StochasticNode *clone(std::vector<Node const *> const &parents,
     //Node const *lower, Node const *upper) const;
     unsigned long df() const;
@@ -40,10 +40,18 @@ private:
   bool _is_initialized;
   bool _adapt;
   bool _data_gen;
+  std::vector<double> _temperature;
+  std::vector<StochasticNode*> _tempered_nodes;
+  std::vector<Node*> _swap_nodes;
+  std::vector<double> _loglik;
+  std::vector<unsigned int> _nswap;
+  unsigned int _nswap_tried; //Number of rounds of swaps
   void initializeNodes();
   void chooseRNGs();
   void chooseSamplers();
   void setSampledExtra();
+  double temperedLogLikelihood(unsigned int chain) const;
+  void swapChains();
 public:
   /**
    * @param nchain Number of parallel chains in the model.
@@ -180,6 +188,41 @@ public:
    * adaptOff function has been called).
    */
   bool isAdapting() const;
+  /**
+   * Turns on parallel tempering across chains. Chain n is run at
+   * temperature temp[n], at which the log likelihood of the observed
+   * stochastic nodes is divided by temp[n]. After each iteration,
+   * swaps of the current values between neighbouring chains are
+   * proposed, alternating between even and odd pairs of chains, and
+   * accepted with the Metropolis-Hastings acceptance probability.
+   * The first round of swaps after tempering is turned on uses the
+   * even pairs, whatever the current iteration. Only the first
+   * chain, which must have temperature 1, draws samples from the
+   * posterior distribution.
+   *
+   * All samplers with observed stochastic children must be
+   * temperable, otherwise a runtime_error is thrown.
+   *
+   * Parallel tempering is only available through the C++ API
+   * (this function and Console#setTemperatures). There is no
+   * command for it in the terminal interface.
+   *
+   * @param temp Vector of temperatures, one for each chain. An empty
+   * vector turns tempering off.
+   *
+   * @see Sampler#isTemperable
+   */
+  void setTemperatures(std::vector<double> const &temp);
+  /**
+   * Returns the temperatures of the chains, or an empty vector if
+   * parallel tempering is not in use.
+   */
+  std::vector<double> const &temperatures() const;
+  /**
+   * Returns the proportion of accepted swaps between chains n and
+   * n + 1, for each n, since tempering was turned on.
+   */
+  std::vector<double> swapAcceptance() const;
   /**
    * Returns a vector of all stochastic nodes in the model
    */
@@ -44,6 +44,7 @@ class Module {
     std::vector<DistPtr> _dp_list;
     std::vector<Distribution*> _distributions;
     std::vector<SamplerFactory*> _sampler_factories;
+    std::vector<bool> _sampler_active;
     std::vector<RNGFactory*> _rng_factories;
     std::vector<MonitorFactory*> _monitor_factories;
 public:
@@ -76,7 +77,12 @@ public:
     void insert(ArrayDist*, VectorFunction*);
     void insert(ArrayDist*, ArrayFunction*);
 
-    void insert(SamplerFactory*);
+    /**
+     * Inserts a sampler factory. A factory that is not active is
+     * skipped when samplers are chosen until it is switched on by the
+     * user, e.g. with Console#setFactoryActive.
+     */
+    void insert(SamplerFactory*, bool active = true);
     void insert(RNGFactory*);
     void insert(MonitorFactory*);
 
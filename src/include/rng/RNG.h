@@ -54,6 +54,33 @@ struct RNG
      * Generates are andom value with an exponential distribution
      */
     virtual double exponential() = 0;
+    /**
+     * Fills an array with independent uniform random values on
+     * (0,1). The values are the same as those given by n successive
+     * calls to uniform(). The default implementation simply calls
+     * uniform() n times. Subclasses may override it to avoid a
+     * virtual function call for each value.
+     *
+     * @param x Array of length n to which the values are written
+     * @param n Number of values to generate
+     */
+    virtual void uniform(double *x, unsigned long n);
+    /**
+     * Fills an array with independent standard normal random values.
+     * The values are the same as those given by n successive calls
+     * to normal().
+     *
+     * @see RNG#uniform(double*, unsigned long)
+     */
+    virtual void normal(double *x, unsigned long n);
+    /**
+     * Fills an array with independent exponential random values.
+     * The values are the same as those given by n successive calls
+     * to exponential().
+     *
+     * @see RNG#uniform(double*, unsigned long)
+     */
+    virtual void exponential(double *x, unsigned long n);
     /**
      * This static utility function may be used by an RNG object to coerce
      * values in the range [0,1] to the open range (0,1)
@@ -5,26 +5,49 @@
 
 namespace jags {
 
-enum NormKind {AHRENS_DIETER, BOX_MULLER, KINDERMAN_RAMAGE};
+enum NormKind {AHRENS_DIETER, BOX_MULLER, KINDERMAN_RAMAGE, ZIGGURAT};
 
 /**
  * @short RNG object based on the R math library
  * 
  * An RmathRNG object implements the normal and exponential functions
  * using code from the R math library.  
+ *
+ * The ZIGGURAT kind uses the Ziggurat method of Marsaglia and Tsang
+ * (2000) for both normal and exponential random variables. The layer
+ * and the abscissa are taken from separate uniforms, so that the
+ * abscissa has the full precision of the generator even when this is
+ * only 32 bits. Most draws need two uniforms and no transcendental
+ * functions. The suffix "-Ziggurat" is added to the
+ * name of a generator using this method so that it can be recreated
+ * by RNGFactory#makeRNG.
  */
 class RmathRNG : public RNG
 {
     NormKind _N01_kind;
     double _BM_norm_keep;
+    double zigNormal();
+    double zigExponential();
 public:
     /**
      * @param norm_kind Defines the algorithm for producing normal random
-     * variables
+     * variables, and for exponential random variables if it is
+     * ZIGGURAT.
      */
     RmathRNG(std::string const &name, NormKind norm_kind);
     double normal();
     double exponential();
+    void normal(double *x, unsigned long n);
+    void exponential(double *x, unsigned long n);
+    /**
+     * Splits the name of a generator into its base name and the
+     * normal kind. Names with the suffix "-Ziggurat" give ZIGGURAT
+     * and others give the default KINDERMAN_RAMAGE.
+     *
+     * @param name Name of the generator
+     * @param basename Name without the suffix, on exit.
+     */
+    static NormKind normKind(std::string const &name, std::string &basename);
 };
 
 } /* namespace jags */
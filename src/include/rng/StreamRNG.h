@@ -0,0 +1,38 @@
+#ifndef STREAM_RNG_H_
+#define STREAM_RNG_H_
+
+#include <rng/RmathRNG.h>
+
+namespace jags {
+
+/**
+ * @short RNG for a sub-stream of a chain
+ *
+ * A StreamRNG is a small, fast generator that is used when a
+ * sampling method divides its work within a single chain into
+ * independent pieces that may be run in parallel. Each piece is
+ * given its own StreamRNG, seeded from the RNG of the chain. If the
+ * division into pieces does not depend on the number of threads,
+ * the results are reproducible.
+ *
+ * The generator is Marsaglia's xorshift128 (Marsaglia G (2003)
+ * Xorshift RNGs, Journal of Statistical Software 8(14)).
+ */
+class StreamRNG : public RmathRNG
+{
+    unsigned int I[4];
+public:
+    /**
+     * Creates a StreamRNG with the given seed.
+     */
+    StreamRNG(unsigned int seed);
+    void init(unsigned int seed);
+    bool setState(std::vector<int> const &state);
+    void getState(std::vector<int> &state) const;
+    double uniform();
+    void uniform(double *x, unsigned long n);
+};
+
+} /* namespace jags */
+
+#endif /* STREAM_RNG_H_ */
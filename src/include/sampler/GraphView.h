@@ -44,6 +44,9 @@ class GraphView {
   std::vector<StochasticNode *> _stoch_children;
   std::vector<DeterministicNode*> _determ_children;
   bool _multilevel;
+  std::vector<double> _inv_temp;
+  std::vector<bool> _observed;
+  double sumLikelihood(unsigned int chain) const;
   void classifyChildren(std::vector<StochasticNode *> const &nodes,
 			Graph const &graph,
 			std::vector<StochasticNode *> &stoch_nodes,
@@ -124,6 +127,20 @@ public:
    * @param chain Number of the chain (starting from zero) to query.
    */
   double logFullConditional(unsigned int chain) const;
+  /**
+   * Calculates the derivatives of the log full conditional density
+   * with respect to the values of the sampled nodes, by a reverse
+   * sweep over the stochastic and deterministic children.
+   *
+   * @param grad Array of length length() to which the derivatives
+   * are written, in the same order as the values used by setValue.
+   *
+   * @param chain Number of the chain (starting from zero) to query.
+   *
+   * @returns true if the derivatives were calculated, false if any
+   * node in the GraphView is not differentiable.
+   */
+  bool gradLogFullConditional(double *grad, unsigned int chain) const;
   /**
    * Calculates the log prior density of the sampled nodes, i.e. the
    * density conditioned only on the parents.
@@ -144,6 +161,23 @@ public:
    * before sampling.
    */
   void checkFinite(unsigned int chain) const;
+  /**
+   * Sets the temperature of each chain, for parallel tempering. At
+   * temperature T, the log density L of each observed stochastic
+   * child is replaced by L/T in the log full conditional density
+   * and the log likelihood. Unobserved stochastic children are part
+   * of the prior distribution and are not tempered.
+   *
+   * @param temp Vector of temperatures, one for each chain. An empty
+   * vector switches tempering off.
+   */
+  void setTemperature(std::vector<double> const &temp);
+  /**
+   * Tests whether any of the stochastic children are observed. If
+   * not, the full conditional distribution does not depend on the
+   * temperature.
+   */
+  bool hasObservedChildren() const;
 };
 
 unsigned int nchain(GraphView const *gv);
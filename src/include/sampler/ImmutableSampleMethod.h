@@ -16,6 +16,14 @@ namespace jags {
 	 * Draws another sample from the target distribution
 	 */
 	virtual void update(unsigned int chain, RNG *rng) const = 0;
+	/**
+	 * Indicates whether the sample method draws from the tempered
+	 * full conditional distribution when the GraphView has a
+	 * temperature. The default is false.
+	 *
+	 * @see MutableSampleMethod#isTemperable
+	 */
+	virtual bool isTemperable() const;
     };
 
 } /* namespace jags */
@@ -53,6 +53,10 @@ namespace jags {
 	 * This always returns true
 	 */
 	bool checkAdaptation() const;
+	/**
+	 * The sampler is temperable if its sample method is.
+	 */
+	bool isTemperable() const;
 	/**
 	 * Returns the name of the sampler, as given to the constructor.b
 	 */
@@ -50,6 +50,13 @@ public:
      * @returns success indicator
      */
     bool accept(RNG *rng, double prob);
+    /**
+     * Stores the current value as the last accepted value. Samplers
+     * that support parallel tempering must call this at the start of
+     * each update, since swaps between chains change the current
+     * value without a call to Metropolis#accept.
+     */
+    void refreshValue();
     /**
      * Rescales the proposal distribution. This function is called by
      * Metropolis#accept when the sampler is in adaptive
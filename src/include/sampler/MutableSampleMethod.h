@@ -28,6 +28,13 @@ public:
      * Checks adaptation 
      */
     virtual bool checkAdaptation() const = 0;
+    /**
+     * Indicates whether the sample method draws from the tempered
+     * full conditional distribution when the GraphView has a
+     * temperature. This is the case for methods that use only the
+     * log density functions of GraphView. The default is false.
+     */
+    virtual bool isTemperable() const;
 };
 
 } /* namespace jags */
@@ -42,6 +42,10 @@ namespace jags {
 	bool isAdaptive() const;
 	void adaptOff();
 	bool checkAdaptation() const;
+	/**
+	 * The sampler is temperable if all its sample methods are.
+	 */
+	bool isTemperable() const;
 	/**
 	 * Returns the name of the sampler, as given to the constructor
 	 */
@@ -0,0 +1,67 @@
+#ifndef NODE_GROUPS_H_
+#define NODE_GROUPS_H_
+
+#include <vector>
+#include <map>
+
+namespace jags {
+
+    class StochasticNode;
+
+    /**
+     * @short Partition of stochastic nodes into groups
+     *
+     * Factories for block samplers often update together the nodes
+     * that share a stochastic child, as these are correlated in the
+     * posterior. NodeGroups finds the groups of nodes that are
+     * connected in this way using a disjoint set forest, so that the
+     * cost is nearly linear in the total number of stochastic
+     * children.
+     *
+     * Each node is initially in a group of its own. Groups are
+     * joined by calls to join or joinChildren, and the resulting
+     * partition is returned by groups.
+     */
+    class NodeGroups {
+	std::vector<StochasticNode*> const _nodes;
+	std::vector<unsigned int> _parent;
+	std::map<StochasticNode const*, unsigned int> _index, _owner;
+	unsigned int findRoot(unsigned int i);
+      public:
+	/**
+	 * Constructor
+	 *
+	 * @param nodes Nodes to be partitioned
+	 */
+	NodeGroups(std::vector<StochasticNode*> const &nodes);
+	/**
+	 * Returns the position of a node in the vector given to the
+	 * constructor, or the length of that vector if the node is not
+	 * being partitioned.
+	 */
+	unsigned int index(StochasticNode const *node) const;
+	/**
+	 * Joins the groups containing nodes i and j
+	 */
+	void join(unsigned int i, unsigned int j);
+	/**
+	 * Joins the group containing node i with the groups of all
+	 * other nodes that have been given any of the same stochastic
+	 * children in previous calls.
+	 *
+	 * @param i Index of the node
+	 * @param children Stochastic children of node i, usually
+	 * obtained from a SingletonGraphView.
+	 */
+	void joinChildren(unsigned int i,
+			  std::vector<StochasticNode*> const &children);
+	/**
+	 * Returns the groups. Within each group, the nodes are in the
+	 * same order as in the vector given to the constructor.
+	 */
+	std::vector<std::vector<StochasticNode*> > groups();
+    };
+
+} /* namespace jags */
+
+#endif /* NODE_GROUPS_H_ */
@@ -77,6 +77,24 @@ public:
      * it uses to update the nodes.
      */
     virtual std::string name() const = 0;
+    /**
+     * Indicates whether the sampler respects the temperature set by
+     * GraphView#setTemperature, i.e. whether it draws from the
+     * tempered full conditional distribution. By default it does
+     * not.
+     */
+    virtual bool isTemperable() const;
+    /**
+     * Sets the temperature of each chain, for parallel tempering.
+     *
+     * @param temp Vector of temperatures, one for each chain. An
+     * empty vector switches tempering off.
+     *
+     * @return false if the sampler cannot be tempered. This happens
+     * if the sampler is not temperable and the sampled nodes have
+     * observed stochastic children.
+     */
+    bool setTemperature(std::vector<double> const &temp);
 };
 
 } /* namespace jags */
@@ -0,0 +1,176 @@
+#ifndef UTIL_VALUE_CACHE_H_
+#define UTIL_VALUE_CACHE_H_
+
+#include <map>
+#include <vector>
+#include <algorithm>
+
+namespace jags {
+
+/**
+ * @short Cache of quantities calculated from parameter values
+ *
+ * Distributions and functions are shared by all nodes and chains, so
+ * they cannot store quantities that are expensive to calculate from
+ * their parameters, such as a matrix factorization. A ValueCache
+ * holds such quantities, keyed on the address of the parameter
+ * array. The address of a parameter value identifies the parent node
+ * and the chain.
+ *
+ * Each entry holds a copy of the array from which it was calculated,
+ * and it is returned only while the values at that address are
+ * unchanged. Hence a quantity calculated from a fixed parameter is
+ * calculated once.
+ *
+ * The storage held by the cache is limited to a fixed number of
+ * bytes. The cache counts the copies of the parameter arrays, and the
+ * user counts the storage of each entry with charge and release.
+ * When the limit is exceeded, all other entries are discarded.
+ *
+ * A ValueCache is not thread-safe. It is intended to be declared
+ * thread_local, so that each thread has its own cache and chains that
+ * are updated in parallel do not share entries.
+ */
+template<class T>
+class ValueCache {
+    struct Slot {
+	std::vector<double> key;
+	unsigned long size;
+	T value;
+	Slot() : size(0) {}
+    };
+    std::map<double const *, Slot> _slots;
+    unsigned long _size;
+    unsigned long const _limit;
+    void discardOthers(double const *x);
+  public:
+    /**
+     * Constructor.
+     *
+     * @param limit Maximum number of bytes held by the cache
+     */
+    ValueCache(unsigned long limit);
+    /**
+     * Returns a pointer to the entry for array x, or a NULL pointer
+     * if there is no entry or if it was calculated from different
+     * values.
+     *
+     * @param x Pointer to the parameter array
+     * @param n Length of the array
+     */
+    T *find(double const *x, unsigned long n);
+    /**
+     * Creates an entry for array x, storing a copy of its values. If
+     * there is already an entry for x then it is returned with its
+     * old contents, so that their storage can be reused. The caller
+     * must overwrite them, and charge again for any storage they
+     * hold.
+     *
+     * @param x Pointer to the parameter array
+     * @param n Length of the array
+     */
+    T &insert(double const *x, unsigned long n);
+    /**
+     * Adds to the storage counted for the entry for x. If the limit
+     * is exceeded, all other entries are discarded.
+     *
+     * @param x Pointer to the parameter array
+     * @param size Number of bytes
+     *
+     * @return false if the entry for x alone exceeds the limit
+     */
+    bool charge(double const *x, unsigned long size);
+    /**
+     * Subtracts from the storage counted for the entry for x, when
+     * some of its contents are discarded.
+     *
+     * @param x Pointer to the parameter array
+     * @param size Number of bytes
+     */
+    void release(double const *x, unsigned long size);
+    /**
+     * Discards the entry for x
+     */
+    void erase(double const *x);
+};
+
+template<class T>
+ValueCache<T>::ValueCache(unsigned long limit)
+    : _size(0), _limit(limit)
+{
+}
+
+template<class T>
+T *ValueCache<T>::find(double const *x, unsigned long n)
+{
+    typename std::map<double const *, Slot>::iterator p = _slots.find(x);
+    if (p == _slots.end()) {
+	return 0;
+    }
+    std::vector<double> const &key = p->second.key;
+    if (key.size() != n || !std::equal(x, x + n, key.begin())) {
+	return 0;
+    }
+    return &p->second.value;
+}
+
+template<class T>
+T &ValueCache<T>::insert(double const *x, unsigned long n)
+{
+    Slot &slot = _slots[x];
+    _size -= slot.size;
+    slot.key.assign(x, x + n);
+    slot.size = n * sizeof(double);
+    _size += slot.size;
+    if (_size > _limit) {
+	discardOthers(x);
+    }
+    return slot.value;
+}
+
+template<class T>
+bool ValueCache<T>::charge(double const *x, unsigned long size)
+{
+    _slots[x].size += size;
+    _size += size;
+    if (_size > _limit) {
+	discardOthers(x);
+    }
+    return _size <= _limit;
+}
+
+template<class T>
+void ValueCache<T>::release(double const *x, unsigned long size)
+{
+    _slots[x].size -= size;
+    _size -= size;
+}
+
+template<class T>
+void ValueCache<T>::erase(double const *x)
+{
+    typename std::map<double const *, Slot>::iterator p = _slots.find(x);
+    if (p != _slots.end()) {
+	_size -= p->second.size;
+	_slots.erase(p);
+    }
+}
+
+template<class T>
+void ValueCache<T>::discardOthers(double const *x)
+{
+    typename std::map<double const *, Slot>::iterator p = _slots.begin();
+    while (p != _slots.end()) {
+	if (p->first == x) {
+	    _size = p->second.size;
+	    ++p;
+	}
+	else {
+	    _slots.erase(p++);
+	}
+    }
+}
+
+} /* namespace jags */
+
+#endif /* UTIL_VALUE_CACHE_H_ */
@@ -93,6 +93,8 @@ double lchoose(double n, double k)
 	/* k <= n :*/
 	if(n - k < 2) return lchoose(n, n-k); /* <- Symmetry */
 	/* else: n >= k+2 */
+	if (n < LFACT_TABLE_MAX)
+	    return lfactorial(n) - lfactorial(k) - lfactorial(n - k);
 	return lfastchoose(n, k);
     }
     /* else non-integer n >= 0 : */
@@ -0,0 +1,74 @@
+/*
+ *  DESCRIPTION
+ *
+ *    lfactorial(x) := log(x!) = lgammafn(x + 1)
+ *
+ *    Count distributions evaluate the log factorial of the same
+ *    small integers over and over again, so for non-negative
+ *    integers below LFACT_TABLE_MAX the values are looked up in a
+ *    table. The table is shared by all threads and is filled lazily,
+ *    in blocks, as larger arguments are seen. A block is calculated
+ *    and then published with an atomic compare-and-swap, so no lock
+ *    is needed. Two threads may occasionally calculate the same
+ *    block, in which case one copy is discarded.
+ *
+ *    Other arguments are passed to lgammafn.
+ */
+
+#include <config.h>
+#include "nmath.h"
+
+#include <atomic>
+
+#define LFACT_BLOCK 1024
+#define LFACT_NBLOCK (LFACT_TABLE_MAX / LFACT_BLOCK)
+
+namespace {
+
+    //Static storage, so the block pointers are initially null
+    struct LFactTable {
+	std::atomic<double *> block[LFACT_NBLOCK];
+	~LFactTable()
+	{
+	    for (unsigned int b = 0; b < LFACT_NBLOCK; ++b) {
+		delete [] block[b].exchange(0);
+	    }
+	}
+    };
+
+    LFactTable table;
+
+    double const *getBlock(unsigned int b)
+    {
+	double *block = table.block[b].load(std::memory_order_acquire);
+	if (block == 0) {
+	    double *newblock = new double[LFACT_BLOCK];
+	    double n = b * LFACT_BLOCK;
+	    for (unsigned int i = 0; i < LFACT_BLOCK; ++i, ++n) {
+		newblock[i] = n < 2 ? 0 : lgammafn(n + 1);
+	    }
+	    if (table.block[b].compare_exchange_strong(block, newblock,
+						       std::memory_order_acq_rel))
+	    {
+		block = newblock;
+	    }
+	    else {
+		//Another thread got there first: block now points to its copy
+		delete [] newblock;
+	    }
+	}
+	return block;
+    }
+
+}
+
+double lfactorial(double x)
+{
+    if (x >= 0 && x < LFACT_TABLE_MAX) {
+	unsigned int n = static_cast<unsigned int>(x);
+	if (n == x) {
+	    return getBlock(n / LFACT_BLOCK)[n % LFACT_BLOCK];
+	}
+    }
+    return lgammafn(x + 1);
+}
@@ -72,6 +72,8 @@ double	jags_gamma_cody(double);
 #endif
 //R >= 3.1.0: # define R_nonint(x) 	  (fabs((x) - R_forceint(x)) > 1e-7)
 # define R_nonint(x) 	  (fabs((x) - R_forceint(x)) > 1e-7*fmax2(1., fabs(x)))
+/* Absolute tolerance, used by the JAGS count distributions */
+#define R_D_nonint(x)	(fabs((x) - floor((x)+0.5)) > 1e-7)
 
 /* Mathlib standalone */
 
@@ -173,6 +175,8 @@ double  attribute_hidden stirlerr(double);  /* Stirling expansion "error" */
 
 double	attribute_hidden lfastchoose(double, double);
 
+#define LFACT_TABLE_MAX 65536 /* lfactorial is tabulated below this */
+
 double  attribute_hidden bd0(double, double);
 
 double	attribute_hidden dbinom_raw(double, double, double, double, int);
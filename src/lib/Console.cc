@@ -660,6 +660,25 @@ bool Console::adaptOff(void)
   return true;
 }
 
+bool Console::setTemperatures(vector<double> const &temp)
+{
+  if (_model == 0) {
+    _err << "Cannot set temperatures. No model!" << endl;
+    return false;
+  }
+  if (!_model->isInitialized()) {
+    _err << "Cannot set temperatures. Model not initialized" << endl;
+    return false;
+  }
+
+  try {
+      _model->setTemperatures(temp);
+  }
+  CATCH_ERRORS;
+
+  return true;
+}
+
 bool Console::isAdapting() const
 {
     return _model ? _model->isAdapting() : false;
@@ -18,6 +18,15 @@ unsigned long ArrayDist::df(vector<vector<unsigned long> > const &pdims) const
     return product(dim(pdims));
 }
 
+bool ArrayDist::gradLogDensity(double *gx, vector<double *> const &gpar,
+			       double const *x, unsigned long length,
+			       vector<double const *> const &parameters,
+			       vector<vector<unsigned long> > const &dims,
+			       double const *lbound, double const *ubound) const
+{
+    return false;
+}
+
     
     double ArrayDist::KL(vector<double const *> const &par1,
 			 vector<double const *> const &par2,
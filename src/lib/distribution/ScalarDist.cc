@@ -75,6 +75,13 @@ unsigned long ScalarDist::df() const
     return 1;
 }
 
+bool ScalarDist::gradLogDensity(double *gx, double *gpar, double x,
+				vector<double const *> const &parameters,
+				double const *lbound, double const *ubound) const
+{
+    return false;
+}
+
     double ScalarDist::KL(vector<double const *> const &par1,
 			  vector<double const *> const &par2,
 			  double const *lower, double const *upper,
@@ -17,6 +17,15 @@ unsigned long VectorDist::df(vector<unsigned long> const &par) const
     return length(par);
 }
 
+bool VectorDist::gradLogDensity(double *gx, vector<double *> const &gpar,
+				double const *x, unsigned long length,
+				vector<double const *> const &parameters,
+				vector<unsigned long> const &lengths,
+				double const *lbound, double const *ubound) const
+{
+    return false;
+}
+
     double VectorDist::KL(vector<double const *> const &par1,
 			  vector<double const *> const &par2,
 			  vector<unsigned long> const &lengths,
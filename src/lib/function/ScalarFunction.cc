@@ -21,6 +21,12 @@ ScalarFunction::checkParameterValue(vector<double const *> const &args) const
     return true;
 }
 
+bool ScalarFunction::gradient(double *grad,
+			      vector<double const *> const &args) const
+{
+    return false;
+}
+
 bool ScalarFunction::isPower(vector<bool> const &mask,
 			     vector<bool> const &isfixed) const
 {
@@ -6,6 +6,7 @@
 
 using jags::ScalarFunction;
 using jags::VectorFunction;
+using jags::LinkFunction;
 using jags::Function;
 
 #include <climits>
@@ -16,6 +17,8 @@ using std::vector;
 using std::string;
 using std::copy;
 using std::floor;
+using std::fabs;
+using std::max;
 
 /* All functions */
 
@@ -280,6 +283,55 @@ bool checkargs(ScalarFunction const *f, double x, double y, double z)
     return checkArgs(f, mkArgs(&x, &y, &z));
 }
 
+/*
+   Step size for central difference approximations to derivatives.
+   The step is relative to the size of x so that the truncation and
+   rounding errors are both small compared with the tolerance used in
+   checkDeriv.
+*/
+static double fdStep(double x)
+{
+    return 1.0E-5 * max(1.0, fabs(x));
+}
+
+static void checkDeriv(string const &name, double deriv, double fd)
+{
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(name, fd, deriv,
+					 1.0E-6 * max(1.0, fabs(fd)));
+}
+
+void checkGradient(ScalarFunction const *f, vector<double> const &x)
+{
+    unsigned long n = x.size();
+    CPPUNIT_ASSERT_MESSAGE(f->name(), checkNPar(f, n));
+
+    vector<double> xp(x);
+    vector<double const *> args(n);
+    for (unsigned long i = 0; i < n; ++i) {
+	args[i] = &xp[i];
+    }
+    CPPUNIT_ASSERT_MESSAGE(f->name(), f->checkParameterValue(args));
+
+    vector<double> grad(n);
+    CPPUNIT_ASSERT_MESSAGE(f->name(), f->gradient(&grad[0], args));
+    for (unsigned long i = 0; i < n; ++i) {
+	double h = fdStep(x[i]);
+	xp[i] = x[i] + h;
+	double fplus = f->evaluate(args);
+	xp[i] = x[i] - h;
+	double fminus = f->evaluate(args);
+	xp[i] = x[i];
+	checkDeriv(f->name(), grad[i], (fplus - fminus) / (2 * h));
+    }
+}
+
+void checkGradient(LinkFunction const *f, double eta)
+{
+    double h = fdStep(eta);
+    double fd = (f->inverseLink(eta + h) - f->inverseLink(eta - h)) / (2 * h);
+    checkDeriv(f->name(), f->grad(eta), fd);
+}
+
 static vector<bool> discreteMask(vector<double const *> const &args,
 				 vector<unsigned long> const &arglen)
 {
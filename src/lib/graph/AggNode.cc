@@ -206,6 +206,18 @@ bool AggNode::checkParentValues(unsigned int) const
    return true;
 }
 
+bool AggNode::accumulateGradient(double const *adj,
+				 vector<double *> const &parent_adj,
+				 unsigned int chain) const
+{
+    for (unsigned long i = 0; i < _length; ++i) {
+	if (parent_adj[i]) {
+	    parent_adj[i][_offsets[i]] += adj[i];
+	}
+    }
+    return true;
+}
+
 string AggNode::deparse(vector<string> const &parents) const
 {
     return string("aggregate(") + parents.front() + "..." + 
@@ -134,6 +134,43 @@ bool ArrayStochasticNode::checkParentValues(unsigned int chain) const
     return _dist->checkParameterValue(_parameters[chain], _dims);
 }
 
+bool ArrayStochasticNode::accumulateGradient(double *gx,
+	                                     vector<double *> const &gpar,
+	                                     unsigned int chain) const
+{
+    vector<double const *> const &par = _parameters[chain];
+    if (!_dist->checkParameterValue(par, _dims)) {
+	return false;
+    }
+
+    vector<double> dx(_length);
+    vector<vector<double> > dpar(par.size());
+    vector<double *> dparp(par.size());
+    for (unsigned int j = 0; j < par.size(); ++j) {
+	dpar[j].resize(parents()[j]->length());
+	dparp[j] = &dpar[j][0];
+    }
+    if (!_dist->gradLogDensity(&dx[0], dparp, _data + _length * chain,
+			       _length, par, _dims,
+			       lowerLimit(chain), upperLimit(chain)))
+    {
+	return false;
+    }
+    if (gx) {
+	for (unsigned long i = 0; i < _length; ++i) {
+	    gx[i] += dx[i];
+	}
+    }
+    for (unsigned int j = 0; j < par.size(); ++j) {
+	if (gpar[j]) {
+	    for (unsigned long k = 0; k < dpar[j].size(); ++k) {
+		gpar[j][k] += dpar[j][k];
+	    }
+	}
+    }
+    return true;
+}
+
     /*
 StochasticNode * 
 ArrayStochasticNode::clone(vector<Node const *> const &parameters,
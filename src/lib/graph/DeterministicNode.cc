@@ -80,6 +80,13 @@ bool DeterministicNode::isFixed() const
     return _fixed;
 }
 
+bool DeterministicNode::accumulateGradient(double const *adj,
+					   vector<double *> const &parent_adj,
+					   unsigned int chain) const
+{
+    return false;
+}
+
     void DeterministicNode::unlinkParents()
     {
 	for (unsigned long i = 0; i < parents().size(); ++i) {
@@ -53,6 +53,16 @@ LinkNode::clone(vector<Node const *> const &parents) const
 }
     */
     
+bool LinkNode::accumulateGradient(double const *adj,
+				  vector<double *> const &parent_adj,
+				  unsigned int chain) const
+{
+    if (parent_adj[0]) {
+	parent_adj[0][0] += adj[0] * _func->grad(*_parameters[chain][0]);
+    }
+    return true;
+}
+
 double LinkNode::eta(unsigned int chain) const
 {
     return *_parameters[chain][0];
@@ -53,6 +53,23 @@ bool ScalarLogicalNode::checkParentValues(unsigned int chain) const
     return _func->checkParameterValue(_parameters[chain]);
 }
 
+bool ScalarLogicalNode::accumulateGradient(double const *adj,
+					   vector<double *> const &parent_adj,
+					   unsigned int chain) const
+{
+    vector<double const *> const &par = _parameters[chain];
+    vector<double> grad(par.size());
+    if (!_func->gradient(&grad[0], par)) {
+	return false;
+    }
+    for (unsigned int j = 0; j < par.size(); ++j) {
+	if (parent_adj[j]) {
+	    parent_adj[j][0] += adj[0] * grad[j];
+	}
+    }
+    return true;
+}
+
     /*
 DeterministicNode *
 ScalarLogicalNode::clone(vector<Node const*> const &parents) const
@@ -86,6 +86,33 @@ bool ScalarStochasticNode::checkParentValues(unsigned int chain) const
     }
 }
 
+bool ScalarStochasticNode::accumulateGradient(double *gx,
+					      vector<double *> const &gpar,
+					      unsigned int chain) const
+{
+    vector<double const *> const &par = _parameters[chain];
+    if (!_dist->checkParameterValue(par)) {
+	return false;
+    }
+
+    double dx = 0;
+    vector<double> dpar(par.size());
+    if (!_dist->gradLogDensity(&dx, &dpar[0], _data[chain], par,
+			       lowerLimit(chain), upperLimit(chain)))
+    {
+	return false;
+    }
+    if (gx) {
+	gx[0] += dx;
+    }
+    for (unsigned int j = 0; j < par.size(); ++j) {
+	if (gpar[j]) {
+	    gpar[j][0] += dpar[j];
+	}
+    }
+    return true;
+}
+
 void ScalarStochasticNode::sp(double *lower, double *upper, unsigned long length,
 			      unsigned int chain) const
 {
@@ -214,6 +214,13 @@ double const *StochasticNode::upperLimit(unsigned int chain) const
     return _upper ? _upper->value(chain) : 0;
 }
 
+bool StochasticNode::accumulateGradient(double *gx,
+					vector<double *> const &gpar,
+					unsigned int chain) const
+{
+    return false;
+}
+
 
 bool isSupportFixed(StochasticNode const *node)
 {
@@ -80,6 +80,28 @@ bool VSLogicalNode::checkParentValues(unsigned int chain) const
     return true;
 }
 
+bool VSLogicalNode::accumulateGradient(double const *adj,
+				       vector<double *> const &parent_adj,
+				       unsigned int chain) const
+{
+    vector<double const *> par(_parameters[chain]);
+    vector<double> grad(par.size());
+
+    for (unsigned int i = 0; i < _length; ++i) {
+	if (!_func->gradient(&grad[0], par)) {
+	    return false;
+	}
+	for (unsigned int j = 0; j < par.size(); ++j) {
+	    if (parent_adj[j]) {
+		parent_adj[j][_isvector[j] ? i : 0] += adj[i] * grad[j];
+	    }
+	    if (_isvector[j])
+		++par[j];
+	}
+    }
+    return true;
+}
+
     /*
 DeterministicNode *
 VSLogicalNode::clone(vector<Node const*> const &parents) const
@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <functional>
 #include <map>
+#include <cmath>
 
 using std::map;
 using std::pair;
@@ -42,6 +43,7 @@ using std::min;
 using std::max;
 using std::reverse;
 using std::find;
+using std::exp;
 
 namespace jags {
 
@@ -86,7 +88,8 @@ static bool checkClosure(vector<Node*> const &nodes)
 
 Model::Model(unsigned int nchain)
     : _samplers(0), _nchain(nchain), _rng(nchain, 0), _iteration(0),
-      _is_initialized(false), _adapt(false), _data_gen(false)
+      _is_initialized(false), _adapt(false), _data_gen(false),
+      _nswap_tried(0)
 {
 }
 
@@ -377,6 +380,14 @@ void Model::update(unsigned int niter)
 		}
 		(*k)->randomSample(_rng[n], n);
 	    }
+
+	    if (!_temperature.empty()) {
+		_loglik[n] = temperedLogLikelihood(n);
+	    }
+	}
+
+	if (!_temperature.empty()) {
+	    swapChains();
 	}
 	
 	_iteration++;
@@ -390,6 +401,128 @@ void Model::update(unsigned int niter)
 
 }
 
+double Model::temperedLogLikelihood(unsigned int chain) const
+{
+    double llik = 0;
+    for (vector<StochasticNode*>::const_iterator p = _tempered_nodes.begin();
+	 p != _tempered_nodes.end(); ++p)
+    {
+	llik += (*p)->logDensity(chain, PDF_LIKELIHOOD);
+    }
+    return llik;
+}
+
+void Model::swapChains()
+{
+    /* 
+       Propose swaps between neighbouring chains, alternating between
+       even and odd pairs on successive rounds, starting with the even
+       pairs. Swaps are done in a fixed order, using the RNG of the
+       lower chain, so the results do not depend on the number of
+       threads.
+    */
+    for (unsigned int n = _nswap_tried % 2; n + 1 < _nchain; n += 2) {
+	double logp = (1/_temperature[n] - 1/_temperature[n+1]) *
+	    (_loglik[n+1] - _loglik[n]);
+	if (jags_isnan(logp)) {
+	    throw runtime_error("Failure to calculate swap probability");
+	}
+	if (logp >= 0 || _rng[n]->uniform() < exp(logp)) {
+	    for (vector<Node*>::const_iterator k = _swap_nodes.begin();
+		 k != _swap_nodes.end(); ++k)
+	    {
+		(*k)->swapValue(n, n+1);
+	    }
+	    double l = _loglik[n];
+	    _loglik[n] = _loglik[n+1];
+	    _loglik[n+1] = l;
+	    _nswap[n]++;
+	}
+    }
+    _nswap_tried++;
+}
+
+void Model::setTemperatures(vector<double> const &temp)
+{
+    if (!_is_initialized) {
+	throw logic_error("Attempt to set temperatures of uninitialized model");
+    }
+    if (!temp.empty()) {
+	if (temp.size() != _nchain) {
+	    throw runtime_error("Length of temperature vector must equal number of chains");
+	}
+	if (temp[0] != 1) {
+	    throw runtime_error("Temperature of first chain must be 1");
+	}
+	for (unsigned int n = 0; n < _nchain; ++n) {
+	    if (!jags_finite(temp[n]) || temp[n] < 1) {
+		throw runtime_error("Invalid temperature");
+	    }
+	}
+    }
+
+    for (unsigned int i = 0; i < _samplers.size(); ++i) {
+	if (!_samplers[i]->setTemperature(temp)) {
+	    string name = _samplers[i]->name();
+	    for (unsigned int j = 0; j < _samplers.size(); ++j) {
+		_samplers[j]->setTemperature(vector<double>());
+	    }
+	    _temperature.clear();
+	    throw runtime_error(string("Sampler ") + name +
+				" cannot be used with parallel tempering");
+	}
+    }
+
+    _temperature = temp;
+    _tempered_nodes.clear();
+    _swap_nodes.clear();
+    _loglik.assign(temp.size(), 0);
+    _nswap.assign(temp.size(), 0);
+    _nswap_tried = 0;
+    if (temp.empty()) return;
+
+    /* 
+       Observed nodes with fixed parents have the same density in all
+       chains, so they do not contribute to the swap probability
+    */
+    for (vector<StochasticNode*>::const_iterator p = 
+	     _stochastic_nodes.begin(); p != _stochastic_nodes.end(); ++p)
+    {
+	if (!isObserved(*p)) continue;
+	vector<Node const*> const &parents = (*p)->parents();
+	for (unsigned int j = 0; j < parents.size(); ++j) {
+	    if (!parents[j]->isFixed()) {
+		_tempered_nodes.push_back(*p);
+		break;
+	    }
+	}
+    }
+
+    for (vector<Node*>::const_iterator k = _nodes.begin(); 
+	 k != _nodes.end(); ++k)
+    {
+	if (!(*k)->isFixed()) {
+	    _swap_nodes.push_back(*k);
+	}
+    }
+}
+
+vector<double> const &Model::temperatures() const
+{
+    return _temperature;
+}
+
+vector<double> Model::swapAcceptance() const
+{
+    vector<double> ans;
+    for (unsigned int n = 0; n + 1 < _temperature.size(); ++n) {
+	/* Pair n is proposed in every other round of swaps */
+	unsigned int ntried = (_nswap_tried + (n % 2 ? 0 : 1)) / 2;
+	ans.push_back(ntried ? static_cast<double>(_nswap[n]) / ntried : 0);
+    }
+    return ans;
+}
+
 unsigned int Model::iteration() const
 {
   return _iteration;
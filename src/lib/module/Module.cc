@@ -188,9 +188,10 @@ void Module::insert(ArrayDist *dist, ArrayFunction *func)
     insert(func);
 }
 
-void Module::insert(SamplerFactory *fac)
+void Module::insert(SamplerFactory *fac, bool active)
 {
     _sampler_factories.push_back(fac);
+    _sampler_active.push_back(active);
 }
 
 void Module::insert(RNGFactory *fac)
@@ -217,7 +218,8 @@ void Module::load()
 	Model::rngFactories().push_front(p);
     }
     for (unsigned int i = 0; i < _sampler_factories.size(); ++i) {
-	pair<SamplerFactory*, bool> p(_sampler_factories[i], true);
+	pair<SamplerFactory*, bool> p(_sampler_factories[i],
+				      _sampler_active[i]);
 	Model::samplerFactories().push_front(p);
     }
     for (unsigned int i = 0; i < _dp_list.size(); ++i) {
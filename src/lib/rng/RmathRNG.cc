@@ -29,12 +29,141 @@ static inline double fmax2(double x, double y)
         return (x < y) ? y : x;
 }
 
+static const string ZIGGURAT_SUFFIX = "-Ziggurat";
+
+static string kindName(string const &name, NormKind N01_kind)
+{
+    return N01_kind == ZIGGURAT ? name + ZIGGURAT_SUFFIX : name;
+}
+
 RmathRNG::RmathRNG(string const &name, NormKind N01_kind)
-  : RNG(name), _N01_kind(N01_kind), _BM_norm_keep(0)
+  : RNG(kindName(name, N01_kind)), _N01_kind(N01_kind), _BM_norm_keep(0)
 {}
 
+NormKind RmathRNG::normKind(string const &name, string &basename)
+{
+    string::size_type n = ZIGGURAT_SUFFIX.size();
+    if (name.size() > n &&
+	name.compare(name.size() - n, n, ZIGGURAT_SUFFIX) == 0)
+    {
+	basename = name.substr(0, name.size() - n);
+	return ZIGGURAT;
+    }
+    basename = name;
+    return KINDERMAN_RAMAGE;
+}
+
+/*
+ *  REFERENCE
+ *
+ *    Marsaglia G and Tsang WW (2000) The Ziggurat method for
+ *    generating random variables. Journal of Statistical Software
+ *    5(8).
+ *
+ *    Doornik JA (2005) An improved Ziggurat method to generate
+ *    normal random samples. Working paper, University of Oxford.
+ *
+ *  The density is covered by NLAYER layers of equal area V. Layer i
+ *  spans heights f(x[i]) to f(x[i+1]) and has width x[i]; the base
+ *  layer has width x[0] = V/f(R) and includes the tail beyond
+ *  x[1] = R.  The tables are calculated on first use.
+ */
+
+#define ZIG_NORM_LAYER 128
+#define ZIG_NORM_R 3.442619855899
+#define ZIG_NORM_V 9.91256303526217e-3
+
+#define ZIG_EXP_LAYER 256
+#define ZIG_EXP_R 7.69711747013104972
+#define ZIG_EXP_V 3.949659822581572e-3
+
+namespace {
+
+    struct ZigTable {
+	double x[ZIG_EXP_LAYER + 1];
+	double f[ZIG_EXP_LAYER + 1];
+	ZigTable(unsigned int nlayer, double r, double v, bool normal)
+	{
+	    double fr = normal ? exp(-r*r/2) : exp(-r);
+	    x[0] = v / fr; f[0] = 0;
+	    x[1] = r; f[1] = fr;
+	    for (unsigned int i = 1; i < nlayer - 1; ++i) {
+		double y = v / x[i] + f[i];
+		x[i+1] = normal ? sqrt(-2 * log(y)) : -log(y);
+		f[i+1] = y;
+	    }
+	    x[nlayer] = 0; f[nlayer] = 1;
+	}
+    };
+
+    ZigTable const &normTable()
+    {
+	static const ZigTable table(ZIG_NORM_LAYER, ZIG_NORM_R, ZIG_NORM_V,
+				    true);
+	return table;
+    }
+
+    ZigTable const &expTable()
+    {
+	static const ZigTable table(ZIG_EXP_LAYER, ZIG_EXP_R, ZIG_EXP_V,
+				    false);
+	return table;
+    }
+
+}
+
+double RmathRNG::zigNormal()
+{
+    ZigTable const &zt = normTable();
+    repeat {
+	/* The layer and the signed abscissa are drawn separately, so
+	   that the abscissa keeps all the bits of its uniform */
+	int i = static_cast<int>(uniform() * ZIG_NORM_LAYER);
+	double z = (2 * uniform() - 1) * zt.x[i];
+	if (fabs(z) < zt.x[i+1]) {
+	    return z;
+	}
+	if (i == 0) {
+	    /* Tail beyond R (Marsaglia, 1964) */
+	    double a, b;
+	    do {
+		a = -log(uniform()) / ZIG_NORM_R;
+		b = -log(uniform());
+	    } while (b + b < a * a);
+	    return (z < 0) ? -(ZIG_NORM_R + a) : ZIG_NORM_R + a;
+	}
+	/* Wedge */
+	if (zt.f[i] + uniform() * (zt.f[i+1] - zt.f[i]) < exp(-z*z/2)) {
+	    return z;
+	}
+    }
+}
+
+double RmathRNG::zigExponential()
+{
+    ZigTable const &zt = expTable();
+    repeat {
+	int i = static_cast<int>(uniform() * ZIG_EXP_LAYER);
+	double z = uniform() * zt.x[i];
+	if (z < zt.x[i+1]) {
+	    return z;
+	}
+	if (i == 0) {
+	    /* Tail beyond R, by the memoryless property */
+	    return ZIG_EXP_R - log(uniform());
+	}
+	if (zt.f[i] + uniform() * (zt.f[i+1] - zt.f[i]) < exp(-z)) {
+	    return z;
+	}
+    }
+}
+
 double RmathRNG::exponential()
 {
+    if (_N01_kind == ZIGGURAT) {
+	return zigExponential();
+    }
+
     /* q[k-1] = sum(log(2)^k / k!)  k=1,..,n, */
     /* The highest n (here 8) is determined by q[n-1] = 1.0 */
     /* within standard precision */
@@ -299,6 +428,9 @@ double RmathRNG::normal()
 		return (u2<u3) ? tt : -tt;
 	}
 
+    case ZIGGURAT:
+	return zigNormal();
+
     }/*switch*/
 
     // Not reached, but an exit statement is required for -Wall
@@ -306,4 +438,18 @@ double RmathRNG::normal()
     return 0;
 }
 
+void RmathRNG::normal(double *x, unsigned long n)
+{
+    for (unsigned long i = 0; i < n; ++i) {
+	x[i] = RmathRNG::normal();
+    }
+}
+
+void RmathRNG::exponential(double *x, unsigned long n)
+{
+    for (unsigned long i = 0; i < n; ++i) {
+	x[i] = RmathRNG::exponential();
+    }
+}
+
 } //namespace jags
@@ -0,0 +1,67 @@
+#include <config.h>
+#include <rng/StreamRNG.h>
+
+using std::vector;
+
+#define i2_32m1 2.328306437080797e-10/* = 1/(2^32 - 1) */
+
+namespace jags {
+
+    StreamRNG::StreamRNG(unsigned int seed)
+	: RmathRNG("StreamRNG", KINDERMAN_RAMAGE)
+    {
+	init(seed);
+    }
+
+    void StreamRNG::init(unsigned int seed)
+    {
+	/* Initial scrambling */
+	for (unsigned int j = 0; j < 50; j++)
+	    seed = (69069 * seed + 1);
+
+	for (unsigned int j = 0; j < 4; j++) {
+	    seed = (69069 * seed + 1);
+	    I[j] = seed;
+	}
+	if (I[0] == 0) I[0] = 1; //State must not be all zero
+    }
+
+    bool StreamRNG::setState(vector<int> const &state)
+    {
+	if (state.size() != 4)
+	    return false;
+
+	for (unsigned int j = 0; j < 4; j++) {
+	    I[j] = static_cast<unsigned int>(state[j]);
+	}
+	return I[0] || I[1] || I[2] || I[3];
+    }
+
+    void StreamRNG::getState(vector<int> &state) const
+    {
+	state.clear();
+	for (unsigned int j = 0; j < 4; j++) {
+	    state.push_back(static_cast<int>(I[j]));
+	}
+    }
+
+    double StreamRNG::uniform()
+    {
+	unsigned int t = I[3];
+	t ^= t << 11;
+	t ^= t >> 8;
+	I[3] = I[2];
+	I[2] = I[1];
+	I[1] = I[0];
+	I[0] ^= (I[0] >> 19) ^ t;
+	return fixup(I[0] * i2_32m1);
+    }
+
+    void StreamRNG::uniform(double *x, unsigned long n)
+    {
+	for (unsigned long i = 0; i < n; ++i) {
+	    x[i] = StreamRNG::uniform();
+	}
+    }
+
+} /* namespace jags */
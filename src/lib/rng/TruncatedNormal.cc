@@ -1,6 +1,12 @@
 /* 
    Robert CP (1995) Simulation of truncated normal variables.
    Statistics and computing 5: 121-125.
+
+   Chopin N (2011) Fast simulation of truncated Gaussian distributions.
+   Statistics and Computing 21: 275-288.
+
+   Marsaglia G (1964) Generating a variable from the tail of the normal
+   distribution. Technometrics 6: 101-102.
 */
 #include <config.h>
 
@@ -10,16 +16,211 @@
 
 #include <cmath>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
 
 using std::sqrt;
 using std::exp;
+using std::erfc;
 using std::logic_error;
+using std::vector;
+using std::reverse;
+using std::min;
+using std::max;
+using std::fabs;
 
 //sqrt(2*pi)
 #define STP 2.506628274631
 
+//Range covered by the table of boxes (Chopin, 2011)
+#define BOX_XMAX 3.48672170399
+#define BOX_XMIN -2.00443204036
+//Minimum number of boxes spanned by an interval for the table to be used
+#define BOX_KMIN 5
+
+namespace {
+
+    inline double f(double x)
+    {
+	return exp(-x*x/2);
+    }
+
+    /*
+      Table of boxes for the method of Chopin (2011). The interval
+      [xmin, xmax] is divided into N boxes, each of which has the
+      same area, A, under an envelope that is constant on the box,
+      and equal to the maximum of the unnormalized density f on the
+      box. The tail of the distribution beyond xmax also has
+      probability mass A, so a box - or the tail - can be selected
+      with a single uniform draw.
+    */
+    struct Box {
+	double x;     //Left boundary
+	double ratio; //Ratio of minimum to maximum of f on the box
+	double scale; //Width divided by ratio
+	double fmax;  //Maximum of f on the box
+    };
+    
+    struct BoxTable {
+	unsigned int N;
+	vector<Box> boxes; //Boxes, with a sentinel giving xmax
+	double cellwidth, invcellwidth;
+	vector<unsigned int> cell; //Box containing each cell of a fine grid
+
+	BoxTable()
+	{
+	    double A = STP / 2 * erfc(BOX_XMAX / sqrt(2.0));
+
+	    /* 
+	       Boxes are calculated downwards from xmax. The width of
+	       each box solves width * max(f) = A, which needs a
+	       Newton iteration when the maximum is at the left edge.
+	    */
+	    vector<double> x(1, BOX_XMAX);
+	    while (x.back() > BOX_XMIN) {
+		double hi = x.back();
+		double w = A;
+		if (hi <= 0) {
+		    w = A / f(hi);
+		}
+		else if (hi - A <= 0) {
+		    w = A; //box contains zero, where f(0) = 1
+		}
+		else {
+		    for (unsigned int iter = 0; iter < 50; ++iter) {
+			double flo = f(hi - w);
+			double dw = (w * flo - A) / (flo * (1 + w * (hi - w)));
+			w -= dw;
+			if (fabs(dw) < 1.0E-15 * w) break;
+		    }
+		}
+		x.push_back(hi - w);
+	    }
+	    reverse(x.begin(), x.end());
+	    N = x.size() - 1;
+
+	    /* 
+	       The data for each box are stored together so that a
+	       draw usually touches only one cache line
+	    */
+	    boxes.resize(N + 1);
+	    double minwidth = BOX_XMAX - BOX_XMIN;
+	    for (unsigned int k = 0; k < N; ++k) {
+		double lo = x[k], hi = x[k+1];
+		double fu = (lo <= 0 && hi >= 0) ? 1 : max(f(lo), f(hi));
+		boxes[k].x = lo;
+		boxes[k].ratio = min(f(lo), f(hi)) / fu;
+		boxes[k].scale = (hi - lo) / boxes[k].ratio;
+		boxes[k].fmax = fu;
+		minwidth = min(minwidth, hi - lo);
+	    }
+	    boxes[N].x = x[N];
+	    boxes[N].ratio = boxes[N].scale = boxes[N].fmax = 0;
+
+	    //Grid that is finer than the smallest box, for fast look-up
+	    cellwidth = minwidth;
+	    invcellwidth = 1 / cellwidth;
+	    unsigned int ncell = 
+		static_cast<unsigned int>((BOX_XMAX - x[0]) / cellwidth) + 1;
+	    cell.resize(ncell);
+	    unsigned int k = 0;
+	    for (unsigned int j = 0; j < ncell; ++j) {
+		double z = x[0] + j * cellwidth;
+		while (k < N - 1 && x[k+1] <= z) ++k;
+		cell[j] = k;
+	    }
+	}
+
+	//Index of the box containing z, for xmin <= z < xmax
+	unsigned int box(double z) const
+	{
+	    unsigned int j = 
+		static_cast<unsigned int>((z - boxes[0].x) * invcellwidth);
+	    unsigned int k = cell[j];
+	    while (k < N - 1 && boxes[k+1].x <= z) ++k;
+	    return k;
+	}
+    };
+
+    BoxTable const &boxTable()
+    {
+	static const BoxTable table;
+	return table;
+    }
+
+}
+
 namespace jags {
 
+/*
+  Sample from the tail of a standard normal distribution beyond left > 0
+  using the method of Marsaglia (1964)
+*/
+static double tail(double left, RNG *rng)
+{
+    double c = left * left;
+    while (true) {
+	double z = sqrt(c + 2 * rng->exponential());
+	if (rng->uniform() * z <= left) {
+	    return z;
+	}
+    }
+}
+
+/*
+  Returns true if the table of boxes can be used to sample the
+  interval [left, right]. On exit kl and kr are the indices of the
+  boxes containing left and right, with kr == N if right is in the
+  tail beyond xmax.
+*/
+static bool useBoxes(double left, double right,
+		     unsigned int &kl, unsigned int &kr)
+{
+    if (left < BOX_XMIN || left >= BOX_XMAX) {
+	return false;
+    }
+    BoxTable const &bt = boxTable();
+    kl = bt.box(left);
+    kr = (right >= BOX_XMAX) ? bt.N : bt.box(right);
+    return kr - kl >= BOX_KMIN;
+}
+
+/*
+  Sampling by the method of Chopin (2011). A box between kl and kr is
+  chosen with equal probability, or the tail if kr == N. On the fast
+  path, the same uniform draw gives both the box and a point that lies
+  under the density, so no further draws are needed.
+*/
+static double boxSample(double left, double right,
+			unsigned int kl, unsigned int kr, RNG *rng)
+{
+    BoxTable const &bt = boxTable();
+    unsigned int nslot = kr - kl + 1;
+    while (true) {
+	double t = rng->uniform() * nslot;
+	unsigned int j = static_cast<unsigned int>(t);
+	double frac = t - j;
+	unsigned int k = kl + j;
+	double z;
+	Box const &b = bt.boxes[k];
+	if (k == bt.N) {
+	    z = tail(b.x, rng);
+	}
+	else if (frac < b.ratio) {
+	    //Point lies below the minimum of f on the box
+	    z = b.x + b.scale * frac;
+	}
+	else {
+	    //Point lies in the strip between the minimum and maximum
+	    z = b.x + b.scale * b.ratio * rng->uniform();
+	    if (b.fmax * frac > f(z)) continue;
+	}
+	if (z >= left && z <= right) {
+	    return z;
+	}
+    }
+}
+
 //Calculates optimal scale parameter for exponential envelope
 static double Alpha(double mu)
 {
@@ -31,7 +232,7 @@ static double lnorm(double left, RNG *rng)
     if (!jags_finite(left)) {
 	throw logic_error("Non-finite boundary in truncated normal");
     }
-    if (left < 0) {
+    if (left < BOX_XMIN) {
 	//Repeated sampling until truncation satisfied
 	while(true) {
 	    double y = rng->normal();
@@ -39,21 +240,12 @@ static double lnorm(double left, RNG *rng)
 		return y;
 	}
     }
+    else if (left < BOX_XMAX) {
+	BoxTable const &bt = boxTable();
+	return boxSample(left, JAGS_POSINF, bt.box(left), bt.N, rng);
+    }
     else {
-	//Rejection sampling with exponential envelope
-	double alpha = Alpha(left);
-	while (true) {
-	    double y = rng->exponential();
-	    double C = (1 - y)/alpha;
-	    if (rng->uniform() <= exp(-C*C/2))
-		return left + y/alpha;
-	    /*
-            //Original version, less stable for large mu
-	    double z = left + rng->exponential() / alpha;
-	    if (rng->uniform() <= exp(-(alpha - z)*(alpha - z)/2))
-		return z;
-	    */
-	}
+	return tail(left, rng);
     }
 }
 
@@ -139,7 +331,14 @@ static double inorm(double left, double right, RNG *rng)
 	throw logic_error("Invalid limits in inorm");
     }
 
-    if (left > 0) {
+    unsigned int kl, kr;
+    if (useBoxes(left, right, kl, kr)) {
+	return boxSample(left, right, kl, kr, rng);
+    }
+    else if (useBoxes(-right, -left, kl, kr)) {
+	return -boxSample(-right, -left, kl, kr, rng);
+    }
+    else if (left > 0) {
 	return inorm_right_tail(left, right, rng);
     }
     else if (right < 0) {
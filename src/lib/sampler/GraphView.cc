@@ -12,8 +12,10 @@
 #include <string>
 #include <cmath>
 #include <algorithm>
+#include <map>
 
 using std::vector;
+using std::map;
 using std::set;
 using std::list;
 using std::runtime_error;
@@ -191,6 +193,32 @@ void GraphView::classifyChildren(vector<StochasticNode *> const &nodes,
 
 }
 
+double GraphView::sumLikelihood(unsigned int chain) const
+{
+    double llik = 0.0;
+    if (_inv_temp.empty()) {
+	vector<StochasticNode *>::const_iterator q = _stoch_children.begin();
+	for (; q != _stoch_children.end(); ++q) {
+	    llik += (*q)->logDensity(chain, PDF_LIKELIHOOD);
+	}
+    }
+    else {
+	//Parallel tempering: only the observed children are tempered
+	double tllik = 0.0;
+	for (unsigned int i = 0; i < _stoch_children.size(); ++i) {
+	    double ld = _stoch_children[i]->logDensity(chain, PDF_LIKELIHOOD);
+	    if (_observed[i]) {
+		tllik += ld;
+	    }
+	    else {
+		llik += ld;
+	    }
+	}
+	llik += tllik * _inv_temp[chain];
+    }
+    return llik;
+}
+
 double GraphView::logFullConditional(unsigned int chain) const
 {
     PDFType pdf_prior = _multilevel ? PDF_FULL : PDF_PRIOR;
@@ -201,11 +229,7 @@ double GraphView::logFullConditional(unsigned int chain) const
 	lprior += (*p)->logDensity(chain, pdf_prior);
     }
   
-    double llike = 0.0;
-    vector<StochasticNode *>::const_iterator q = _stoch_children.begin();
-    for (; q != _stoch_children.end(); ++q) {
-	llike += (*q)->logDensity(chain, PDF_LIKELIHOOD);
-    }
+    double llike = sumLikelihood(chain);
 
     double lfc = lprior + llike;
     if(jags_isnan(lfc)) {
@@ -237,6 +261,7 @@ double GraphView::logFullConditional(unsigned int chain) const
 	}
 
 	//Check likelihood
+	vector<StochasticNode *>::const_iterator q;
 	for (q = _stoch_children.begin(); q != _stoch_children.end(); ++q) {
 	    if (jags_isnan((*q)->logDensity(chain, PDF_LIKELIHOOD))) {
 		throw NodeError(*q, "Failure to calculate log density");
@@ -258,6 +283,87 @@ double GraphView::logFullConditional(unsigned int chain) const
     return lfc;
 }
 
+/*
+  Finds the derivative arrays of the parents of a node. Parents that
+  are not in the map do not depend on the sampled nodes, and are
+  given a NULL pointer.
+*/
+static void parentAdjoint(Node const *node,
+			  map<Node const*, unsigned long> const &offset,
+			  vector<double> &adj, vector<double *> &parent_adj)
+{
+    vector<Node const *> const &parents = node->parents();
+    parent_adj.resize(parents.size());
+    for (unsigned int j = 0; j < parents.size(); ++j) {
+	map<Node const*, unsigned long>::const_iterator p = 
+	    offset.find(parents[j]);
+	parent_adj[j] = (p == offset.end()) ? 0 : &adj[p->second];
+    }
+}
+
+bool GraphView::gradLogFullConditional(double *grad, unsigned int chain) const
+{
+    //Each sampled node and deterministic child has an array of
+    //derivatives at the given offset in adj.
+    map<Node const*, unsigned long> offset;
+    unsigned long N = 0;
+    for (unsigned int i = 0; i < _nodes.size(); ++i) {
+	offset[_nodes[i]] = N;
+	N += _nodes[i]->length();
+    }
+    for (unsigned int i = 0; i < _determ_children.size(); ++i) {
+	offset[_determ_children[i]] = N;
+	N += _determ_children[i]->length();
+    }
+    vector<double> adj(N, 0);
+    vector<double *> parent_adj;
+
+    //Prior
+    for (unsigned int i = 0; i < _nodes.size(); ++i) {
+	parentAdjoint(_nodes[i], offset, adj, parent_adj);
+	if (!_nodes[i]->accumulateGradient(&adj[offset[_nodes[i]]],
+					   parent_adj, chain))
+	{
+	    return false;
+	}
+    }
+
+    //Likelihood. With parallel tempering, the derivatives for
+    //observed children are accumulated separately and then scaled.
+    vector<double> tadj;
+    if (!_inv_temp.empty()) {
+	tadj.assign(N, 0);
+    }
+    for (unsigned int i = 0; i < _stoch_children.size(); ++i) {
+	bool tempered = !_inv_temp.empty() && _observed[i];
+	parentAdjoint(_stoch_children[i], offset, tempered ? tadj : adj,
+		      parent_adj);
+	if (!_stoch_children[i]->accumulateGradient(0, parent_adj, chain)) {
+	    return false;
+	}
+    }
+    if (!_inv_temp.empty()) {
+	for (unsigned long k = 0; k < N; ++k) {
+	    adj[k] += tadj[k] * _inv_temp[chain];
+	}
+    }
+
+    //Reverse sweep over deterministic children, which are stored
+    //in topological order
+    for (unsigned int i = _determ_children.size(); i > 0; --i) {
+	DeterministicNode const *dnode = _determ_children[i-1];
+	parentAdjoint(dnode, offset, adj, parent_adj);
+	if (!dnode->accumulateGradient(&adj[offset[dnode]], parent_adj,
+				       chain))
+	{
+	    return false;
+	}
+    }
+
+    copy(adj.begin(), adj.begin() + _length, grad);
+    return true;
+}
+
 double GraphView::logPrior(unsigned int chain) const
 {
     //In a multi-level GraphView we need to calculate the full log
@@ -285,15 +391,11 @@ double GraphView::logPrior(unsigned int chain) const
 
 double GraphView::logLikelihood(unsigned int chain) const
 {
-    double llik = 0.0;
-
-    vector<StochasticNode *>::const_iterator q = _stoch_children.begin();
-    for (; q != _stoch_children.end(); ++q) {
-	llik += (*q)->logDensity(chain, PDF_LIKELIHOOD);
-    }
+    double llik = sumLikelihood(chain);
   
     if(jags_isnan(llik)) {
 	//Try to find where the calculation went wrong
+	vector<StochasticNode *>::const_iterator q;
 	for (q = _stoch_children.begin(); q != _stoch_children.end(); ++q) {
 	    if (jags_isnan((*q)->logDensity(chain, PDF_LIKELIHOOD))) {
 		throw NodeError(*q, "Failure to calculate log likelihood");
@@ -410,4 +512,26 @@ unsigned int nchain(GraphView const *gv)
 
     }
 
+    void GraphView::setTemperature(vector<double> const &temp)
+    {
+	_inv_temp.clear();
+	_observed.clear();
+	if (temp.empty()) return;
+
+	for (unsigned int i = 0; i < temp.size(); ++i) {
+	    _inv_temp.push_back(1/temp[i]);
+	}
+	for (unsigned int i = 0; i < _stoch_children.size(); ++i) {
+	    _observed.push_back(isObserved(_stoch_children[i]));
+	}
+    }
+
+    bool GraphView::hasObservedChildren() const
+    {
+	for (unsigned int i = 0; i < _stoch_children.size(); ++i) {
+	    if (isObserved(_stoch_children[i])) return true;
+	}
+	return false;
+    }
+
 } //namespace jags
@@ -7,4 +7,9 @@ namespace jags {
     {
     }
 
+    bool ImmutableSampleMethod::isTemperable() const
+    {
+	return false;
+    }
+
 } //namespace jags
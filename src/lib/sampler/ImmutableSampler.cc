@@ -41,6 +41,11 @@ namespace jags {
 	return true;
     }
 
+    bool ImmutableSampler::isTemperable() const
+    {
+	return _method->isTemperable();
+    }
+
     string ImmutableSampler::name() const
     {
 	return _name;
@@ -38,6 +38,11 @@ bool Metropolis::accept(RNG *rng, double prob)
     return accept;
 }
 
+void Metropolis::refreshValue()
+{
+    getValue(_last_value);
+}
+
 void Metropolis::adaptOff()
 {
     _adapt = false;
@@ -7,4 +7,9 @@ namespace jags {
     {
     }
 
+    bool MutableSampleMethod::isTemperable() const
+    {
+	return false;
+    }
+
 } //namespace jags
@@ -55,6 +55,15 @@ namespace jags {
 	return false;
     }
 
+    bool MutableSampler::isTemperable() const
+    {
+	for (unsigned int ch = 0; ch < _methods.size(); ++ch) {
+	    if (!_methods[ch]->isTemperable())
+		return false;
+	}
+	return true;
+    }
+
     string MutableSampler::name() const
     {
 	return _name;
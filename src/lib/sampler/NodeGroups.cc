@@ -0,0 +1,71 @@
+#include <config.h>
+#include <sampler/NodeGroups.h>
+
+using std::vector;
+using std::map;
+
+namespace jags {
+
+    NodeGroups::NodeGroups(vector<StochasticNode*> const &nodes)
+	: _nodes(nodes), _parent(nodes.size())
+    {
+	for (unsigned int i = 0; i < _nodes.size(); ++i) {
+	    _parent[i] = i;
+	    _index[_nodes[i]] = i;
+	}
+    }
+
+    unsigned int NodeGroups::findRoot(unsigned int i)
+    {
+	while (_parent[i] != i) {
+	    _parent[i] = _parent[_parent[i]];
+	    i = _parent[i];
+	}
+	return i;
+    }
+
+    unsigned int NodeGroups::index(StochasticNode const *node) const
+    {
+	map<StochasticNode const*, unsigned int>::const_iterator p =
+	    _index.find(node);
+	return p == _index.end() ? _nodes.size() : p->second;
+    }
+
+    void NodeGroups::join(unsigned int i, unsigned int j)
+    {
+	_parent[findRoot(i)] = findRoot(j);
+    }
+
+    void NodeGroups::joinChildren(unsigned int i,
+				  vector<StochasticNode*> const &children)
+    {
+	for (unsigned int k = 0; k < children.size(); ++k) {
+	    map<StochasticNode const*, unsigned int>::iterator q =
+		_owner.find(children[k]);
+	    if (q == _owner.end()) {
+		_owner[children[k]] = i;
+	    }
+	    else {
+		join(i, q->second);
+	    }
+	}
+    }
+
+    vector<vector<StochasticNode*> > NodeGroups::groups()
+    {
+	map<unsigned int, vector<StochasticNode*> > groups;
+	for (unsigned int i = 0; i < _nodes.size(); ++i) {
+	    groups[findRoot(i)].push_back(_nodes[i]);
+	}
+
+	vector<vector<StochasticNode*> > ans;
+	ans.reserve(groups.size());
+	for (map<unsigned int, vector<StochasticNode*> >::const_iterator p
+		 = groups.begin(); p != groups.end(); ++p)
+	{
+	    ans.push_back(p->second);
+	}
+	return ans;
+    }
+
+} /* namespace jags */
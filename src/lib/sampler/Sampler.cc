@@ -21,4 +21,18 @@ vector<StochasticNode*> const &Sampler::nodes() const
     return _gv->nodes();
 }
 
+bool Sampler::isTemperable() const
+{
+    return false;
+}
+
+bool Sampler::setTemperature(vector<double> const &temp)
+{
+    if (!temp.empty() && !isTemperable() && _gv->hasObservedChildren()) {
+	return false;
+    }
+    _gv->setTemperature(temp);
+    return true;
+}
+
 } //namespace jags
@@ -80,9 +80,11 @@ void TemperedMetropolis::temperedUpdate(RNG *rng,
 
 void TemperedMetropolis::update(RNG *rng)
 {
-    //Save the current state
+    //Save the current state, which may have been changed by a swap
+    //between chains under parallel tempering
     vector<double> last_value(length());
     getValue(last_value);
+    refreshValue();
 
     //Make copies of the current state and log density
     //These are modified in place by temperedUpdate
@@ -20,6 +20,7 @@
 //Samplers
 #include <samplers/SliceFactory.h>
 #include <samplers/FiniteFactory.h>
+#include <samplers/BlockFactory.h>
 //RNGs
 #include <rngs/BaseRNGFactory.h>
 //Monitors
@@ -61,6 +62,9 @@ namespace base {
 	insert(new Subtract);
 
 	insert(new SliceFactory);
+	//Block updating is opt-in: when switched on, it takes
+	//precedence over the slice samplers
+	insert(new BlockFactory, false);
 	insert(new FiniteFactory);
 	
 	insert(new BaseRNGFactory);
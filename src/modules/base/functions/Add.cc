@@ -19,6 +19,14 @@ namespace base {
 	}
 	return out;
     }
+
+    bool Add::gradient(double *grad, vector<double const *> const &args) const
+    {
+	for (unsigned int i = 0; i < args.size(); ++i) {
+	    grad[i] = 1;
+	}
+	return true;
+    }
     
     bool Add::isDiscreteValued(vector<bool> const &mask) const
     {
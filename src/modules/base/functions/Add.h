@@ -19,6 +19,8 @@ class Add : public Infix
 public:
     Add ();
     double evaluate(std::vector<double const *>const &args) const;
+    bool gradient(double *grad,
+		  std::vector<double const *> const &args) const;
     bool isDiscreteValued(std::vector<bool> const &flags) const;
     bool isAdditive(std::vector<bool> const &mask,
 		    std::vector<bool> const &fixmask) const;
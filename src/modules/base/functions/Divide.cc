@@ -15,6 +15,14 @@ namespace base {
 	return *args[0] / *args[1];
     }
 
+    bool Divide::gradient(double *grad, vector<double const *> const &args) const
+    {
+	double y = *args[1];
+	grad[0] = 1 / y;
+	grad[1] = - *args[0] / (y * y);
+	return true;
+    }
+
     bool Divide::checkParameterValue(vector<double const*> const &args) const
     {
 	return *args[1] != 0;
@@ -20,6 +20,8 @@ class Divide:public Infix
 public:
     Divide ();
     double evaluate(std::vector<double const *> const &args) const;
+    bool gradient(double *grad,
+		  std::vector<double const *> const &args) const;
     bool checkParameterValue (std::vector <double const *> const &args) const;
     bool isScale(std::vector<bool> const &mask,
                  std::vector<bool> const &fix) const;
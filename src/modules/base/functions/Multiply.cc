@@ -32,6 +32,18 @@ namespace base {
 	return val;
     }
 
+    bool Multiply::gradient(double *grad,
+			    vector<double const *> const &args) const
+    {
+	for (unsigned int i = 0; i < args.size(); ++i) {
+	    grad[i] = 1;
+	    for (unsigned int j = 0; j < args.size(); ++j) {
+		if (j != i) grad[i] *= *args[j];
+	    }
+	}
+	return true;
+    }
+
     bool Multiply::isDiscreteValued(vector<bool> const &mask) const
     {
 	return allTrue(mask);
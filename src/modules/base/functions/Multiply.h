@@ -18,6 +18,8 @@ namespace base {
     public:
 	Multiply ();
 	double evaluate(std::vector<double const *> const &args) const;
+	bool gradient(double *grad,
+		      std::vector<double const *> const &args) const;
 	bool isDiscreteValued(std::vector<bool> const &mask) const;
 	bool isScale(std::vector<bool> const &mask,
 		     std::vector<bool> const &fixmask) const;
@@ -19,6 +19,12 @@ double Neg::evaluate(vector<double const*> const &args) const
     return -args[0][0];
 }
 
+bool Neg::gradient(double *grad, vector<double const*> const &args) const
+{
+    grad[0] = -1;
+    return true;
+}
+
 bool Neg::isDiscreteValued(vector<bool> const &mask) const
 {
   return mask[0];
@@ -16,6 +16,8 @@ class Neg : public ScalarFunction
 public:
     Neg ();
     double evaluate(std::vector<double const *> const &args) const;
+    bool gradient(double *grad,
+		  std::vector<double const *> const &args) const;
     bool isDiscreteValued(std::vector<bool> const &mask) const;
     bool isScale(std::vector<bool> const &mask, 
 		 std::vector<bool> const &fix) const;
@@ -6,6 +6,7 @@
 
 using std::vector;
 using std::pow;
+using std::log;
 using std::string;
 
 namespace jags {
@@ -25,6 +26,17 @@ double Pow::evaluate(vector<double const *> const &args) const
     return pow (*args[0], *args[1]);
 }
 
+bool Pow::gradient(double *grad, vector<double const *> const &args) const
+{
+    double x = *args[0], y = *args[1];
+    grad[0] = (y == 0) ? 0 : y * pow(x, y - 1);
+    //The derivative with respect to the exponent is only defined for
+    //x > 0. Otherwise the exponent must be fixed (by
+    //checkParameterValue) and the derivative is never used.
+    grad[1] = (x > 0) ? pow(x, y) * log(x) : 0;
+    return true;
+}
+
 bool Pow::checkParameterValue(vector<double const *> const &args) const
 {
     if (*args[0] > 0) {
@@ -16,6 +16,8 @@ public:
     Pow ();
     std::string alias() const;
     double evaluate(std::vector<double const *> const &args) const;
+    bool gradient(double *grad,
+		  std::vector<double const *> const &args) const;
     bool checkParameterValue(std::vector<double const*> const &args) const;
     bool isPower(std::vector<bool> const &mask, 
 		 std::vector<bool> const &fix) const;
@@ -16,6 +16,14 @@ namespace base {
     {
 	return *args[0] - *args[1];
     }
+
+    bool Subtract::gradient(double *grad,
+			    vector<double const *> const &args) const
+    {
+	grad[0] = 1;
+	grad[1] = -1;
+	return true;
+    }
     
     bool Subtract::isDiscreteValued(vector<bool> const &mask) const
     {
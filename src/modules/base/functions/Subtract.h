@@ -20,6 +20,8 @@ class Subtract : public Infix
 public:
     Subtract ();
     double evaluate(std::vector<double const *> const &args) const;
+    bool gradient(double *grad,
+		  std::vector<double const *> const &args) const;
     bool isDiscreteValued(std::vector<bool> const &mask) const;
     bool isAdditive(std::vector<bool> const &mask, 
 		    std::vector<bool> const &fix) const;
@@ -395,3 +395,22 @@ void BaseFunTest::seq()
     }
 				     
 }
+
+void BaseFunTest::gradient()
+{
+    //Analytic derivatives must agree with finite differences
+    double x1[2] = {1.5, -0.7};
+    double x2[3] = {0.3, 2.0, -1.2};
+    checkGradient(_add, mkVec(x1));
+    checkGradient(_add, mkVec(x2));
+    checkGradient(_subtract, mkVec(x1));
+    checkGradient(_multiply, mkVec(x1));
+    checkGradient(_multiply, mkVec(x2));
+    checkGradient(_divide, mkVec(x1));
+    checkGradient(_neg, vector<double>(1, -2.3));
+
+    double p1[2] = {1.7, 2.5};
+    double p2[2] = {0.4, -1.5};
+    checkGradient(_pow, mkVec(p1));
+    checkGradient(_pow, mkVec(p2));
+}
@@ -23,6 +23,7 @@ class BaseFunTest : public CppUnit::TestFixture, public JAGSFixture
     CPPUNIT_TEST( power );
     CPPUNIT_TEST( scale );
     CPPUNIT_TEST( seq );
+    CPPUNIT_TEST( gradient );
     CPPUNIT_TEST_SUITE_END();
 	    
     jags::ScalarFunction *_add;
@@ -69,6 +70,7 @@ class BaseFunTest : public CppUnit::TestFixture, public JAGSFixture
     void power();
     void scale();
     void seq();
+    void gradient();
 };
 
 #endif  // BASE_FUN_TEST_H
@@ -73,15 +73,18 @@ namespace base {
     {
 	unsigned int seed = static_cast<unsigned int>(time(NULL));
 
+	string basename;
+	NormKind kind = RmathRNG::normKind(name, basename);
+
 	RNG *rng = 0;
-	if (name == "base::Wichmann-Hill")
-	    rng = new WichmannHillRNG(seed, DEFAULT_NORM_KIND);
-	else if (name == "base::Marsaglia-Multicarry")
-	    rng = new MarsagliaRNG(seed, DEFAULT_NORM_KIND);
-	else if (name == "base::Super-Duper")
-	    rng = new SuperDuperRNG(seed, DEFAULT_NORM_KIND);
-	else if (name == "base::Mersenne-Twister")
-	    rng = new MersenneTwisterRNG(seed, DEFAULT_NORM_KIND);
+	if (basename == "base::Wichmann-Hill")
+	    rng = new WichmannHillRNG(seed, kind);
+	else if (basename == "base::Marsaglia-Multicarry")
+	    rng = new MarsagliaRNG(seed, kind);
+	else if (basename == "base::Super-Duper")
+	    rng = new SuperDuperRNG(seed, kind);
+	else if (basename == "base::Mersenne-Twister")
+	    rng = new MersenneTwisterRNG(seed, kind);
 	else
 	    return 0;
 
@@ -59,4 +59,11 @@ namespace base {
 	return fixup(((I[0] << 16)^(I[1] & 0177777)) * i2_32m1); 
     }
 
+    void MarsagliaRNG::uniform(double *x, unsigned long n)
+    {
+	for (unsigned long i = 0; i < n; ++i) {
+	    x[i] = MarsagliaRNG::uniform();
+	}
+    }
+
 }}
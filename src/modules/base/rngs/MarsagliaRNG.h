@@ -16,6 +16,7 @@ namespace base {
 	bool setState(std::vector<int> const &state);
 	void getState(std::vector<int> &state) const;
 	double uniform();
+	void uniform(double *x, unsigned long n);
     };
 
 }}
@@ -115,6 +115,13 @@ namespace base {
 	return fixup( (double)y * 2.3283064365386963e-10 ); 
     }
 
+    void MersenneTwisterRNG::uniform(double *x, unsigned long n)
+    {
+	for (unsigned long i = 0; i < n; ++i) {
+	    x[i] = MersenneTwisterRNG::uniform();
+	}
+    }
+
     void MersenneTwisterRNG::init(unsigned int seed)
     {
 	/* Initial scrambling */
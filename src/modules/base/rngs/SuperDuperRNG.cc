@@ -34,6 +34,13 @@ namespace base {
 	return fixup((I1^I2) * i2_32m1); /* in [0,1) */
     }
 
+    void SuperDuperRNG::uniform(double *x, unsigned long n)
+    {
+	for (unsigned long i = 0; i < n; ++i) {
+	    x[i] = SuperDuperRNG::uniform();
+	}
+    }
+
 
     void SuperDuperRNG::init(unsigned int seed)
     {
@@ -30,6 +30,13 @@ namespace base {
 	return fixup(value - (int) value); /* in [0,1) */
     }
 
+    void WichmannHillRNG::uniform(double *x, unsigned long n)
+    {
+	for (unsigned long i = 0; i < n; ++i) {
+	    x[i] = WichmannHillRNG::uniform();
+	}
+    }
+
     void WichmannHillRNG::init(unsigned int seed)
     {
 	/* Initial scrambling */
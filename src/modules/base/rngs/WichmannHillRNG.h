@@ -13,6 +13,7 @@ namespace base {
     public:
 	WichmannHillRNG(unsigned int seed, NormKind norm_kind);
 	double uniform();
+	void uniform(double *x, unsigned long n);
 	void init(unsigned int seed);
 	bool setState(std::vector<int> const &state);
 	void getState(std::vector<int> &state) const;
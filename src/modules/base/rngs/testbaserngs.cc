@@ -0,0 +1,242 @@
+#include "testbaserngs.h"
+
+#include "MarsagliaRNG.h"
+#include "MersenneTwisterRNG.h"
+#include "SuperDuperRNG.h"
+#include "WichmannHillRNG.h"
+#include "BaseRNGFactory.h"
+
+#include <rng/TruncatedNormal.h>
+#include <util/nainf.h>
+
+#include <cmath>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+using std::vector;
+using std::string;
+using std::sort;
+using std::max;
+using std::fabs;
+using std::sqrt;
+using std::exp;
+using std::log;
+using std::erfc;
+
+using jags::RNG;
+using jags::NormKind;
+using jags::base::MarsagliaRNG;
+using jags::base::MersenneTwisterRNG;
+using jags::base::SuperDuperRNG;
+using jags::base::WichmannHillRNG;
+using jags::base::BaseRNGFactory;
+
+static RNG *makeRNG(unsigned int k, unsigned int seed, NormKind kind)
+{
+    switch(k) {
+    case 0:
+	return new WichmannHillRNG(seed, kind);
+    case 1:
+	return new MarsagliaRNG(seed, kind);
+    case 2:
+	return new SuperDuperRNG(seed, kind);
+    default:
+	return new MersenneTwisterRNG(seed, kind);
+    }
+}
+
+void BaseRNGTest::bulk()
+{
+    //Bulk draws must give the same values as successive single
+    //draws, for all generators and normal algorithms
+
+    unsigned int const N = 1000;
+    NormKind kinds[4] = {jags::AHRENS_DIETER, jags::BOX_MULLER,
+			 jags::KINDERMAN_RAMAGE, jags::ZIGGURAT};
+    vector<double> x(N);
+
+    for (unsigned int k = 0; k < 4; ++k) {
+	for (unsigned int j = 0; j < 4; ++j) {
+	    RNG *rng1 = makeRNG(k, 314159, kinds[j]);
+	    RNG *rng2 = makeRNG(k, 314159, kinds[j]);
+
+	    rng1->uniform(&x[0], N);
+	    for (unsigned int i = 0; i < N; ++i) {
+		CPPUNIT_ASSERT_EQUAL(rng2->uniform(), x[i]);
+	    }
+	    rng1->normal(&x[0], N);
+	    for (unsigned int i = 0; i < N; ++i) {
+		CPPUNIT_ASSERT_EQUAL(rng2->normal(), x[i]);
+	    }
+	    rng1->exponential(&x[0], N);
+	    for (unsigned int i = 0; i < N; ++i) {
+		CPPUNIT_ASSERT_EQUAL(rng2->exponential(), x[i]);
+	    }
+
+	    //Streams remain in step after bulk draws
+	    CPPUNIT_ASSERT_EQUAL(rng2->uniform(), rng1->uniform());
+
+	    delete rng1;
+	    delete rng2;
+	}
+    }
+}
+
+static double pnorm(double x)
+{
+    return erfc(-x / sqrt(2.0)) / 2;
+}
+
+static double pexp(double x)
+{
+    return 1 - exp(-x);
+}
+
+static bool dkwtest(vector<double> x, double (*p)(double),
+		    double pthresh = 0.001)
+{
+    /*
+      Test using the Dvoretzky-Kiefer-Wolfowitz (1956) bound on the
+      difference between the empirical distribution function and the
+      theoretical one, with a tight constant derived by Massart (1990)
+    */
+
+    double N = x.size();
+    sort(x.begin(), x.end());
+    double delta = 0;
+    for (unsigned int i = 0; i < x.size(); ++i) {
+	double f = p(x[i]);
+	delta = max(delta, max(fabs((i + 1)/N - f), fabs(i/N - f)));
+    }
+    return delta < sqrt(log(pthresh/2)/(-2*N));
+}
+
+void BaseRNGTest::ziggurat()
+{
+    unsigned int const N = 10000;
+    vector<double> x(N);
+
+    for (unsigned int k = 0; k < 4; ++k) {
+	RNG *rng = makeRNG(k, 271828, jags::ZIGGURAT);
+	string msg = rng->name();
+
+	rng->normal(&x[0], N);
+	double sum = 0, sumsq = 0;
+	for (unsigned int i = 0; i < N; ++i) {
+	    sum += x[i];
+	    sumsq += x[i] * x[i];
+	}
+	//Mean and variance within 5 standard errors
+	CPPUNIT_ASSERT_MESSAGE(msg, fabs(sum/N) < 5/sqrt(N));
+	CPPUNIT_ASSERT_MESSAGE(msg, fabs(sumsq/N - 1) < 5*sqrt(2.0/N));
+	CPPUNIT_ASSERT_MESSAGE(msg, dkwtest(x, pnorm));
+
+	rng->exponential(&x[0], N);
+	sum = 0;
+	for (unsigned int i = 0; i < N; ++i) {
+	    CPPUNIT_ASSERT_MESSAGE(msg, x[i] >= 0);
+	    sum += x[i];
+	}
+	CPPUNIT_ASSERT_MESSAGE(msg, fabs(sum/N - 1) < 5/sqrt(N));
+	CPPUNIT_ASSERT_MESSAGE(msg, dkwtest(x, pexp));
+
+	delete rng;
+    }
+
+    //Tails: the base layer of the normal ziggurat ends at 3.44
+    RNG *rng = makeRNG(3, 161803, jags::ZIGGURAT);
+    unsigned int const M = 1000000;
+    unsigned int ntail = 0;
+    for (unsigned int i = 0; i < M; ++i) {
+	if (fabs(rng->normal()) > 3.5) ++ntail;
+    }
+    double ptail = 2 * pnorm(-3.5);
+    CPPUNIT_ASSERT(fabs(ntail - M * ptail) < 5 * sqrt(M * ptail));
+    delete rng;
+
+    //The kind is part of the name, and is restored by the factory
+    BaseRNGFactory factory;
+    RNG *zrng = factory.makeRNG("base::Mersenne-Twister-Ziggurat");
+    CPPUNIT_ASSERT(zrng != 0);
+    CPPUNIT_ASSERT_EQUAL(string("base::Mersenne-Twister-Ziggurat"),
+			 zrng->name());
+    RNG *krng = factory.makeRNG("base::Mersenne-Twister");
+    CPPUNIT_ASSERT_EQUAL(string("base::Mersenne-Twister"), krng->name());
+    vector<int> state;
+    krng->getState(state);
+    zrng->setState(state);
+    CPPUNIT_ASSERT(zrng->normal() != krng->normal());
+    CPPUNIT_ASSERT(factory.makeRNG("base::Ziggurat") == 0);
+    //zrng and krng belong to the factory, which deletes them
+}
+
+/* 
+   Distribution function of a standard normal truncated to the
+   interval [left, right]. Upper tail probabilities are used on the
+   positive side, so that the far tails are accurate.
+*/
+static double tn_left, tn_right;
+
+static double ptrunc(double x)
+{
+    if (tn_left > 0) {
+	double ql = erfc(tn_left / sqrt(2.0));
+	double qr = jags_finite(tn_right) ? erfc(tn_right / sqrt(2.0)) : 0;
+	return (ql - erfc(x / sqrt(2.0))) / (ql - qr);
+    }
+    else {
+	double pl = jags_finite(tn_left) ? pnorm(tn_left) : 0;
+	double pr = jags_finite(tn_right) ? pnorm(tn_right) : 1;
+	return (pnorm(x) - pl) / (pr - pl);
+    }
+}
+
+void BaseRNGTest::truncnorm()
+{
+    /* 
+       Truncation points chosen to exercise each sampling method:
+       repeated sampling, the table of boxes, the tail beyond the
+       table, and uniform rejection for short intervals
+    */
+    double const left[] = {-5, -2.1, -1, -0.3, 0, 0.4, 1.7, 3.4, 3.5, 7};
+    double const width[] = {1e-3, 0.1, 1, 4, JAGS_POSINF};
+    unsigned int const N = 10000;
+    vector<double> x(N);
+
+    RNG *rng = new MersenneTwisterRNG(8675309, jags::KINDERMAN_RAMAGE);
+    for (unsigned int i = 0; i < 10; ++i) {
+	for (unsigned int j = 0; j < 5; ++j) {
+	    tn_left = left[i];
+	    tn_right = left[i] + width[j];
+	    for (unsigned int k = 0; k < N; ++k) {
+		if (jags_finite(tn_right)) {
+		    x[k] = jags::inormal(tn_left, tn_right, rng);
+		}
+		else {
+		    x[k] = jags::lnormal(tn_left, rng);
+		}
+		CPPUNIT_ASSERT(x[k] >= tn_left && x[k] <= tn_right);
+	    }
+	    CPPUNIT_ASSERT_MESSAGE("lnormal/inormal", dkwtest(x, ptrunc));
+
+	    //Right truncation by symmetry
+	    for (unsigned int k = 0; k < N; ++k) {
+		x[k] = -jags::rnormal(-tn_left, rng);
+	    }
+	    tn_right = JAGS_POSINF;
+	    CPPUNIT_ASSERT_MESSAGE("rnormal", dkwtest(x, ptrunc));
+	}
+    }
+
+    //Location and scale
+    double mu = 2, sigma = 3;
+    tn_left = -0.5;
+    tn_right = 1.5;
+    for (unsigned int k = 0; k < N; ++k) {
+	x[k] = (jags::inormal(mu + sigma * tn_left, mu + sigma * tn_right,
+			      rng, mu, sigma) - mu) / sigma;
+    }
+    CPPUNIT_ASSERT(dkwtest(x, ptrunc));
+    delete rng;
+}
@@ -0,0 +1,21 @@
+#ifndef BASE_RNG_TEST_H
+#define BASE_RNG_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+class BaseRNGTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( BaseRNGTest );
+    CPPUNIT_TEST( bulk );
+    CPPUNIT_TEST( ziggurat );
+    CPPUNIT_TEST( truncnorm );
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void bulk();
+    void ziggurat();
+    void truncnorm();
+};
+
+#endif  // BASE_RNG_TEST_H
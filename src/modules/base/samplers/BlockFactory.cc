@@ -0,0 +1,90 @@
+#include <config.h>
+
+#include "BlockFactory.h"
+#include "BlockMetropolis.h"
+
+#include <sampler/MutableSampler.h>
+#include <sampler/GraphView.h>
+#include <sampler/SingletonGraphView.h>
+#include <sampler/NodeGroups.h>
+#include <graph/StochasticNode.h>
+#include <util/nainf.h>
+
+/* Maximum number of nodes in a block */
+#define BLOCK_MAX 50
+
+using std::vector;
+using std::list;
+using std::string;
+
+namespace jags {
+namespace base {
+
+    static bool canSample(StochasticNode const *snode)
+    {
+	if (snode->length() != 1 || snode->isDiscreteValued() ||
+	    snode->df() == 0)
+	{
+	    return false;
+	}
+	// A random walk mixes badly near the boundary of the support
+	if (isBounded(snode) || !isSupportFixed(snode)) {
+	    return false;
+	}
+	double lower = 0, upper = 0;
+	snode->support(&lower, &upper, 1, 0);
+	return !jags_finite(lower) && !jags_finite(upper);
+    }
+
+    vector<Sampler*> 
+    BlockFactory::makeSamplers(list<StochasticNode*> const &nodes, 
+			       Graph const &graph) const
+    {
+	vector<StochasticNode*> candidates;
+	for (list<StochasticNode*>::const_iterator p = nodes.begin();
+	     p != nodes.end(); ++p)
+	{
+	    if (canSample(*p)) {
+		candidates.push_back(*p);
+	    }
+	}
+
+	// Join candidates with common stochastic children into groups
+	NodeGroups groups(candidates);
+	for (unsigned int i = 0; i < candidates.size(); ++i) {
+	    SingletonGraphView view(candidates[i], graph);
+	    groups.joinChildren(i, view.stochasticChildren());
+	}
+	vector<vector<StochasticNode*> > glist = groups.groups();
+
+	vector<Sampler*> samplers;
+	for (unsigned int g = 0; g < glist.size(); ++g) {
+	    vector<StochasticNode*> const &group = glist[g];
+	    // Large groups are divided into blocks of consecutive nodes
+	    unsigned int nblock = (group.size() + BLOCK_MAX - 1) / BLOCK_MAX;
+	    for (unsigned int b = 0; b < nblock; ++b) {
+		vector<StochasticNode*> block(group.begin() + 
+					      (group.size() * b) / nblock,
+					      group.begin() + 
+					      (group.size() * (b+1)) / nblock);
+		if (block.size() < 2) continue;
+
+		GraphView *gv = new GraphView(block, graph, true);
+		unsigned int nchain = block[0]->nchain();
+		vector<MutableSampleMethod*> methods(nchain, 0);
+		for (unsigned int ch = 0; ch < nchain; ++ch) {
+		    methods[ch] = new BlockMetropolis(gv, ch);
+		}
+		samplers.push_back(new MutableSampler(gv, methods,
+						      "base::BlockRW"));
+	    }
+	}
+	return samplers;
+    }
+
+    string BlockFactory::name() const
+    {
+	return "base::BlockRW";
+    }
+
+}}
@@ -0,0 +1,28 @@
+#ifndef BLOCK_FACTORY_H_
+#define BLOCK_FACTORY_H_
+
+#include <sampler/SamplerFactory.h>
+
+namespace jags {
+namespace base {
+
+    /**
+     * @short Factory object for block random walk Metropolis samplers
+     *
+     * Real-valued scalar nodes with unbounded support that share
+     * stochastic children are grouped into blocks, which are sampled
+     * jointly by a BlockMetropolis sampler. Nodes that do not share
+     * any stochastic children with another candidate are left for
+     * other factories.
+     */
+    class BlockFactory : public SamplerFactory {
+    public:
+	std::vector<Sampler*> 
+	    makeSamplers(std::list<StochasticNode*> const &nodes, 
+			 Graph const &graph) const;
+	std::string name() const;
+    };
+
+}}
+
+#endif /* BLOCK_FACTORY_H_ */
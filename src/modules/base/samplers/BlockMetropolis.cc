@@ -0,0 +1,207 @@
+#include <config.h>
+
+#include "BlockMetropolis.h"
+
+#include <sampler/GraphView.h>
+#include <rng/RNG.h>
+
+#include <cmath>
+#include <algorithm>
+
+#define N_REFRESH 100
+
+using std::vector;
+using std::exp;
+using std::log;
+using std::sqrt;
+using std::min;
+
+/* 
+   Cholesky decomposition of the symmetric N x N matrix A, stored in
+   column-major order. The lower triangle of L is overwritten and the
+   upper triangle is set to zero. Returns false if A is not positive
+   definite, in which case L is undefined.
+   
+   Blocks are small, so we do not need LAPACK, which the base module
+   does not link against.
+*/
+static bool cholesky(double *L, double const *A, unsigned int N)
+{
+    for (unsigned int j = 0; j < N; ++j) {
+	double d = A[j + N * j];
+	for (unsigned int k = 0; k < j; ++k) {
+	    d -= L[j + N * k] * L[j + N * k];
+	}
+	if (!(d > 0)) {
+	    return false;
+	}
+	d = sqrt(d);
+	L[j + N * j] = d;
+	for (unsigned int i = 0; i < j; ++i) {
+	    L[i + N * j] = 0;
+	}
+	for (unsigned int i = j + 1; i < N; ++i) {
+	    double s = A[i + N * j];
+	    for (unsigned int k = 0; k < j; ++k) {
+		s -= L[i + N * k] * L[j + N * k];
+	    }
+	    L[i + N * j] = s / d;
+	}
+    }
+    return true;
+}
+
+static vector<double> initValue(jags::GraphView const *gv, unsigned int chain)
+{
+    vector<double> ivalue(gv->length());
+    gv->getValue(ivalue, chain);
+    return ivalue;
+}
+
+namespace jags {
+    namespace base {
+
+	BlockMetropolis::BlockMetropolis(GraphView const *gv,
+					 unsigned int chain)
+	    : Metropolis(initValue(gv, chain)), _gv(gv), _chain(chain),
+	      _mean(gv->length(), 0), _var(gv->length() * gv->length(), 0),
+	      _chol(gv->length() * gv->length(), 0),
+	      _n(0), _n_isotonic(0), _sump(0), _meanp(0),
+	      _lstep(log(2.38 / sqrt(static_cast<double>(gv->length())))),
+	      _nstep(10), _p_over_target(true)
+	{
+	    gv->checkFinite(chain); //Check validity of initial values
+
+	    // Give initial identity variance matrix
+	    unsigned int N = gv->length();
+	    for (unsigned int i = 0; i < N; ++i) {
+		_var[i + N * i] = _chol[i + N * i] = 1;
+	    }
+	}
+
+	void BlockMetropolis::update(RNG *rng)
+	{
+	    //The value may have been changed by a swap between chains
+	    //under parallel tempering since the last call to accept
+	    refreshValue();
+
+	    double logdensity = -_gv->logFullConditional(_chain);
+	    double step = exp(_lstep);
+
+	    unsigned int N = _gv->length();
+	    vector<double> eps(N);
+	    for (unsigned int i = 0; i < N; ++i) {
+		eps[i] = rng->normal();
+	    }
+	    vector<double> x(N);
+	    _gv->getValue(x, _chain);
+	    for (unsigned int j = 0; j < N; ++j) {
+		// _chol is lower triangular
+		for (unsigned int i = j; i < N; ++i) {
+		    x[i] += _chol[i + N * j] * eps[j] * step;
+		}
+	    }
+
+	    setValue(x);
+	    logdensity += _gv->logFullConditional(_chain);
+	    accept(rng, exp(logdensity));
+	}
+
+	void BlockMetropolis::rescale(double p)
+	{
+	    ++_n;
+	    p = min(p, 1.0);
+	    _sump += p;
+
+	    if (_n % N_REFRESH == 0) {
+		//Calculate the running mean acceptance rate 
+		_meanp = _sump / N_REFRESH;
+		_sump = 0;
+	    }
+
+	    if (_n_isotonic == 0) {
+		//Adjust scale of isotropic proposal distribution
+		_lstep += (p - 0.234) / _nstep;
+		if ((p > 0.234) != _p_over_target) {
+		    _p_over_target = !_p_over_target;
+		    ++_nstep;
+		}
+		if (_n % N_REFRESH == 0 && _meanp >= 0.15 && _meanp <= 0.35) {
+		    _n_isotonic = _n;
+		    _nstep = 100;
+		}
+		return;
+	    }
+
+	    _lstep += (p - 0.234) / sqrt(static_cast<double>(_nstep));
+	    _nstep++;
+
+	    /*
+	      Running estimates of the mean and variance of the values
+	      sampled since the end of the isotropic phase, using the
+	      standard recursive formulae. Both estimates give weight
+	      1/k to the k-th value.
+	    */
+	    unsigned int N = _gv->length();
+	    unsigned int k = _n - _n_isotonic;
+	    vector<double> x(N);
+	    _gv->getValue(x, _chain);
+	    vector<double> delta(N);
+	    for (unsigned int i = 0; i < N; ++i) {
+		delta[i] = x[i] - _mean[i];
+		_mean[i] += delta[i] / k;
+	    }
+	    for (unsigned int j = 0; j < N; ++j) {
+		for (unsigned int i = 0; i < N; ++i) {
+		    _var[i + N * j] += (delta[i] * (x[j] - _mean[j]) -
+					_var[i + N * j]) / k;
+		}
+	    }
+
+	    /*
+	      Refreshing the Cholesky factor is the most expensive
+	      step, so it is done only periodically. A small ridge
+	      keeps the proposal non-degenerate. If the estimate is
+	      not positive definite, the previous factor is kept.
+	    */
+	    if ((_n - _n_isotonic) % N_REFRESH == 0) {
+		double ridge = 0;
+		for (unsigned int i = 0; i < N; ++i) {
+		    ridge += _var[i + N * i];
+		}
+		ridge *= 1.0E-6 / N;
+		vector<double> A(_var);
+		for (unsigned int i = 0; i < N; ++i) {
+		    A[i + N * i] += ridge;
+		}
+		vector<double> L(N * N);
+		if (cholesky(&L[0], &A[0], N)) {
+		    _chol = L;
+		}
+	    }
+	}
+
+	bool BlockMetropolis::checkAdaptation() const
+	{
+	    //The proposal variance must have been estimated at least once
+	    return (_n_isotonic > 0) && (_n - _n_isotonic >= N_REFRESH) &&
+		(_meanp >= 0.15) && (_meanp <= 0.35);
+	}
+
+	void BlockMetropolis::getValue(vector<double> &value) const
+	{
+	    _gv->getValue(value, _chain);
+	}
+
+	void BlockMetropolis::setValue(vector<double> const &value)
+	{
+	    _gv->setValue(value, _chain);
+	}
+
+	bool BlockMetropolis::isTemperable() const
+	{
+	    return true;
+	}
+
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef BLOCK_METROPOLIS_H_
+#define BLOCK_METROPOLIS_H_
+
+#include <sampler/Metropolis.h>
+
+namespace jags {
+
+    class GraphView;
+
+    namespace base {
+
+	/**
+	 * @short Adaptive block random walk Metropolis sampler
+	 *
+	 * Updates a block of correlated real-valued nodes jointly with
+	 * a multivariate normal random walk. The proposal starts as an
+	 * isotropic random walk. Once the acceptance rate is close to
+	 * the optimum, the variance of the proposal is adapted to the
+	 * empirical variance of the sampled values (Haario, Saksman
+	 * and Tamminen, 2001). The scale of the proposal is tuned by a
+	 * noisy gradient algorithm throughout the adaptive phase.
+	 */
+	class BlockMetropolis : public Metropolis
+	{
+	    GraphView const *_gv;
+	    unsigned int _chain;
+	    std::vector<double> _mean;
+	    std::vector<double> _var;
+	    std::vector<double> _chol;
+	    unsigned int _n;
+	    unsigned int _n_isotonic;
+	    double _sump, _meanp;
+	    double _lstep;
+	    unsigned int _nstep;
+	    bool _p_over_target;
+	  public:
+	    BlockMetropolis(GraphView const *gv, unsigned int chain);
+	    void rescale(double p);
+	    void update(RNG *rng);
+	    bool checkAdaptation() const;
+	    void getValue(std::vector<double> &value) const;
+	    void setValue(std::vector<double> const &value);
+	    bool isTemperable() const;
+	};
+
+    }
+}
+
+#endif /* BLOCK_METROPOLIS_H_ */
@@ -79,4 +79,9 @@ namespace base {
 	return _gv->logFullConditional(_chain);
     }
 
+    bool DiscreteSlicer::isTemperable() const
+    {
+	return true;
+    }
+
 }}
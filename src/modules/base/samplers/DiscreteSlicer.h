@@ -39,6 +39,7 @@ namespace base {
 	void update(RNG*);
 	static bool canSample(StochasticNode const *node);
 	double logDensity() const;
+	bool isTemperable() const;
     };
 
 }}
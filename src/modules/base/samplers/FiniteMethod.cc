@@ -44,7 +44,8 @@ namespace jags {
 namespace base {
 
     FiniteMethod::FiniteMethod(SingletonGraphView const *gv)
-	: _gv(gv), _lower(mkLower(gv)), _upper(mkUpper(gv)), _size(mkSize(gv))
+	: _gv(gv), _lower(mkLower(gv)), _upper(mkUpper(gv)), _size(mkSize(gv)),
+	  _lik(nchain(gv), vector<double>(_size))
     {
 	if (!canSample(gv->node())) {
 	    throwLogicError("Invalid FiniteMethod");
@@ -53,14 +54,32 @@ namespace base {
     
     void FiniteMethod::update(unsigned int chain, RNG *rng) const
     {
-	vector<double> lik(_size);
-
-	//Calculate log-likelihood
+	/* 
+	   Each chain has its own working space, so that chains may be
+	   updated in parallel
+	*/
+	vector<double> &lik = _lik[chain];
+	StochasticNode *snode = _gv->node();
+
+	/*
+	  Calculate log full conditional density. The prior density
+	  is calculated first, as it depends only on the value of the
+	  sampled node, and the deterministic children are
+	  recalculated only if it is non-zero. The maximum is tracked
+	  at the same time, so that the density can be normalized by
+	  the log-sum-exp trick.
+	*/
 	double lik_max = JAGS_NEGINF;
 	for (unsigned long i = 0; i < _size; i++) {
 	    double ivalue = _lower + i;
+	    snode->setValue(&ivalue, 1, chain);
+	    double lprior = snode->logDensity(chain, PDF_PRIOR);
+	    if (lprior == JAGS_NEGINF) {
+		lik[i] = JAGS_NEGINF;
+		continue;
+	    }
 	    _gv->setValue(&ivalue, 1, chain);
-	    lik[i] = _gv->logFullConditional(chain);
+	    lik[i] = lprior + _gv->logLikelihood(chain);
 	    if (lik[i] > lik_max) lik_max = lik[i];
 	}
 	
@@ -83,6 +102,11 @@ namespace base {
 	_gv->setValue(&ivalue, 1, chain);
     }
 
+    bool FiniteMethod::isTemperable() const
+    {
+	return true;
+    }
+
     bool FiniteMethod::canSample(StochasticNode const * node)
     {
 	//Node must be scalar with discrete-valued distribution of full rank
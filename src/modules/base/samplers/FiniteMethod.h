@@ -3,20 +3,36 @@
 
 #include <sampler/ImmutableSampleMethod.h>
 
+#include <vector>
+
 namespace jags {
+
+    class SingletonGraphView;
+
     namespace base {
 
 	/**
 	 * Sampler for discrete distributions with support on a finite set.
+	 *
+	 * The full conditional density is evaluated at every point in
+	 * the support, in a single pass over the candidate values.
+	 * Candidates with zero prior density, e.g. outside the bounds
+	 * of a truncated node, are rejected before the deterministic
+	 * children are recalculated. Working space for the density is
+	 * allocated once for each chain.
 	 */
 	class FiniteMethod : public ImmutableSampleMethod {
 	    SingletonGraphView const * const _gv;
 	    const double _lower, _upper;
-	    unsigned long _size;
+	    // _size must be declared before _lik, which is initialized
+	    // from it
+	    const unsigned long _size;
+	    mutable std::vector<std::vector<double> > _lik;
 	  public:
 	    FiniteMethod(SingletonGraphView const *gv);
 	    void update(unsigned int chain, RNG *rng) const;
 	    static bool canSample(StochasticNode const *snode);
+	    bool isTemperable() const;
 	};
 	
     }
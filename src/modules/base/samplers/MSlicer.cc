@@ -227,6 +227,11 @@ namespace jags {
 	    return _gv->logFullConditional(_chain);
 	}
 
+	bool MSlicer::isTemperable() const
+	{
+	    return true;
+	}
+
 	bool MSlicer::isAdaptive() const
 	{
 	    return true;
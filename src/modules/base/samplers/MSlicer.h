@@ -43,6 +43,7 @@ namespace jags {
 	    bool isAdaptive() const;
 	    void adaptOff();
 	    bool checkAdaptation() const;
+	    bool isTemperable() const;
 	};
 
     }
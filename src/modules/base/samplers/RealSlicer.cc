@@ -75,4 +75,9 @@ namespace base {
 	return _gv->logFullConditional(_chain);
     }
 
+    bool RealSlicer::isTemperable() const
+    {
+	return true;
+    }
+
 }}
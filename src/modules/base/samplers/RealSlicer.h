@@ -35,6 +35,7 @@ namespace base {
 	void update(RNG *rng);
 	static bool canSample(StochasticNode const *node);
 	double logDensity() const;
+	bool isTemperable() const;
     };
 
 }}
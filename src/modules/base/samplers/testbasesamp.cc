@@ -0,0 +1,332 @@
+#include "testbasesamp.h"
+
+#include "SliceFactory.h"
+#include "BlockFactory.h"
+#include "BlockMetropolis.h"
+#include "FiniteMethod.h"
+#include <functions/Add.h>
+
+#include <model/Model.h>
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/ScalarLogicalNode.h>
+#include <graph/Graph.h>
+#include <sampler/SamplerFactory.h>
+#include <sampler/Sampler.h>
+#include <sampler/GraphView.h>
+#include <sampler/SingletonGraphView.h>
+#include <MersenneTwisterRNG.h>
+#include <DNorm.h>
+#include <DBin.h>
+#include <DPois.h>
+
+#include <list>
+#include <vector>
+#include <utility>
+#include <string>
+#include <cmath>
+
+using std::vector;
+using std::list;
+using std::pair;
+using std::string;
+using std::exp;
+using std::pow;
+
+using jags::Model;
+using jags::RNG;
+using jags::ConstantNode;
+using jags::ScalarStochasticNode;
+using jags::ScalarLogicalNode;
+using jags::GraphView;
+using jags::Sampler;
+using jags::SamplerFactory;
+using jags::base::MersenneTwisterRNG;
+using jags::base::SliceFactory;
+using jags::base::BlockFactory;
+using jags::base::BlockMetropolis;
+using jags::base::FiniteMethod;
+using jags::base::Add;
+using jags::bugs::DNorm;
+using jags::bugs::DBin;
+using jags::bugs::DPois;
+
+void BaseSampTest::tempering()
+{
+    /*
+      mu ~ dnorm(0, 1); y ~ dnorm(mu, 1) with y = 2. At temperature
+      T, the likelihood is raised to the power 1/T, so mu has a normal
+      distribution with mean 2/(T + 1) and variance T/(T + 1)
+    */
+
+    DNorm dnorm;
+    unsigned int const nchain = 3;
+    Model model(nchain);
+
+    ConstantNode *zero = new ConstantNode(0, nchain, false);
+    ConstantNode *one = new ConstantNode(1, nchain, false);
+    model.addNode(zero);
+    model.addNode(one);
+
+    vector<jags::Node const *> mupar = {zero, one};
+    ScalarStochasticNode *mu = 
+	new ScalarStochasticNode(&dnorm, nchain, mupar, 0, 0);
+    model.addNode(mu);
+    vector<jags::Node const *> ypar = {mu, one};
+    ScalarStochasticNode *y =
+	new ScalarStochasticNode(&dnorm, nchain, ypar, 0, 0);
+    double yval = 2;
+    y->setData(&yval, 1);
+    model.addNode(y);
+
+    vector<RNG*> rngs;
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	rngs.push_back(new MersenneTwisterRNG(1234 + ch,
+					      jags::KINDERMAN_RAMAGE));
+	model.setRNG(rngs.back(), ch);
+    }
+
+    SliceFactory factory;
+    list<pair<SamplerFactory*, bool> > &flist = Model::samplerFactories();
+    flist.push_front(pair<SamplerFactory*, bool>(&factory, true));
+    model.initialize(false);
+    flist.pop_front();
+
+    //Swap pairs must alternate with the number of rounds of swaps,
+    //not with the iteration number. With equal temperatures every
+    //swap is accepted, so acceptance rates are exactly 1 even if
+    //tempering starts on an odd iteration after an odd number of
+    //rounds.
+    model.update(1);
+    model.setTemperatures(vector<double>(nchain, 1));
+    model.update(3);
+    vector<double> acc = model.swapAcceptance();
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(nchain - 1), acc.size());
+    for (unsigned int n = 0; n < nchain - 1; ++n) {
+	CPPUNIT_ASSERT_EQUAL(1.0, acc[n]);
+    }
+
+    //Each chain samples from the tempered distribution and swaps
+    //leave the target distributions unchanged
+    vector<double> temp = {1, 2, 4};
+    model.setTemperatures(temp);
+    model.update(1000);
+    unsigned int const N = 20000;
+    vector<double> S(nchain, 0), SS(nchain, 0);
+    for (unsigned int i = 0; i < N; ++i) {
+	model.update(1);
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double x = mu->value(ch)[0];
+	    S[ch] += x;
+	    SS[ch] += x * x;
+	}
+    }
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	double mean = S[ch] / N;
+	double var = SS[ch] / N - mean * mean;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(2 / (temp[ch] + 1), mean, 0.05);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(temp[ch] / (temp[ch] + 1), var, 0.05);
+    }
+    acc = model.swapAcceptance();
+    for (unsigned int n = 0; n < nchain - 1; ++n) {
+	CPPUNIT_ASSERT(acc[n] > 0 && acc[n] < 1);
+    }
+
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	delete rngs[ch];
+    }
+}
+
+void BaseSampTest::blockrw()
+{
+    /*
+      a ~ dnorm(0, 1); b ~ dnorm(0, 1); y ~ dnorm(a + b, 4) with
+      y = 1. The posterior precision of (a, b) is [5 4; 4 5], so a
+      and b have mean 4/9, variance 5/9 and covariance -4/9.
+    */
+
+    DNorm dnorm;
+    Add add;
+    unsigned int const nchain = 1;
+    Model model(nchain);
+
+    ConstantNode *zero = new ConstantNode(0, nchain, false);
+    ConstantNode *one = new ConstantNode(1, nchain, false);
+    ConstantNode *four = new ConstantNode(4, nchain, false);
+    model.addNode(zero);
+    model.addNode(one);
+    model.addNode(four);
+
+    vector<jags::Node const *> prior = {zero, one};
+    ScalarStochasticNode *a = 
+	new ScalarStochasticNode(&dnorm, nchain, prior, 0, 0);
+    ScalarStochasticNode *b = 
+	new ScalarStochasticNode(&dnorm, nchain, prior, 0, 0);
+    model.addNode(a);
+    model.addNode(b);
+    vector<jags::Node const *> sumpar = {a, b};
+    ScalarLogicalNode *sum = new ScalarLogicalNode(&add, nchain, sumpar);
+    model.addNode(sum);
+    vector<jags::Node const *> ypar = {sum, four};
+    ScalarStochasticNode *y =
+	new ScalarStochasticNode(&dnorm, nchain, ypar, 0, 0);
+    double yval = 1;
+    y->setData(&yval, 1);
+    model.addNode(y);
+
+    //a and b share a stochastic child, so they are sampled as a block
+    BlockFactory factory;
+    jags::Graph graph;
+    graph.insert(a);
+    graph.insert(b);
+    graph.insert(sum);
+    graph.insert(y);
+    list<jags::StochasticNode*> free_nodes = {a, b};
+    double ab0[2] = {0, 0};
+    a->setValue(ab0, 1, 0);
+    b->setValue(ab0 + 1, 1, 0);
+    sum->deterministicSample(0);
+    vector<Sampler*> samplers = factory.makeSamplers(free_nodes, graph);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), samplers.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(2), samplers[0]->nodes().size());
+    CPPUNIT_ASSERT_EQUAL(string("base::BlockRW"), samplers[0]->name());
+    delete samplers[0];
+
+    MersenneTwisterRNG rng(4321, jags::KINDERMAN_RAMAGE);
+    model.setRNG(&rng, 0);
+
+    list<pair<SamplerFactory*, bool> > &flist = Model::samplerFactories();
+    flist.push_front(pair<SamplerFactory*, bool>(&factory, true));
+    model.initialize(false);
+    flist.pop_front();
+
+    //The proposal covariance must be learned in the adaptive phase
+    model.update(2000);
+    CPPUNIT_ASSERT(model.checkAdaptation());
+    model.adaptOff();
+
+    unsigned int const N = 50000;
+    double Sa = 0, Sb = 0, Saa = 0, Sbb = 0, Sab = 0;
+    for (unsigned int i = 0; i < N; ++i) {
+	model.update(1);
+	double x = a->value(0)[0], z = b->value(0)[0];
+	Sa += x; Sb += z;
+	Saa += x * x; Sbb += z * z; Sab += x * z;
+    }
+    double ma = Sa / N, mb = Sb / N;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0/9, ma, 0.03);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0/9, mb, 0.03);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0/9, Saa / N - ma * ma, 0.03);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0/9, Sbb / N - mb * mb, 0.03);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-4.0/9, Sab / N - ma * mb, 0.03);
+}
+
+void BaseSampTest::blockrw_swap()
+{
+    /*
+      Under parallel tempering, the value of a node can be changed
+      between updates by a swap between chains. A rejected proposal
+      must then return to the swapped value, not to the value
+      accepted in the previous update.
+    */
+
+    DNorm dnorm;
+    ConstantNode zero(0, 1, false), one(1, 1, false), prec(1.0E6, 1, false);
+    vector<jags::Node const *> prior = {&zero, &one};
+    ScalarStochasticNode a(&dnorm, 1, prior, 0, 0);
+    ScalarStochasticNode b(&dnorm, 1, prior, 0, 0);
+    vector<jags::Node const *> yapar = {&a, &prec}, ybpar = {&b, &prec};
+    ScalarStochasticNode ya(&dnorm, 1, yapar, 0, 0);
+    ScalarStochasticNode yb(&dnorm, 1, ybpar, 0, 0);
+    double yval = 0.5;
+    ya.setData(&yval, 1);
+    yb.setData(&yval, 1);
+
+    jags::Graph graph;
+    graph.insert(&a);
+    graph.insert(&b);
+    graph.insert(&ya);
+    graph.insert(&yb);
+    vector<jags::StochasticNode*> nodes = {&a, &b};
+    GraphView gv(nodes, graph, true);
+    vector<double> x0 = {0, 0};
+    gv.setValue(x0, 0);
+
+    BlockMetropolis method(&gv, 0);
+    MersenneTwisterRNG rng(99, jags::KINDERMAN_RAMAGE);
+
+    //The posterior is concentrated within 0.001 of (0.5, 0.5), so the
+    //initial random walk proposals are rejected
+    vector<double> x1 = {0.5, 0.5};
+    gv.setValue(x1, 0);
+    method.update(&rng);
+    vector<double> x(2);
+    gv.getValue(x, 0);
+    CPPUNIT_ASSERT_EQUAL(0.5, x[0]);
+    CPPUNIT_ASSERT_EQUAL(0.5, x[1]);
+}
+
+void BaseSampTest::finite()
+{
+    /*
+      x ~ dbin(p, 4); y ~ dpois(x) with y = 2, and p = 0.2 in chain 1
+      and 0.7 in chain 2. The full conditional of x is proportional to
+      choose(4, x) p^x (1 - p)^(4 - x) x^2 exp(-x). The chains are
+      updated alternately, so that each one must use its own working
+      space for the likelihood.
+    */
+
+    DBin dbin;
+    DPois dpois;
+    DNorm dnorm;
+    unsigned int const nchain = 2;
+
+    ConstantNode zero(0, nchain, false), one(1, nchain, false);
+    ConstantNode four(4, nchain, false);
+    vector<jags::Node const *> ppar = {&zero, &one};
+    ScalarStochasticNode p(&dnorm, nchain, ppar, 0, 0);
+    double const pval[nchain] = {0.2, 0.7};
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	p.setValue(pval + ch, 1, ch);
+    }
+    vector<jags::Node const *> xpar = {&p, &four};
+    ScalarStochasticNode x(&dbin, nchain, xpar, 0, 0);
+    vector<jags::Node const *> ypar = {&x};
+    ScalarStochasticNode y(&dpois, nchain, ypar, 0, 0);
+    double yval = 2;
+    y.setData(&yval, 1);
+
+    jags::Graph graph;
+    graph.insert(&x);
+    graph.insert(&y);
+    jags::SingletonGraphView gv(&x, graph);
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	double x0 = 1;
+	gv.setValue(&x0, 1, ch);
+    }
+    FiniteMethod method(&gv);
+
+    MersenneTwisterRNG rng(5678, jags::KINDERMAN_RAMAGE);
+    unsigned int const N = 20000;
+    vector<vector<double> > freq(nchain, vector<double>(5, 0));
+    for (unsigned int i = 0; i < N; ++i) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    method.update(ch, &rng);
+	    freq[ch][static_cast<unsigned int>(x.value(ch)[0])] += 1.0 / N;
+	}
+    }
+
+    double const choose[5] = {1, 4, 6, 4, 1};
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	vector<double> prob(5);
+	double S = 0;
+	for (unsigned int k = 0; k < 5; ++k) {
+	    prob[k] = choose[k] * pow(pval[ch], k) * pow(1 - pval[ch], 4 - k)
+		* k * k * exp(-static_cast<double>(k));
+	    S += prob[k];
+	}
+	for (unsigned int k = 0; k < 5; ++k) {
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(prob[k] / S, freq[ch][k], 0.015);
+	}
+    }
+}
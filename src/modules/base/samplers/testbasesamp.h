@@ -0,0 +1,23 @@
+#ifndef BASE_SAMP_TEST_H
+#define BASE_SAMP_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+class BaseSampTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( BaseSampTest );
+    CPPUNIT_TEST( tempering );
+    CPPUNIT_TEST( blockrw );
+    CPPUNIT_TEST( blockrw_swap );
+    CPPUNIT_TEST( finite );
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void tempering();
+    void blockrw();
+    void blockrw_swap();
+    void finite();
+};
+
+#endif  // BASE_SAMP_TEST_H
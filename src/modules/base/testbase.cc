@@ -1,7 +1,11 @@
 #include "testbase.h"
 #include "functions/testbasefun.h"
+#include "rngs/testbaserngs.h"
+#include "samplers/testbasesamp.h"
 #include <cppunit/extensions/HelperMacros.h>
 
 void init_base_test() {
     CPPUNIT_TEST_SUITE_REGISTRATION( BaseFunTest );
+    CPPUNIT_TEST_SUITE_REGISTRATION( BaseRNGTest );
+    CPPUNIT_TEST_SUITE_REGISTRATION( BaseSampTest );
 }
@@ -100,6 +100,7 @@
 #include <samplers/ConjugateFactory.h>
 #include <samplers/DSumFactory.h>
 #include <samplers/MNormalFactory.h>
+#include <samplers/EllipticalSliceFactory.h>
 #include <samplers/DirichletFactory.h>
 #include <samplers/SumFactory.h>
 #include <samplers/RW1Factory.h>
@@ -214,6 +215,9 @@ namespace bugs {
 	
 	//Load sampler factories
 	insert(new MNormalFactory);
+	//Elliptical slice sampling is opt-in: it mixes badly when the
+	//prior is vague compared with the likelihood
+	insert(new EllipticalSliceFactory, false);
 	insert(new DirichletFactory);
 	insert(new BinomSliceFactory);
 	insert(new ConjugateFactory);
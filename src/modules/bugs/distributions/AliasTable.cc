@@ -0,0 +1,104 @@
+#include <config.h>
+
+#include "AliasTable.h"
+
+#include <rng/RNG.h>
+#include <util/ValueCache.h>
+
+#include <vector>
+
+using std::vector;
+
+//Maximum number of bytes held by the cache of each thread
+#define MAX_CACHE_SIZE 8388608
+
+namespace {
+
+    thread_local jags::ValueCache<jags::bugs::AliasTable>
+    cache(MAX_CACHE_SIZE);
+
+    //Workspace for building tables
+    thread_local vector<unsigned long> work;
+
+}
+
+namespace jags {
+namespace bugs {
+
+void AliasTable::build(double const *prob, unsigned long ncat)
+{
+    _cut.resize(ncat);
+    _alias.resize(ncat);
+
+    double sump = 0;
+    for (unsigned long i = 0; i < ncat; ++i) {
+	sump += prob[i];
+    }
+
+    /*
+       Method of Vose (1991). Each category starts with a column of
+       height ncat * p[i]. Categories with columns shorter than 1
+       ("small") are filled up with the excess of a category taller
+       than 1 ("large"), which becomes their alias. The two worklists
+       share one array, with small columns stacked from the front and
+       large columns from the back.
+    */
+    work.resize(ncat);
+    unsigned long ns = 0, nl = ncat;
+    double scale = ncat / sump;
+    for (unsigned long i = 0; i < ncat; ++i) {
+	_cut[i] = prob[i] * scale;
+	_alias[i] = i;
+	if (_cut[i] < 1) {
+	    work[ns++] = i;
+	}
+	else {
+	    work[--nl] = i;
+	}
+    }
+    while (ns > 0 && nl < ncat) {
+	unsigned long s = work[--ns], l = work[nl];
+	_alias[s] = l;
+	_cut[l] -= 1 - _cut[s];
+	if (_cut[l] < 1) {
+	    ++nl;
+	    work[ns++] = l;
+	}
+    }
+    //Remaining columns have height 1, up to rounding error
+    for (unsigned long i = 0; i < ns; ++i) {
+	_cut[work[i]] = 1;
+    }
+    for (unsigned long i = nl; i < ncat; ++i) {
+	_cut[work[i]] = 1;
+    }
+}
+
+AliasTable const &AliasTable::table(double const *prob, unsigned long ncat)
+{
+    AliasTable *p = cache.find(prob, ncat);
+    if (p) {
+	return *p;
+    }
+
+    //If there is an old table for prob, it is rebuilt in place,
+    //reusing the storage
+    AliasTable &t = cache.insert(prob, ncat);
+    t.build(prob, ncat);
+    cache.charge(prob, ncat * (sizeof(double) + sizeof(unsigned long)));
+    return t;
+}
+
+unsigned long AliasTable::sample(RNG *rng) const
+{
+    /* The integer part of t gives the column and the fractional part
+       decides between the category and its alias */
+    double t = rng->uniform() * _cut.size();
+    unsigned long i = static_cast<unsigned long>(t);
+    if (i >= _cut.size()) {
+	i = _cut.size() - 1;
+    }
+    return (t - i < _cut[i]) ? i : _alias[i];
+}
+
+}}
@@ -0,0 +1,49 @@
+#ifndef ALIAS_TABLE_H_
+#define ALIAS_TABLE_H_
+
+#include <vector>
+
+namespace jags {
+
+struct RNG;
+
+namespace bugs {
+
+/**
+ * @short Alias table for sampling a discrete distribution
+ *
+ * After a set-up cost proportional to the number of categories, an
+ * alias table draws a category in constant time, using a single
+ * uniform random number (Walker, 1977; Vose, 1991).
+ *
+ * The set-up cost is only worth paying if the same probability
+ * vector is used for many draws, as when many categorical nodes share
+ * the same parent. Tables are therefore kept in a ValueCache for each
+ * thread, and rebuilt only when the probabilities change.
+ */
+class AliasTable {
+    std::vector<double> _cut;
+    std::vector<unsigned long> _alias;
+    void build(double const *prob, unsigned long ncat);
+  public:
+    /**
+     * Returns the alias table for a probability vector
+     *
+     * @param prob Pointer to an array of non-negative probabilities,
+     * which need not sum to one
+     *
+     * @param ncat Number of categories
+     *
+     * @return Reference to a table that remains valid until the
+     * next call from the same thread.
+     */
+    static AliasTable const &table(double const *prob, unsigned long ncat);
+    /**
+     * Draws a category, numbered from 0
+     */
+    unsigned long sample(RNG *rng) const;
+};
+
+}}
+
+#endif /* ALIAS_TABLE_H_ */
@@ -75,4 +75,14 @@ bool DBern::isDiscreteValued(vector<bool> const &mask) const
 	}
     }
 
+bool DBern::gradLogDensity(double *gx, double *gpar, double x,
+			   vector<double const *> const &par,
+			   double const *lower, double const *upper) const
+{
+    double p = PROB(par);
+    *gx = 0;
+    gpar[0] = x / p - (1 - x) / (1 - p);
+    return true;
+}
+
 }}
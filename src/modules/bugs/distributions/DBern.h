@@ -31,6 +31,9 @@ public:
     bool isDiscreteValued(std::vector<bool> const &mask) const;
     double KL(std::vector<double const *> const &par1, 
 	      std::vector<double const *> const &par2) const;
+    bool gradLogDensity(double *gx, double *gpar, double x,
+			std::vector<double const *> const &parameters,
+			double const *lbound, double const *ubound) const;
 };
 
 }}
@@ -79,4 +79,19 @@ double DBeta::KL(vector<double const *> const &par1,
 	+ (a2 + b2 - a1 - b1) * digamma(a1 + b1);
 }
 
+bool DBeta::gradLogDensity(double *gx, double *gpar, double x,
+			   vector<double const *> const &par,
+			   double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double a = *par[0], b = *par[1];
+    double dab = digamma(a + b);
+    *gx = (a - 1) / x - (b - 1) / (1 - x);
+    gpar[0] = log(x) - digamma(a) + dab;
+    gpar[1] = log(1 - x) - digamma(b) + dab;
+    return true;
+}
+
 }}
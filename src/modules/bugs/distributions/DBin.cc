@@ -4,7 +4,7 @@
 
 #include <algorithm>
 
-#include <JRmath.h>
+#include <nmath.h>
 
 #include <util/nainf.h>
 
@@ -43,7 +43,28 @@ bool DBin::checkParameterValue (vector<double const *> const &par) const
 double DBin::d(double x, PDFType type, vector<double const *> const &par, 
 	       bool give_log) const
 {
-    return dbinom(x, SIZE(par), PROB(par), give_log);
+    if (type == PDF_LIKELIHOOD) {
+	/* 
+	   The observed value is fixed. The binomial coefficient is
+	   taken from the log factorial table, which is cheaper than
+	   the saddle point expansion used by dbinom.
+	*/
+	double n = SIZE(par), p = PROB(par);
+	if (x < 0 || x > n || R_D_nonint(x)) {
+	    return give_log ? JAGS_NEGINF : 0;
+	}
+	double y = lchoose(n, x);
+	if (x > 0) {
+	    y += x * log(p);
+	}
+	if (x < n) {
+	    y += (n - x) * log1p(-p);
+	}
+	return give_log ? y : exp(y);
+    }
+    else {
+	return dbinom(x, SIZE(par), PROB(par), give_log);
+    }
 }
 
 double DBin::p(double x, vector<double const *> const &par, 
@@ -105,4 +126,18 @@ double DBin::KL(vector<double const *> const &par0,
     }
 }
 
+bool DBin::gradLogDensity(double *gx, double *gpar, double x,
+			  vector<double const *> const &par,
+			  double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double p = PROB(par), n = SIZE(par);
+    *gx = 0;
+    gpar[0] = x / p - (n - x) / (1 - p);
+    gpar[1] = 0; //Discrete-valued parameter
+    return true;
+}
+
 }}
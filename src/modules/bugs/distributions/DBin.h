@@ -38,6 +38,9 @@ class DBin : public RScalarDist {
   bool isSupportFixed(std::vector<bool> const &fixmask) const;
   double KL(std::vector<double const *> const &par1, 
 	    std::vector<double const *> const &par2) const;
+  bool gradLogDensity(double *gx, double *gpar, double x,
+		      std::vector<double const *> const &parameters,
+		      double const *lbound, double const *ubound) const;
 };
 
 }}
@@ -1,5 +1,6 @@
 #include <config.h>
 #include "DCat.h"
+#include "AliasTable.h"
 #include <rng/RNG.h>
 #include <util/dim.h>
 #include <util/nainf.h>
@@ -18,6 +19,8 @@ using std::max_element;
 
 #define PROB(par) (par[0])
 #define NCAT(lengths) (lengths[0])
+//Distributions with at least this many categories use an alias table
+#define ALIAS_MIN 16
 
 namespace jags {
 namespace bugs {
@@ -76,6 +79,11 @@ void DCat::randomSample(double *x, unsigned long length,
 			double const *lower, double const *upper,
 			RNG *rng) const
 {
+    if (NCAT(lengths) >= ALIAS_MIN) {
+	*x = AliasTable::table(PROB(par), NCAT(lengths)).sample(rng) + 1;
+	return;
+    }
+
     double sump = 0;
     unsigned long i = 0;
 
@@ -143,4 +151,25 @@ unsigned long DCat::length(vector<unsigned long> const &lengths) const
 	return y;
     }
 
+bool DCat::gradLogDensity(double *gx, vector<double *> const &gpar,
+			  double const *x, unsigned long length,
+			  vector<double const *> const &par,
+			  vector<unsigned long> const &lengths,
+			  double const *lower, double const *upper) const
+{
+    double const *prob = PROB(par);
+    unsigned long y = static_cast<unsigned long>(*x);
+
+    double sump = 0.0;
+    for (unsigned long i = 0; i < NCAT(lengths); ++i) {
+	sump += prob[i];
+    }
+    gx[0] = 0;
+    for (unsigned long i = 0; i < NCAT(lengths); ++i) {
+	gpar[0][i] = -1/sump;
+    }
+    gpar[0][y-1] += 1/prob[y-1];
+    return true;
+}
+
 }}
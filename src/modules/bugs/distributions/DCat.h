@@ -41,6 +41,11 @@ public:
     double KL(std::vector<double const *> const &par0,
 	      std::vector<double const *> const &par1,
 	      std::vector<unsigned long> const &lengths) const;
+    bool gradLogDensity(double *gx, std::vector<double *> const &gpar,
+			double const *x, unsigned long length,
+			std::vector<double const *> const &parameters,
+			std::vector<unsigned long> const &lengths,
+			double const *lbound, double const *ubound) const;
 };
 
 }}
@@ -106,4 +106,19 @@ double DDexp::r(vector<double const *> const &par, RNG *rng) const
 	return r * (delta + exp(-delta)) - 1 - log(r);
     }
 
+bool DDexp::gradLogDensity(double *gx, double *gpar, double x,
+			   vector<double const *> const &par,
+			   double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double mu = MU(par), tau = RATE(par);
+    double s = (x > mu) ? 1 : ((x < mu) ? -1 : 0);
+    *gx = -tau * s;
+    gpar[0] = tau * s;
+    gpar[1] = 1 / tau - fabs(x - mu);
+    return true;
+}
+
 }}
@@ -31,6 +31,9 @@ public:
   bool checkParameterValue(std::vector<double const *> const &parameters) const;
   double KL(std::vector<double const *> const &par1,
 	    std::vector<double const *> const &par2) const;
+  bool gradLogDensity(double *gx, double *gpar, double x,
+		      std::vector<double const *> const &parameters,
+		      double const *lbound, double const *ubound) const;
 };
 
 }}
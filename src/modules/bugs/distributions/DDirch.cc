@@ -171,4 +171,31 @@ double DDirch::KL(vector<double const *> const &par0,
     return y;
 }
 
+bool DDirch::gradLogDensity(double *gx, vector<double *> const &gpar,
+			    double const *x, unsigned long length,
+			    vector<double const *> const &par,
+			    vector<unsigned long> const &lengths,
+			    double const *lower, double const *upper) const
+{
+    double const *alpha = ALPHA(par);
+
+    double sumalpha = 0.0;
+    for (unsigned long i = 0; i < length; ++i) {
+	sumalpha += alpha[i];
+    }
+    double dsum = digamma(sumalpha);
+    for (unsigned long i = 0; i < length; ++i) {
+	if (alpha[i] == 0) {
+	    //Structural zero with fixed alpha
+	    gx[i] = 0;
+	    gpar[0][i] = 0;
+	}
+	else {
+	    gx[i] = (alpha[i] - 1) / x[i];
+	    gpar[0][i] = log(x[i]) - digamma(alpha[i]) + dsum;
+	}
+    }
+    return true;
+}
+
 }}
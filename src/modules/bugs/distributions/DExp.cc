@@ -61,4 +61,17 @@ double DExp::KL(vector<double const *> const &par0,
     return r - 1 - log(r);
 }
 
+bool DExp::gradLogDensity(double *gx, double *gpar, double x,
+			  vector<double const *> const &par,
+			  double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double lambda = *par[0];
+    *gx = -lambda;
+    gpar[0] = 1 / lambda - x;
+    return true;
+}
+
 }}
@@ -30,6 +30,9 @@ class DExp : public RScalarDist {
   bool checkParameterValue(std::vector<double const *> const &parameters) const;
   double KL(std::vector<double const *> const &par0,
 	    std::vector<double const *> const &par1) const;
+  bool gradLogDensity(double *gx, double *gpar, double x,
+		      std::vector<double const *> const &parameters,
+		      double const *lbound, double const *ubound) const;
 };
 
 }}
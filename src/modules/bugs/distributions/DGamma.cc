@@ -74,4 +74,18 @@ double DGamma::KL(vector<double const *> const &par0,
 	+ (b0 - b1) * digamma(b0) + lgammafn(b1) - lgammafn(b0);
 }
 
+bool DGamma::gradLogDensity(double *gx, double *gpar, double x,
+			    vector<double const *> const &par,
+			    double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double r = SHAPE(par), mu = RATE(par);
+    *gx = (r - 1) / x - mu;
+    gpar[0] = log(mu) + log(x) - digamma(r);
+    gpar[1] = r / mu - x;
+    return true;
+}
+
 }}
@@ -64,4 +64,19 @@ DLnorm::KL(vector<double const *> const &par0,
 	    log(tau0/tau1)) / 2;
 }
 
+bool DLnorm::gradLogDensity(double *gx, double *gpar, double x,
+			    vector<double const *> const &par,
+			    double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double mu = MU(par), tau = TAU(par);
+    double z = log(x) - mu;
+    *gx = -(1 + tau * z) / x;
+    gpar[0] = tau * z;
+    gpar[1] = 0.5 / tau - 0.5 * z * z;
+    return true;
+}
+
 }}
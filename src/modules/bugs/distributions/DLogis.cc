@@ -49,4 +49,20 @@ DLogis::r(vector<double const *> const &par, RNG *rng) const
     return ans;
 }
 
+bool DLogis::gradLogDensity(double *gx, double *gpar, double x,
+			    vector<double const *> const &par,
+			    double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double mu = MU(par), tau = TAU(par);
+    //Derivative of the log density with respect to z = tau * (x - mu)
+    double dz = 1 - 2 / (1 + exp(-tau * (x - mu)));
+    *gx = tau * dz;
+    gpar[0] = -tau * dz;
+    gpar[1] = 1 / tau + (x - mu) * dz;
+    return true;
+}
+
 }}
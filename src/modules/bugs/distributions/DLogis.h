@@ -28,6 +28,9 @@ class DLogis : public RScalarDist {
    * Checks that tau > 0
    */
   bool checkParameterValue(std::vector<double const *> const &parameters) const;
+  bool gradLogDensity(double *gx, double *gpar, double x,
+		      std::vector<double const *> const &parameters,
+		      double const *lbound, double const *ubound) const;
 };
 
 }}
@@ -2,11 +2,14 @@
 #include <util/dim.h>
 #include <util/nainf.h>
 #include <util/integer.h>
+#include <rng/RNG.h>
 
 #include "DMNorm.h"
 
 #include <lapack.h>
 #include <matrix.h>
+#include <CholeskyCache.h>
+#include <module/ModuleError.h>
 
 #include <cmath>
 #include <vector>
@@ -15,6 +18,7 @@
 #include <JRmath.h>
 
 using std::vector;
+using std::copy;
 
 namespace jags {
 namespace bugs {
@@ -41,14 +45,17 @@ double DMNorm::logDensity(double const *x, unsigned long m, PDFType type,
 	}
     }
 
+    double ldet = 0;
     switch(type) {
     case PDF_PRIOR:
 	break;
     case PDF_LIKELIHOOD:
-	loglik += logdet(T, m)/2;
+	CholeskyCache::factor(T, m, ldet);
+	loglik += ldet/2;
 	break;
     case PDF_FULL:
-	loglik += logdet(T, m)/2 - m * M_LN_SQRT_2PI;
+	CholeskyCache::factor(T, m, ldet);
+	loglik += ldet/2 - m * M_LN_SQRT_2PI;
 	break;
     }
     
@@ -63,53 +70,54 @@ void DMNorm::randomSample(double *x, unsigned long m,
 {
     double const * mu = parameters[0];
     double const * T = parameters[1];
-    
-    randomsample(x, mu, T, true, m, rng);
+
+    double ldet = 0;
+    double const *L = CholeskyCache::factor(T, m, ldet);
+    randomsample_chol(x, mu, L, true, m, rng);
 }
 
 void DMNorm::randomsample(double *x, double const *mu, double const *T,
 			  bool prec, unsigned long nrow, RNG *rng)
 {
-  //FIXME: do something with rng
-
-  unsigned long N = nrow*nrow;
-  vector<double> Tcopy(N);
-  copy(T, T + N, Tcopy.begin());
-  vector<double> w(nrow);
-
-  int info = 0;
-  double worktest;
-  int lwork = -1;
-  int nr = asInteger(nrow);
-  // Workspace query
-  F77_DSYEV ("V", "L", &nr, &Tcopy[0], &nr, &w[0], &worktest, &lwork, &info);
-  // Now get eigenvalues/vectors with optimal work space
-  lwork = static_cast<int>(worktest);
-  vector<double> work(static_cast<unsigned long>(lwork));
-  F77_DSYEV ("V", "L", &nr, &Tcopy[0], &nr, &w[0], &work[0], &lwork, &info);
-
-  /* Generate independent random normal variates, scaled by
-     the eigen values. We reuse the array w. */
-  if (prec) {
-      for (unsigned long i = 0; i < nrow; ++i) {
-	  w[i] = rnorm(0, 1/sqrt(w[i]), rng);
-      }
-  }
-  else {
-      for (unsigned long i = 0; i < nrow; ++i) {
-	  w[i] = rnorm(0, sqrt(w[i]), rng);
-      }
-  }
-
-  /* Now transform them to dependant variates 
-    (On exit from DSYEV, Tcopy contains the eigenvectors)
-  */
-  for (unsigned long i = 0; i < nrow; ++i) {
-      x[i] = mu ? mu[i] : 0;
-      for (unsigned long j = 0; j < nrow; ++j) {
-	  x[i] += Tcopy[i + j * nrow] * w[j]; 
-      }
-  }
+    unsigned long N = nrow*nrow;
+    vector<double> L(N);
+    copy(T, T + N, L.begin());
+
+    int info = 0;
+    int nr = asInteger(nrow);
+    F77_DPOTRF("L", &nr, &L[0], &nr, &info);
+    if (info < 0) {
+	throwLogicError("Illegal argument in DMNorm::randomsample");
+    }
+    else if (info > 0) {
+	throwRuntimeError("Non positive definite matrix in dmnorm");
+    }
+    
+    randomsample_chol(x, mu, &L[0], prec, nrow, rng);
+}
+
+void DMNorm::randomsample_chol(double *x, double const *mu, double const *L,
+			       bool prec, unsigned long nrow, RNG *rng)
+{
+    /* If L is the Cholesky factor of the precision matrix then
+       t(L)^-1 z has the required distribution, and if L is the
+       Cholesky factor of the variance matrix then L z does. */
+    
+    rng->normal(x, nrow);
+
+    int nr = asInteger(nrow);
+    int one = 1;
+    if (prec) {
+	F77_DTRSV("L", "T", "N", &nr, L, &nr, x, &one);
+    }
+    else {
+	F77_DTRMV("L", "N", "N", &nr, L, &nr, x, &one);
+    }
+    if (mu) {
+	for (unsigned long i = 0; i < nrow; ++i) {
+	    x[i] += mu[i];
+	}
+    }
 }
 
 bool DMNorm::checkParameterDim(vector<vector<unsigned long> > const &dims) const
@@ -152,4 +160,38 @@ bool DMNorm::isSupportFixed(vector<bool> const &fixmask) const
     return true;
 }
 
+bool DMNorm::gradLogDensity(double *gx, vector<double *> const &gpar,
+			    double const *x, unsigned long length,
+			    vector<double const *> const &par,
+			    vector<vector<unsigned long> > const &dims,
+			    double const *lower, double const *upper) const
+{
+    double const * mu = par[0];
+    double const * T = par[1];
+    unsigned long m = length;
+
+    vector<double> delta(m);
+    for (unsigned long i = 0; i < m; ++i) {
+	delta[i] = x[i] - mu[i];
+    }
+    for (unsigned long i = 0; i < m; ++i) {
+	gx[i] = 0;
+	for (unsigned long j = 0; j < m; ++j) {
+	    gx[i] -= T[i + j * m] * delta[j];
+	}
+	gpar[0][i] = -gx[i];
+    }
+
+    //Derivative with respect to the precision matrix, treating the
+    //upper and lower triangles symmetrically. The inverse is cached,
+    //so it is not recalculated when T is fixed.
+    double const *Tinv = CholeskyCache::inverse(T, m);
+    for (unsigned long i = 0; i < m; ++i) {
+	for (unsigned long j = 0; j < m; ++j) {
+	    gpar[1][i + j * m] = (Tinv[i + j * m] - delta[i] * delta[j]) / 2;
+	}
+    }
+    return true;
+}
+
 }}
@@ -15,6 +15,8 @@ namespace bugs {
  * x[] ~ dmnorm(mu[], T[,])
  * f(x | mu, T) = sqrt(det(T)) * exp(-1/2 * (x-mu) %*% T %*% t(x-mu))
  * </pre>
+ * The Cholesky factorisation of T is cached, so it is recalculated
+ * only when the value of T changes.
  */
 class DMNorm : public ArrayDist {
 public:
@@ -60,10 +62,37 @@ public:
    */
   static void randomsample(double *x, double const *mu, double const *tau,
 			   bool prec, unsigned long nrow, RNG *rng);
+  /**
+   * Random sampler function using a Cholesky factorisation
+   *
+   * @param x  Array that will hold the result
+   *
+   * @param mu Array of mean values. A null pointer may be given, and in
+   * this case a mean of zero is used.
+   *
+   * @param L Lower triangular Cholesky factor of either the precision
+   * matrix or the variance-covariance matrix. The upper triangle is not
+   * used.
+   *
+   * @param prec Logical flag. If true then L is a factor of the
+   * precision matrix. If false then it is a factor of the
+   * variance-covariance matrix.
+   *
+   * @param nrow length of x and mu; number of rows of the square matrix L
+   *
+   * @param rng Random number generator
+   */
+  static void randomsample_chol(double *x, double const *mu, double const *L,
+				bool prec, unsigned long nrow, RNG *rng);
   void support(double *lower, double *upper, unsigned long length,
 	       std::vector<double const *> const &parameters,
                std::vector<std::vector<unsigned long> > const &dims) const;
   bool isSupportFixed(std::vector<bool> const &fixmask) const;
+  bool gradLogDensity(double *gx, std::vector<double *> const &gpar,
+		      double const *x, unsigned long length,
+		      std::vector<double const *> const &parameters,
+		      std::vector<std::vector<unsigned long> > const &dims,
+		      double const *lbound, double const *ubound) const;
 };
 
 }}
@@ -6,6 +6,8 @@
 
 #include <lapack.h>
 #include <matrix.h>
+#include <CholeskyCache.h>
+#include <util/integer.h>
 
 #include <cmath>
 #include <vector>
@@ -33,27 +35,32 @@ namespace jags {
 	    double const * mu = parameters[0];
 	    double const * V  = parameters[1];
 
-	    vector<double> T(m * m);
-	    inverse_chol (&T[0], V, m);
+	    //With V = L %*% t(L), the quadratic form is the squared
+	    //norm of solve(L, x - mu)
+	    double ldet = 0;
+	    double const *L = CholeskyCache::factor(V, m, ldet);
 
-	    double loglik = 0;
 	    vector<double> delta(m);
 	    for (unsigned long i = 0; i < m; ++i) {
 		delta[i] = x[i] - mu[i];
-		loglik -= (delta[i] * T[i + i * m] * delta[i])/2;
-		for (unsigned long j = 0; j < i; ++j) {
-		    loglik -= delta[i] * T[i + j * m] * delta[j];
-		}
+	    }
+	    int nr = asInteger(m);
+	    int one = 1;
+	    F77_DTRSV("L", "N", "N", &nr, L, &nr, &delta[0], &one);
+
+	    double loglik = 0;
+	    for (unsigned long i = 0; i < m; ++i) {
+		loglik -= delta[i] * delta[i] / 2;
 	    }
 
 	    switch(type) {
 	    case PDF_PRIOR:
 		break;
 	    case PDF_LIKELIHOOD:
-		loglik -= logdet(V, m)/2;
+		loglik -= ldet/2;
 		break;
 	    case PDF_FULL:
-		loglik -= logdet(V, m)/2 + m * M_LN_SQRT_2PI;
+		loglik -= ldet/2 + m * M_LN_SQRT_2PI;
 		break;
 	    }
     
@@ -68,9 +75,11 @@ namespace jags {
 			       RNG *rng) const
 	{
 	    double const * mu = parameters[0];
-	    double const * T = parameters[1];
-    
-	    DMNorm::randomsample(x, mu, T, false, m, rng);
+	    double const * V = parameters[1];
+
+	    double ldet = 0;
+	    double const *L = CholeskyCache::factor(V, m, ldet);
+	    DMNorm::randomsample_chol(x, mu, L, false, m, rng);
 	}
 
 	bool
@@ -15,6 +15,8 @@ namespace bugs {
  * x[] ~ dmnorm.vcov(mu[], T[,])
  * f(x | mu, T) = exp(-1/2 * (x-mu) %*% inverse(T) %*% t(x-mu)) / sqrt(det(T))
  * </pre>
+ * The Cholesky factorisation of T is cached, so it is recalculated
+ * only when the value of T changes.
  */
 class DMNormVC : public ArrayDist {
 public:
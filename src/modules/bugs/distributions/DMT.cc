@@ -6,6 +6,7 @@
 
 #include <lapack.h>
 #include <matrix.h>
+#include <CholeskyCache.h>
 
 #include <cmath>
 #include <vector>
@@ -49,7 +50,9 @@ double DMT::logDensity(double const *x, unsigned long m, PDFType type,
 	return -((k + d)/2) * log(1 + ip/k);
     }
     else {
-	return -((k + d)/2) * log(1 + ip/k) + logdet(T, m)/2 +
+	double ldet = 0;
+	CholeskyCache::factor(T, m, ldet);
+	return -((k + d)/2) * log(1 + ip/k) + ldet/2 +
 	    lgammafn((k + d)/2) - lgammafn(k/2) - (d/2) * log(k) - 
 	    (d/2) * log(M_PI);
     }
@@ -65,10 +68,12 @@ void DMT::randomSample(double *x, unsigned long length,
     double const * T = parameters[1];
     double k = *parameters[2];
 
-    DMNorm::randomsample(x, mu, T, true, length, rng);
+    double ldet = 0;
+    double const *L = CholeskyCache::factor(T, length, ldet);
+    DMNorm::randomsample_chol(x, 0, L, true, length, rng);
     double C = sqrt(rchisq(k, rng)/k);
     for (unsigned long i = 0; i < length; ++i) {
-	x[i] = mu[i] + (x[i] - mu[i]) / C;
+	x[i] = mu[i] + x[i] / C;
     }
 }
 
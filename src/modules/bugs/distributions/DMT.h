@@ -11,6 +11,8 @@ namespace bugs {
  * <pre>
  * x[] ~ dmt(mu[], T[,], k)
  * </pre>
+ * The Cholesky factorisation of T is cached, so it is recalculated
+ * only when the value of T changes.
  */
 class DMT: public ArrayDist {
 public:
@@ -1,5 +1,6 @@
 #include <config.h>
 #include "DMulti.h"
+#include "AliasTable.h"
 #include <rng/RNG.h>
 #include <util/dim.h>
 #include <util/nainf.h>
@@ -13,6 +14,8 @@ using std::string;
 
 #define PROB(par) (par[0])
 #define SIZE(par) (*par[1])
+//Distributions with at least this many categories may use an alias table
+#define ALIAS_MIN 16
 
 namespace jags {
 namespace bugs {
@@ -102,14 +105,14 @@ double DMulti::logDensity(double const *x, unsigned long length, PDFType type,
     if (type != PDF_LIKELIHOOD) {
 	//Terms depending on sampled value only
 	for (unsigned long i = 0; i < length; ++i) {
-	    loglik -= lgammafn(x[i] + 1);
+	    loglik -= lfactorial(x[i]);
 	}
     }
 
     if (type == PDF_FULL) {
 	//If either data or parameters are fixed then this term is constant
 	//bearing in mind consistency check above.
-	loglik += lgammafn(SIZE(par) + 1);
+	loglik += lfactorial(SIZE(par));
     }
 
     return loglik;
@@ -126,6 +129,23 @@ void DMulti::randomSample(double *x, unsigned long length,
     double N = SIZE(par);
     double const *prob = PROB(par);
 
+    if (length >= ALIAS_MIN && N < length) {
+	/*
+	   Fewer trials than categories: it is cheaper to sample each
+	   trial from an alias table than to draw one binomial
+	   variable per category
+	*/
+	AliasTable const &table = AliasTable::table(prob, length);
+	for (unsigned long i = 0; i < length; ++i) {
+	    x[i] = 0;
+	}
+	unsigned long n = static_cast<unsigned long>(N);
+	for (unsigned long j = 0; j < n; ++j) {
+	    x[table.sample(rng)] += 1;
+	}
+	return;
+    }
+
     //Normalize probability
     double sump = 0;
     for (unsigned long i = 0; i < length; ++i) {
@@ -6,7 +6,7 @@
 #include <vector>
 #include <algorithm>
 
-#include <JRmath.h>
+#include <nmath.h>
 
 using std::vector;
 using std::max;
@@ -47,6 +47,22 @@ DNegBin::d(double x, PDFType type,
 	    return (x == 0) ? 1 : 0;
 	}
     }
+    else if (type == PDF_LIKELIHOOD && !R_D_nonint(SIZE(par))) {
+	/* 
+	   The observed value is fixed and the size is an integer, so
+	   the normalizing constant can be taken from the log
+	   factorial table.
+	*/
+	double r = SIZE(par), p = PROB(par);
+	if (x < 0 || R_D_nonint(x)) {
+	    return give_log ? JAGS_NEGINF : 0;
+	}
+	double y = lchoose(x + r - 1, x) + r * log(p);
+	if (x > 0) {
+	    y += x * log1p(-p);
+	}
+	return give_log ? y : exp(y);
+    }
     else {
 	return dnbinom(x, SIZE(par), PROB(par), give_log);
     }
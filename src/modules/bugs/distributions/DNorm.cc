@@ -94,4 +94,18 @@ double DNorm::randomSample(vector<double const *> const &par,
 		log(tau0/tau1)) / 2;
     }
     
+bool DNorm::gradLogDensity(double *gx, double *gpar, double x,
+			   vector<double const *> const &par,
+			   double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double mu = MU(par), tau = TAU(par);
+    *gx = -tau * (x - mu);
+    gpar[0] = tau * (x - mu);
+    gpar[1] = 0.5 / tau - 0.5 * (x - mu) * (x - mu);
+    return true;
+}
+
 }}
@@ -5,13 +5,12 @@
 #include <limits.h>
 #include <algorithm>
 
-#include <JRmath.h>
+#include <nmath.h>
 
 using std::vector;
 using std::max;
 
 #define LAMBDA(par) (*par[0])
-#define R_D_nonint(x)     (fabs((x) - floor((x)+0.5)) > 1e-7)
 
 namespace jags {
 namespace bugs {
@@ -76,4 +75,16 @@ double DPois::r(vector<double const *> const &par, RNG *rng) const
 	return lambda0 * (log(lambda0) - log(lambda1)) - lambda0 + lambda1;
     }
 
+bool DPois::gradLogDensity(double *gx, double *gpar, double x,
+			   vector<double const *> const &par,
+			   double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    *gx = 0;
+    gpar[0] = x / LAMBDA(par) - 1;
+    return true;
+}
+
 }}
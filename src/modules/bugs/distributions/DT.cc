@@ -56,4 +56,22 @@ double DT::r(vector<double const *> const &par, RNG *rng) const
     return rt(DF(par), rng) / sqrt(TAU(par)) + MU(par);
 }
 
+bool DT::gradLogDensity(double *gx, double *gpar, double x,
+			vector<double const *> const &par,
+			double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double mu = MU(par), tau = TAU(par), k = DF(par);
+    double delta = x - mu;
+    double z = tau * delta * delta / k;
+    *gx = -(k + 1) * tau * delta / (k * (1 + z));
+    gpar[0] = -*gx;
+    gpar[1] = 0.5 / tau - (k + 1) * delta * delta / (2 * k * (1 + z));
+    gpar[2] = (digamma((k + 1)/2) - digamma(k/2) - 1/k - log1p(z) +
+	       (k + 1) * z / (k * (1 + z))) / 2;
+    return true;
+}
+
 }}
@@ -32,6 +32,9 @@ class DT : public RScalarDist {
    */
   bool checkParameterValue(std::vector<double const *> const &parameters) const;
 
+  bool gradLogDensity(double *gx, double *gpar, double x,
+		      std::vector<double const *> const &parameters,
+		      double const *lbound, double const *ubound) const;
 };
 
 }}
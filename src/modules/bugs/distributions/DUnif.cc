@@ -69,4 +69,18 @@ double DUnif::KL(vector<double const *> const &par0,
     return log(UPPER(par1) - LOWER(par1)) - log(UPPER(par0) - LOWER(par0));
 }
 
+bool DUnif::gradLogDensity(double *gx, double *gpar, double x,
+			   vector<double const *> const &par,
+			   double const *lower, double const *upper) const
+{
+    if (lower || upper) {
+	return false; //Normalizing constant depends on parameters
+    }
+    double w = UPPER(par) - LOWER(par);
+    *gx = 0;
+    gpar[0] = 1 / w;
+    gpar[1] = -1 / w;
+    return true;
+}
+
 }}
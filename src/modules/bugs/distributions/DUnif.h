@@ -32,6 +32,9 @@ class DUnif : public ScalarDist {
     bool isSupportFixed(std::vector<bool> const &fixmask) const;
     double KL(std::vector<double const *> const &par0,
 	      std::vector<double const *> const &par1) const;
+    bool gradLogDensity(double *gx, double *gpar, double x,
+			std::vector<double const *> const &parameters,
+			double const *lbound, double const *ubound) const;
 };
 
 }}
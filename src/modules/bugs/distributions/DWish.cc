@@ -8,6 +8,7 @@
 
 #include "lapack.h"
 #include "matrix.h"
+#include "CholeskyCache.h"
 #include "DWish.h"
 
 #include <cfloat>
@@ -19,7 +20,8 @@
 
 using std::vector;
 using std::log;
-using std::reverse;
+using std::sqrt;
+using std::copy;
 
 #define SCALE(par) (par[0])
 #define DF(par)    (*par[1])
@@ -56,7 +58,9 @@ double DWish::logDensity(double const *x, unsigned long length, PDFType type,
 
     if (type != PDF_PRIOR) {
 	//Normalize density
-	loglik += DF(par) * logdet(scale, p) -  DF(par) * p * log(2.0) -
+	double ldet = 0;
+	CholeskyCache::factor(scale, p, ldet);
+	loglik += DF(par) * ldet -  DF(par) * p * log(2.0) -
 	    2 * log_multigamma(DF(par), p);
     }
 
@@ -67,65 +71,58 @@ void DWish::randomSample(double *X, unsigned long length,
 			 double const *R, double k, unsigned long nrow,
 			 RNG *rng)
 {
-    /* 
-       Generate random Wishart variable, using an algorithm proposed
-       by Bill Venables and originally implemented in S.
-    */
-
     if (length != nrow*nrow) {
 	jags::throwLogicError("invalid length in DWish::randomSample");
     }
 
-    /* 
-       Get Cholesky decomposition of the inverse of R. First we
-       factorize R (dpotrf) and then we invert the triangular factor
-       (dtrtri). At the end, C contains the upper triangular Cholesky
-       factor. NB We must reverse the elements of the matrix at start
-       and end of the calculations.
-    */
-    vector<double> C(length);
-    copy(R, R + length, C.rbegin());
+    vector<double> L(length);
+    copy(R, R + length, L.begin());
     int info = 0;
     int ni = asInteger(nrow);
-    F77_DPOTRF("L", &ni, &C[0], &ni, &info);
+    F77_DPOTRF("L", &ni, &L[0], &ni, &info);
     if (info != 0) {
 	jags::throwRuntimeError("Failed to get Cholesky decomposition of R");
     }
-    F77_DTRTRI("L", "N", &ni, &C[0], &ni, &info);
-    if (info != 0) {
-	jags::throwRuntimeError("Failed to invert Cholesky decomposition of R");
-    }
-    reverse(C.begin(), C.end());
-    
-    /* Generate square root of Wishart random variable:
-       - diagonal elements are square root of Chi square
-       - upper off-diagonal elements are normal
-       - lower off-diagonal elements are zero
+
+    randomSampleChol(X, &L[0], k, nrow, rng);
+}
+
+void DWish::randomSampleChol(double *X, double const *L, double k,
+			     unsigned long nrow, RNG *rng)
+{
+    /* 
+       Bartlett decomposition. If B is lower triangular with 
+       - diagonal elements that are square roots of Chi square 
+         variables with k, k-1, ... degrees of freedom
+       - lower off-diagonal elements that are standard normal
+       then B %*% t(B) has a Wishart distribution with identity
+       scale matrix. With R = L %*% t(L) and A = solve(t(L), B),
+       X = A %*% t(A) has a Wishart distribution with scale matrix
+       solve(R).
     */
-    vector<double> Z(length);
+
+    vector<double> A(nrow * nrow, 0);
     for (unsigned long j = 0; j < nrow; j++) {
-	double *Z_j = &Z[j*nrow]; //jth column of Z
-	for (int i = 0; i < j; i++) {
-	    Z_j[i] = rnorm(0, 1, rng);
-	}
-	Z_j[j] = sqrt(rchisq(k - j, rng));    
-	for (unsigned long i = j + 1; i < nrow; i++) {
-	    Z_j[i] = 0;
+	double *A_j = &A[j*nrow]; //jth column of A
+	A_j[j] = sqrt(rchisq(k - j, rng));
+	if (j + 1 < nrow) {
+	    rng->normal(A_j + j + 1, nrow - j - 1);
 	}
     }
 
-    // Z = Z %*% C 
+    // A = solve(t(L), A)
+    int ni = asInteger(nrow);
     double one = 1;
-    F77_DTRMM("R", "U", "N", "N", &ni, &ni, &one, &C[0], &ni, &Z[0], &ni);
+    F77_DTRSM("L", "L", "T", "N", &ni, &ni, &one, L, &ni, &A[0], &ni);
 
-    // X = t(Z) %*% Z
+    // X = A %*% t(A)
     double zero = 0;
-    F77_DSYRK("U", "T", &ni, &ni, &one, &Z[0], &ni, &zero, X, &ni);
+    F77_DSYRK("L", "N", &ni, &ni, &one, &A[0], &ni, &zero, X, &ni);
 
-    // Copy lower triangle of X from upper triangle
+    // Copy upper triangle of X from lower triangle
     for (unsigned long i = 0; i < nrow; ++i) {
 	for (unsigned long j = 0; j < i; ++j) {
-	    X[j * nrow + i] = X[i * nrow + j];
+	    X[i * nrow + j] = X[j * nrow + i];
 	}
     }
 }
@@ -136,7 +133,9 @@ void DWish::randomSample(double *x, unsigned long length,
 			 double const *lower, double const *upper,
 			 RNG *rng) const
 {
-    randomSample(x, length, SCALE(par), DF(par), NROW(dims), rng);
+    double ldet = 0;
+    double const *L = CholeskyCache::factor(SCALE(par), NROW(dims), ldet);
+    randomSampleChol(x, L, DF(par), NROW(dims), rng);
 }
 
 bool DWish::checkParameterDim (vector<vector<unsigned long> > const &dims) const
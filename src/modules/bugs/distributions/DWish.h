@@ -11,6 +11,9 @@ namespace bugs {
  * x[] ~ dwish(R[,], k)
  * </pre>
  * @short Wishart distribution
+ *
+ * The Cholesky factorisation of R is cached, so it is recalculated
+ * only when the value of R changes.
  */
 class DWish : public ArrayDist {
 public:
@@ -28,6 +31,18 @@ public:
   static void randomSample(double *x, unsigned long length,
                            double const *R, double k, unsigned long nrow,
                            RNG *rng);
+  /**
+   * Random sampler using the Bartlett decomposition
+   *
+   * @param x Array of length nrow squared that will hold the result
+   * @param L Lower triangular Cholesky factor of the parameter R. The
+   * upper triangle is not used.
+   * @param k Degrees of freedom
+   * @param nrow Number of rows of the matrix
+   * @param rng Random number generator
+   */
+  static void randomSampleChol(double *x, double const *L, double k,
+			       unsigned long nrow, RNG *rng);
   /**
    * Checks that R is a square matrix and k is a scalar
    */
@@ -46,6 +46,8 @@
 using std::string;
 using std::vector;
 using std::sqrt;
+using std::log;
+using std::fabs;
 using std::max;
 using std::min;
 using std::multiset;
@@ -802,3 +804,211 @@ void BugsDistTest::dkw()
     dkwtest(_dweib, mkPar(0.3, 0.5));
 }
     
+
+void BugsDistTest::mnorm()
+{
+    //Multivariate normal and t densities in two dimensions against
+    //closed form expressions. The Cholesky factorisation of the
+    //precision or variance matrix is cached, so we also check that
+    //the densities are correct after the matrix is modified in place.
+
+    vector<vector<unsigned long> > dims(2);
+    dims[0] = vector<unsigned long>(1, 2);
+    dims[1] = vector<unsigned long>(2, 2);
+    vector<vector<unsigned long> > tdims(dims);
+    tdims.push_back(vector<unsigned long>(1, 1));
+
+    double x[2] = {0.5, -1.2};
+    double mu[2] = {0.1, 0.3};
+    double Tau[4] = {2, 0.5, 0.5, 1};
+    double V[4];
+    double k = 4;
+
+    vector<double const *> par(2), vpar(2), tpar(3);
+    par[0] = vpar[0] = tpar[0] = mu;
+    par[1] = tpar[1] = Tau;
+    vpar[1] = V;
+    tpar[2] = &k;
+
+    for (unsigned int r = 0; r < 2; ++r) {
+	double detT = Tau[0] * Tau[3] - Tau[1] * Tau[2];
+	V[0] = Tau[3] / detT; V[3] = Tau[0] / detT;
+	V[1] = V[2] = -Tau[1] / detT;
+
+	double d0 = x[0] - mu[0], d1 = x[1] - mu[1];
+	double q = Tau[0] * d0 * d0 + 2 * Tau[1] * d0 * d1 + Tau[3] * d1 * d1;
+	double lnorm = -q/2 + log(detT)/2 - log(2 * M_PI);
+	double lt = -((k + 2)/2) * log(1 + q/k) + log(detT)/2 +
+	    lgammafn((k + 2)/2) - lgammafn(k/2) - log(k) - log(M_PI);
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(lnorm,
+	    _dmnorm->logDensity(x, 2, jags::PDF_FULL, par, dims, 0, 0), tol);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(lnorm,
+	    _dmnormvc->logDensity(x, 2, jags::PDF_FULL, vpar, dims, 0, 0),
+	    tol);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(lt,
+	    _dmt->logDensity(x, 2, jags::PDF_FULL, tpar, tdims, 0, 0), tol);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(-q/2,
+	    _dmnorm->logDensity(x, 2, jags::PDF_PRIOR, par, dims, 0, 0), tol);
+
+	//Modify in place
+	Tau[0] = 3; Tau[1] = Tau[2] = -0.8; Tau[3] = 0.5;
+    }
+
+    //Sample moments
+    unsigned int N = 10000;
+    double s0 = 0, s1 = 0, s00 = 0, s01 = 0, s11 = 0;
+    double y[2];
+    for (unsigned int i = 0; i < N; ++i) {
+	_dmnorm->randomSample(y, 2, par, dims, 0, 0, _rng);
+	double d0 = y[0] - mu[0], d1 = y[1] - mu[1];
+	s0 += d0; s1 += d1;
+	s00 += d0 * d0; s01 += d0 * d1; s11 += d1 * d1;
+    }
+    //Within 5 standard errors
+    CPPUNIT_ASSERT(fabs(s0/N) < 5 * sqrt(V[0]/N));
+    CPPUNIT_ASSERT(fabs(s1/N) < 5 * sqrt(V[3]/N));
+    CPPUNIT_ASSERT(fabs(s00/N - V[0]) < 5 * V[0] * sqrt(2.0/N));
+    CPPUNIT_ASSERT(fabs(s11/N - V[3]) < 5 * V[3] * sqrt(2.0/N));
+    CPPUNIT_ASSERT(fabs(s01/N - V[1]) < 5 * sqrt((V[0] * V[3] + V[1] * V[1])/N));
+}
+
+void BugsDistTest::wish()
+{
+    //Wishart density in two dimensions against the closed form
+    //expression, before and after modifying the cached scale matrix
+    //in place, then sample moments.
+
+    vector<vector<unsigned long> > dims(2);
+    dims[0] = vector<unsigned long>(2, 2);
+    dims[1] = vector<unsigned long>(1, 1);
+
+    double x[4] = {1.5, -0.3, -0.3, 0.8};
+    double R[4] = {2, 0.5, 0.5, 1};
+    double k = 5;
+    vector<double const *> par(2);
+    par[0] = R;
+    par[1] = &k;
+
+    double detx = x[0] * x[3] - x[1] * x[2];
+    for (unsigned int r = 0; r < 2; ++r) {
+	double detR = R[0] * R[3] - R[1] * R[2];
+	double tr = R[0] * x[0] + R[1] * x[1] + R[2] * x[2] + R[3] * x[3];
+	double lmgamma = log(M_PI)/2 + lgammafn(k/2) + lgammafn((k-1)/2);
+	double ld = ((k - 3) * log(detx) - tr + k * log(detR)
+		     - 2 * k * log(2.0))/2 - lmgamma;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(ld,
+	    _dwish->logDensity(x, 4, jags::PDF_FULL, par, dims, 0, 0), tol);
+
+	//Modify in place
+	R[0] = 1; R[1] = R[2] = -0.2; R[3] = 3;
+    }
+
+    //The mean is k * solve(R)
+    double detR = R[0] * R[3] - R[1] * R[2];
+    double S[4] = {R[3]/detR, -R[1]/detR, -R[2]/detR, R[0]/detR};
+    unsigned int N = 10000;
+    double sum[4] = {0, 0, 0, 0};
+    double y[4];
+    for (unsigned int i = 0; i < N; ++i) {
+	_dwish->randomSample(y, 4, par, dims, 0, 0, _rng);
+	CPPUNIT_ASSERT_EQUAL(y[1], y[2]);
+	for (unsigned int j = 0; j < 4; ++j) {
+	    sum[j] += y[j];
+	}
+    }
+    //Within 5 standard errors: var(X[i,j]) = k * (S[i,j]^2 + S[i,i]S[j,j])
+    for (unsigned int i = 0; i < 2; ++i) {
+	for (unsigned int j = 0; j < 2; ++j) {
+	    double s = S[i + 2*j];
+	    double var = k * (s * s + S[3*i] * S[3*j]);
+	    CPPUNIT_ASSERT(fabs(sum[i + 2*j]/N - k * s) < 5 * sqrt(var/N));
+	}
+    }
+}
+
+void BugsDistTest::countlik()
+{
+    //The likelihood of the binomial and negative binomial
+    //distributions uses a different calculation from the full
+    //density, so check that they agree
+
+    double pr[3] = {0.01, 0.3, 0.95};
+    double size[4] = {1, 7, 100, 5000};
+    for (unsigned int i = 0; i < 3; ++i) {
+	for (unsigned int j = 0; j < 4; ++j) {
+	    vector<double const *> par = mkPar(pr[i], size[j]);
+	    for (double x = 0; x <= size[j]; x += (size[j] > 100 ? 37 : 1)) {
+		double yfull = _dbin->d(x, jags::PDF_FULL, par, true);
+		double ylik = _dbin->d(x, jags::PDF_LIKELIHOOD, par, true);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(yfull, ylik, 
+					     1.0E-10 * max(1.0, fabs(yfull)));
+		yfull = _dnegbin->d(x, jags::PDF_FULL, par, true);
+		ylik = _dnegbin->d(x, jags::PDF_LIKELIHOOD, par, true);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(yfull, ylik, 
+					     1.0E-10 * max(1.0, fabs(yfull)));
+	    }
+	    CPPUNIT_ASSERT_EQUAL(JAGS_NEGINF,
+				 _dbin->d(size[j] + 1, jags::PDF_LIKELIHOOD,
+					  par, true));
+	}
+    }
+}
+
+void BugsDistTest::catsample()
+{
+    //Sample frequencies of categorical and multinomial distributions
+    //with enough categories to use an alias table, before and after
+    //modifying the probability vector in place.
+
+    unsigned long const K = 40;
+    double prob[K];
+    vector<double const *> par(2);
+    par[0] = prob;
+    vector<unsigned long> lengths(2);
+    lengths[0] = K;
+    lengths[1] = 1;
+
+    unsigned int N = 20000;
+    for (unsigned int r = 0; r < 2; ++r) {
+	//Unnormalized, with some categories of zero probability
+	double sump = 0;
+	for (unsigned long i = 0; i < K; ++i) {
+	    prob[i] = (i % 7 == 3) ? 0 : (r == 0 ? i + 1 : K - i);
+	    sump += prob[i];
+	}
+
+	vector<unsigned int> count(K, 0);
+	for (unsigned int j = 0; j < N; ++j) {
+	    double y;
+	    _dcat->randomSample(&y, 1, par, lengths, 0, 0, _rng);
+	    CPPUNIT_ASSERT(y >= 1 && y <= K);
+	    count[static_cast<unsigned long>(y) - 1]++;
+	}
+
+	double size = 10;
+	par[1] = &size;
+	double y[K];
+	for (unsigned int j = 0; j < N/10; ++j) {
+	    _dmulti->randomSample(y, K, par, lengths, 0, 0, _rng);
+	    double sumy = 0;
+	    for (unsigned long i = 0; i < K; ++i) {
+		sumy += y[i];
+		count[i] += y[i];
+	    }
+	    CPPUNIT_ASSERT_EQUAL(size, sumy);
+	}
+
+	//Within 5 standard errors
+	for (unsigned long i = 0; i < K; ++i) {
+	    double p = prob[i]/sump;
+	    if (p == 0) {
+		CPPUNIT_ASSERT_EQUAL(0U, count[i]);
+	    }
+	    else {
+		double n = 2 * N;
+		CPPUNIT_ASSERT(fabs(count[i]/n - p) < 5 * sqrt(p * (1 - p)/n));
+	    }
+	}
+    }
+}
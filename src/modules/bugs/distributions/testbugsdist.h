@@ -22,6 +22,10 @@ class BugsDistTest : public CppUnit::TestFixture, public JAGSFixture
     CPPUNIT_TEST( rscalar );
     CPPUNIT_TEST( kl );
     CPPUNIT_TEST( dkw );
+    CPPUNIT_TEST( mnorm );
+    CPPUNIT_TEST( wish );
+    CPPUNIT_TEST( countlik );
+    CPPUNIT_TEST( catsample );
     CPPUNIT_TEST_SUITE_END(  );
 
     jags::RNG *_rng;
@@ -85,6 +89,10 @@ class BugsDistTest : public CppUnit::TestFixture, public JAGSFixture
 
     void kl();
     void dkw();
+    void mnorm();
+    void wish();
+    void countlik();
+    void catsample();
 };
 
 #endif /* BUGS_DIST_TEST_H */
@@ -0,0 +1,271 @@
+#include "testbugsgrad.h"
+
+#include "DBern.h"
+#include "DBeta.h"
+#include "DBin.h"
+#include "DCat.h"
+#include "DDexp.h"
+#include "DDirch.h"
+#include "DExp.h"
+#include "DGamma.h"
+#include "DLnorm.h"
+#include "DLogis.h"
+#include "DMNorm.h"
+#include "DNorm.h"
+#include "DPois.h"
+#include "DT.h"
+#include "DUnif.h"
+
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+using std::vector;
+using std::fabs;
+using std::max;
+using std::string;
+
+using jags::ScalarDist;
+using jags::VectorDist;
+using jags::PDF_FULL;
+
+void BugsGradTest::setUp()
+{
+    _dbern = new jags::bugs::DBern();
+    _dbeta = new jags::bugs::DBeta();
+    _dbin = new jags::bugs::DBin();
+    _dcat = new jags::bugs::DCat();
+    _ddirch = new jags::bugs::DDirch();
+    _ddexp = new jags::bugs::DDexp();
+    _dexp = new jags::bugs::DExp();
+    _dgamma = new jags::bugs::DGamma();
+    _dlnorm = new jags::bugs::DLnorm();
+    _dlogis = new jags::bugs::DLogis();
+    _dmnorm = new jags::bugs::DMNorm();
+    _dnorm = new jags::bugs::DNorm();
+    _dpois = new jags::bugs::DPois();
+    _dt = new jags::bugs::DT();
+    _dunif = new jags::bugs::DUnif();
+}
+
+void BugsGradTest::tearDown()
+{
+    delete _dbern;
+    delete _dbeta;
+    delete _dbin;
+    delete _dcat;
+    delete _ddirch;
+    delete _ddexp;
+    delete _dexp;
+    delete _dgamma;
+    delete _dlnorm;
+    delete _dlogis;
+    delete _dmnorm;
+    delete _dnorm;
+    delete _dpois;
+    delete _dt;
+    delete _dunif;
+}
+
+/*
+   Step size for central differences, relative to the size of x, so
+   that truncation and rounding errors are both small compared with
+   the tolerance used in checkDeriv.
+*/
+static double fdStep(double x)
+{
+    return 1.0E-5 * max(1.0, fabs(x));
+}
+
+static void checkDeriv(string const &name, double deriv, double fd)
+{
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(name, fd, deriv,
+					 1.0E-6 * max(1.0, fabs(fd)));
+}
+
+void BugsGradTest::checkGrad(ScalarDist const *dist, double x,
+			     vector<double> const &par,
+			     vector<bool> const &fixed)
+{
+    unsigned int npar = par.size();
+    vector<double> p(par);
+    vector<double const *> pp(npar);
+    for (unsigned int i = 0; i < npar; ++i) {
+	pp[i] = &p[i];
+    }
+    CPPUNIT_ASSERT_MESSAGE(dist->name(), dist->checkParameterValue(pp));
+
+    double gx = 0;
+    vector<double> gpar(npar);
+    CPPUNIT_ASSERT_MESSAGE(dist->name(),
+			   dist->gradLogDensity(&gx, &gpar[0], x, pp, 0, 0));
+
+    if (!dist->isDiscreteValued(vector<bool>(npar, false))) {
+	double h = fdStep(x);
+	double fd = (dist->logDensity(x + h, PDF_FULL, pp, 0, 0) -
+		     dist->logDensity(x - h, PDF_FULL, pp, 0, 0)) / (2 * h);
+	checkDeriv(dist->name(), gx, fd);
+    }
+    for (unsigned int i = 0; i < npar; ++i) {
+	if (fixed[i]) continue;
+	double h = fdStep(par[i]);
+	p[i] = par[i] + h;
+	double lplus = dist->logDensity(x, PDF_FULL, pp, 0, 0);
+	p[i] = par[i] - h;
+	double lminus = dist->logDensity(x, PDF_FULL, pp, 0, 0);
+	p[i] = par[i];
+	checkDeriv(dist->name(), gpar[i], (lplus - lminus) / (2 * h));
+    }
+}
+
+void BugsGradTest::checkGrad(ScalarDist const *dist, double x,
+			     vector<double> const &par)
+{
+    checkGrad(dist, x, par, vector<bool>(par.size(), false));
+}
+
+void BugsGradTest::checkGrad(VectorDist const *dist, vector<double> const &x,
+			     vector<double> const &par)
+{
+    //Single parameter with the same length as x
+    unsigned long N = x.size();
+    vector<double> xp(x), p(par);
+    vector<double const *> pp(1, &p[0]);
+    vector<unsigned long> lengths(1, par.size());
+    CPPUNIT_ASSERT_MESSAGE(dist->name(),
+			   dist->checkParameterValue(pp, lengths));
+
+    vector<double> gx(N), gp(par.size());
+    vector<double *> gpar(1, &gp[0]);
+    CPPUNIT_ASSERT_MESSAGE(dist->name(),
+			   dist->gradLogDensity(&gx[0], gpar, &x[0], N, pp,
+						lengths, 0, 0));
+
+    if (!dist->isDiscreteValued(vector<bool>(1, false))) {
+	for (unsigned long i = 0; i < N; ++i) {
+	    double h = fdStep(x[i]);
+	    xp[i] = x[i] + h;
+	    double lplus = dist->logDensity(&xp[0], N, PDF_FULL, pp,
+					    lengths, 0, 0);
+	    xp[i] = x[i] - h;
+	    double lminus = dist->logDensity(&xp[0], N, PDF_FULL, pp,
+					     lengths, 0, 0);
+	    xp[i] = x[i];
+	    checkDeriv(dist->name(), gx[i], (lplus - lminus) / (2 * h));
+	}
+    }
+    for (unsigned long i = 0; i < par.size(); ++i) {
+	double h = fdStep(par[i]);
+	p[i] = par[i] + h;
+	double lplus = dist->logDensity(&x[0], N, PDF_FULL, pp, lengths, 0, 0);
+	p[i] = par[i] - h;
+	double lminus = dist->logDensity(&x[0], N, PDF_FULL, pp, lengths, 0, 0);
+	p[i] = par[i];
+	checkDeriv(dist->name(), gp[i], (lplus - lminus) / (2 * h));
+    }
+}
+
+void BugsGradTest::checkMNorm(vector<double> const &x,
+			      vector<double> const &mu,
+			      vector<double> &T)
+{
+    unsigned long m = x.size();
+    vector<double> xp(x), mup(mu);
+    vector<double const *> pp(2);
+    pp[0] = &mup[0];
+    pp[1] = &T[0];
+    vector<vector<unsigned long> > dims(2);
+    dims[0] = vector<unsigned long>(1, m);
+    dims[1] = vector<unsigned long>(2, m);
+
+    vector<double> gx(m), gmu(m), gT(m * m);
+    vector<double *> gpar(2);
+    gpar[0] = &gmu[0];
+    gpar[1] = &gT[0];
+    CPPUNIT_ASSERT(_dmnorm->gradLogDensity(&gx[0], gpar, &x[0], m, pp,
+					   dims, 0, 0));
+
+    for (unsigned long i = 0; i < m; ++i) {
+	double h = fdStep(x[i]);
+	xp[i] = x[i] + h;
+	double lplus = _dmnorm->logDensity(&xp[0], m, PDF_FULL, pp,
+					   dims, 0, 0);
+	xp[i] = x[i] - h;
+	double lminus = _dmnorm->logDensity(&xp[0], m, PDF_FULL, pp,
+					    dims, 0, 0);
+	xp[i] = x[i];
+	checkDeriv("dmnorm", gx[i], (lplus - lminus) / (2 * h));
+
+	h = fdStep(mu[i]);
+	mup[i] = mu[i] + h;
+	lplus = _dmnorm->logDensity(&x[0], m, PDF_FULL, pp, dims, 0, 0);
+	mup[i] = mu[i] - h;
+	lminus = _dmnorm->logDensity(&x[0], m, PDF_FULL, pp, dims, 0, 0);
+	mup[i] = mu[i];
+	checkDeriv("dmnorm", gmu[i], (lplus - lminus) / (2 * h));
+    }
+
+    /* 
+       The derivatives with respect to T are shared between the upper
+       and lower triangles, so we perturb T[i,j] and T[j,i] together
+       to keep T symmetric.
+    */
+    for (unsigned long j = 0; j < m; ++j) {
+	for (unsigned long i = j; i < m; ++i) {
+	    double Tij = T[i + m * j];
+	    double h = fdStep(Tij);
+	    T[i + m * j] = T[j + m * i] = Tij + h;
+	    double lplus = _dmnorm->logDensity(&x[0], m, PDF_FULL, pp,
+					       dims, 0, 0);
+	    T[i + m * j] = T[j + m * i] = Tij - h;
+	    double lminus = _dmnorm->logDensity(&x[0], m, PDF_FULL, pp,
+						dims, 0, 0);
+	    T[i + m * j] = T[j + m * i] = Tij;
+	    double deriv = gT[i + m * j];
+	    if (i != j) deriv += gT[j + m * i];
+	    checkDeriv("dmnorm", deriv, (lplus - lminus) / (2 * h));
+	}
+    }
+}
+
+void BugsGradTest::scalardist()
+{
+    checkGrad(_dbern, 0, {0.3});
+    checkGrad(_dbern, 1, {0.3});
+    checkGrad(_dbeta, 0.3, {2.5, 1.5});
+    checkGrad(_dbin, 3, {0.4, 10}, {false, true});
+    checkGrad(_ddexp, 0.7, {-0.2, 1.8});
+    checkGrad(_ddexp, -1.2, {0.5, 0.3});
+    checkGrad(_dexp, 2.1, {0.6});
+    checkGrad(_dgamma, 1.3, {2.5, 1.7});
+    checkGrad(_dlnorm, 2.2, {0.4, 1.5});
+    checkGrad(_dlogis, -0.8, {0.3, 2.0});
+    checkGrad(_dnorm, 1.4, {-0.5, 2.5});
+    checkGrad(_dpois, 4, {2.7});
+    checkGrad(_dt, 1.1, {0.2, 1.6, 3.5});
+    checkGrad(_dt, -5.0, {0.0, 0.5, 30});
+    checkGrad(_dunif, 0.5, {-1.0, 2.0});
+}
+
+void BugsGradTest::vectordist()
+{
+    checkGrad(_dcat, {2}, {0.2, 0.5, 0.3});
+    checkGrad(_dcat, {1}, {1.0, 3.0, 2.0, 4.0});
+    checkGrad(_ddirch, {0.2, 0.5, 0.3}, {1.5, 2.0, 0.7});
+}
+
+void BugsGradTest::mnorm()
+{
+    vector<double> x = {1.0, -0.5, 0.3};
+    vector<double> mu = {0.2, 0.1, -0.4};
+    vector<double> T = {2.0, 0.5, 0.3,
+			0.5, 1.5, -0.2,
+			0.3, -0.2, 1.0};
+    checkMNorm(x, mu, T);
+    //The inverse of T is cached. Repeat with the same T, then change
+    //the values of T in place, so that the cached inverse is stale.
+    checkMNorm(x, mu, T);
+    T[0] = T[4] = 3.0;
+    T[1] = T[3] = -0.7;
+    checkMNorm(x, mu, T);
+}
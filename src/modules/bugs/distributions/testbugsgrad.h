@@ -0,0 +1,65 @@
+#ifndef BUGS_GRAD_TEST_H
+#define BUGS_GRAD_TEST_H
+
+namespace jags {
+    class ScalarDist;
+    class VectorDist;
+    class ArrayDist;
+}
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+#include <vector>
+
+/**
+ * Checks the derivatives of the log density returned by
+ * gradLogDensity against finite differences of logDensity.
+ */
+class BugsGradTest : public CppUnit::TestFixture, public JAGSFixture
+{
+
+    CPPUNIT_TEST_SUITE( BugsGradTest );
+    CPPUNIT_TEST( scalardist );
+    CPPUNIT_TEST( vectordist );
+    CPPUNIT_TEST( mnorm );
+    CPPUNIT_TEST_SUITE_END(  );
+
+    jags::ScalarDist *_dbern;
+    jags::ScalarDist *_dbeta;
+    jags::ScalarDist *_dbin;
+    jags::VectorDist *_dcat;
+    jags::VectorDist *_ddirch;
+    jags::ScalarDist *_ddexp;
+    jags::ScalarDist *_dexp;
+    jags::ScalarDist *_dgamma;
+    jags::ScalarDist *_dlnorm;
+    jags::ScalarDist *_dlogis;
+    jags::ArrayDist *_dmnorm;
+    jags::ScalarDist *_dnorm;
+    jags::ScalarDist *_dpois;
+    jags::ScalarDist *_dt;
+    jags::ScalarDist *_dunif;
+
+    void checkGrad(jags::ScalarDist const *dist, double x,
+		   std::vector<double> const &par,
+		   std::vector<bool> const &fixed);
+    void checkGrad(jags::ScalarDist const *dist, double x,
+		   std::vector<double> const &par);
+    void checkGrad(jags::VectorDist const *dist,
+		   std::vector<double> const &x,
+		   std::vector<double> const &par);
+    void checkMNorm(std::vector<double> const &x,
+		    std::vector<double> const &mu,
+		    std::vector<double> &T);
+
+  public:
+    void setUp();
+    void tearDown();
+
+    void scalardist();
+    void vectordist();
+    void mnorm();
+};
+
+#endif /* BUGS_GRAD_TEST_H */
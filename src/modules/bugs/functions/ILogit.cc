@@ -7,6 +7,7 @@
 using std::vector;
 using std::exp;
 using std::log;
+using std::fabs;
 
 namespace jags {
 namespace bugs {
@@ -28,8 +29,11 @@ namespace bugs {
 
     double ILogit::grad(double eta) const
     {
-	double opexp = 1 + exp(eta);
-	return exp(eta) / (opexp * opexp);
+	//The derivative is symmetric in eta. Using exp(-|eta|) avoids
+	//overflow for large |eta|
+	double e = exp(-fabs(eta));
+	double ope = 1 + e;
+	return e / (ope * ope);
     }
 
 }}
@@ -19,6 +19,12 @@ namespace bugs {
 	return log(*args[0]);
     }
 
+    bool Log::gradient(double *grad, vector<double const *> const &args) const
+    {
+	grad[0] = 1 / *args[0];
+	return true;
+    }
+
     bool Log::checkParameterValue(vector<double const *> const &args) const
     {
 	return *args[0] >= 0;
@@ -15,7 +15,7 @@ namespace bugs {
 
     double LogFact::evaluate(vector<double const *> const &args) const
     {
-	return lgammafn(*args[0] + 1);
+	return lfactorial(*args[0]);
     }
 
     bool LogFact::checkParameterValue(vector<double const *> const &args) const
@@ -19,6 +19,13 @@ namespace bugs {
 	return log(arg) - log(1 - arg);
     }
 
+    bool Logit::gradient(double *grad, vector<double const *> const &args) const
+    {
+	double arg = *args[0];
+	grad[0] = 1 / (arg * (1 - arg));
+	return true;
+    }
+
     bool Logit::checkParameterValue (vector <double const *> const &args) const
     {
 	double arg = *args[0];
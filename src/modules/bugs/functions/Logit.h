@@ -19,6 +19,8 @@ namespace bugs {
     public:
 	Logit();
 	double evaluate(std::vector <double const *> const &args) const;
+	bool gradient(double *grad,
+		      std::vector<double const *> const &args) const;
 	bool checkParameterValue(std::vector<double const *> const &args) const;
     };
 
@@ -8,6 +8,13 @@
 
 using std::vector;
 
+/*
+  Products with no more than this number of multiplications are
+  calculated directly. For small matrices this is much faster than
+  calling DGEMM.
+*/
+#define SMALL_PRODUCT 512
+
 namespace jags {
 namespace bugs {
 
@@ -39,9 +46,31 @@ namespace bugs {
 	    d3 = asInteger(dims[1][1]);
 	}
     
-	double one = 1, zero = 0;
-	F77_DGEMM ("N", "N", &d1, &d3, &d2, &one,
-		   args[0], &d1, args[1], &d2, &zero, value, &d1);
+	//The number of multiplications is calculated in double
+	//precision, as the product of the dimensions may overflow
+	if (static_cast<double>(d1) * d2 * d3 <= SMALL_PRODUCT) {
+	    //Same order of operations as the reference DGEMM
+	    double const *A = args[0];
+	    double const *B = args[1];
+	    for (int j = 0; j < d3; ++j) {
+		double *Cj = value + d1 * j;
+		for (int i = 0; i < d1; ++i) {
+		    Cj[i] = 0;
+		}
+		for (int l = 0; l < d2; ++l) {
+		    double b = B[l + d2 * j];
+		    double const *Al = A + d1 * l;
+		    for (int i = 0; i < d1; ++i) {
+			Cj[i] += b * Al[i];
+		    }
+		}
+	    }
+	}
+	else {
+	    double one = 1, zero = 0;
+	    F77_DGEMM ("N", "N", &d1, &d3, &d2, &one,
+		       args[0], &d1, args[1], &d2, &zero, value, &d1);
+	}
     }
 
     vector<unsigned long> 
@@ -18,6 +18,12 @@ namespace bugs {
 	return sqrt(*args[0]);
     }
 
+    bool Sqrt::gradient(double *grad, vector<double const *> const &args) const
+    {
+	grad[0] = 0.5 / sqrt(*args[0]);
+	return true;
+    }
+
     bool Sqrt::checkParameterValue(vector<double const *> const &args) const
     {
 	return *args[0] >= 0;
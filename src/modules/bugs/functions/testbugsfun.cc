@@ -724,6 +724,13 @@ void BugsFunTest::math()
     CPPUNIT_ASSERT_DOUBLES_EQUAL(log(6.0), eval(_loggam, 4), tol);
     CPPUNIT_ASSERT_DOUBLES_EQUAL(log(24.0), eval(_logfact, 4), tol);
     CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, eval(_sqrt, 4), tol);
+
+    //Log factorials are tabulated for small integers
+    double xfact[8] = {2.5, 10, 1023, 1024, 1025, 65535, 65536, 1e6};
+    for (unsigned int i = 0; i < 8; ++i) {
+	double y = eval(_loggam, xfact[i] + 1);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(y, eval(_logfact, xfact[i]), tol * y);
+    }
 }
 
 void BugsFunTest::lossy()
@@ -1044,6 +1051,49 @@ void BugsFunTest::matrix()
 	    CPPUNIT_ASSERT_DOUBLES_EQUAL(A[i], tA[i], tol);
 	}
     }
+
+    /* 
+       Matrices of the form a * I + c * J, where J is a matrix of
+       ones, have a known inverse and determinant. Sizes on both sides
+       of the threshold for the small matrix algorithms are used.
+    */
+    double a = 1.5, c = 0.7;
+    for (unsigned int n = 1; n < 13; ++n) {
+	vector<double> A(n*n, c);
+	for (unsigned int i = 0; i < n; ++i) {
+	    A[i + n*i] += a;
+	}
+	vector<double const *> argA(1, &A[0]);
+	vector<unsigned long> dA(2, n);
+	vector<vector<unsigned long> > dimA(1, dA);
+
+	double logdetA;
+	_logdet->evaluate(&logdetA, argA, dimA);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL((n - 1) * log(a) + log(a + n * c),
+				     logdetA, tol);
+
+	vector<double> invA(n*n);
+	_inverse->evaluate(&invA[0], argA, dimA);
+	for (unsigned int i = 0; i < n; ++i) {
+	    for (unsigned int j = 0; j < n; ++j) {
+		double x = - c / (a * (a + n * c));
+		if (i == j) x += 1 / a;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(x, invA[i + n*j], tol);
+	    }
+	}
+	
+	vector<double const *> argAA(2);
+	argAA[0] = &A[0];
+	argAA[1] = &invA[0];
+	vector<vector<unsigned long> > dimAA(2, dA);
+	vector<double> I(n*n);
+	_matmult->evaluate(&I[0], argAA, dimAA);
+	for (unsigned int i = 0; i < n; ++i) {
+	    for (unsigned int j = 0; j < n; ++j) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(i == j ? 1 : 0, I[i + n*j], tol);
+	    }
+	}
+    }
 }
 
 void BugsFunTest::inprod()
@@ -1264,3 +1314,25 @@ void BugsFunTest::rep() {
     
     //CPPUNIT_FAIL("rep");
 }
+
+void BugsFunTest::gradient()
+{
+    //Analytic derivatives must agree with finite differences
+    double x[3] = {0.05, 0.5, 3.7};
+    for (unsigned int i = 0; i < 3; ++i) {
+	checkGradient(_log, vector<double>(1, x[i]));
+	checkGradient(_sqrt, vector<double>(1, x[i]));
+    }
+    double p[3] = {0.02, 0.5, 0.9};
+    for (unsigned int i = 0; i < 3; ++i) {
+	checkGradient(_logit, vector<double>(1, p[i]));
+    }
+
+    //Link functions provide the derivative of the inverse link
+    double eta[5] = {-800, -2.5, 0, 1.3, 800};
+    for (unsigned int i = 0; i < 5; ++i) {
+	checkGradient(_exp, eta[i] / 10);
+	checkGradient(_ilogit, eta[i]);
+	checkGradient(_phi, eta[i] / 10);
+    }
+}
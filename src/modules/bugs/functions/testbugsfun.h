@@ -40,6 +40,7 @@ class BugsFunTest : public CppUnit::TestFixture, public JAGSFixture
     CPPUNIT_TEST( discrete );
     CPPUNIT_TEST( combine );
     CPPUNIT_TEST( rep );
+    CPPUNIT_TEST( gradient );
     CPPUNIT_TEST_SUITE_END();
 
     jags::ScalarFunction *_abs;
@@ -157,6 +158,7 @@ class BugsFunTest : public CppUnit::TestFixture, public JAGSFixture
     void interplin();
     void combine();
     void rep();
+    void gradient();
 };
 
 #endif  // BUGS_FUN_TEST_H
@@ -0,0 +1,106 @@
+#include <config.h>
+
+#include "CholeskyCache.h"
+#include "lapack.h"
+
+#include <module/ModuleError.h>
+#include <util/integer.h>
+#include <util/ValueCache.h>
+
+#include <vector>
+#include <cmath>
+
+using std::vector;
+using std::log;
+
+//Maximum number of bytes held by the cache of each thread
+#define MAX_CACHE_SIZE 8388608
+
+namespace {
+
+    struct CholEntry {
+	vector<double> L;
+	vector<double> Ainv;
+	double logdet;
+    };
+
+    thread_local jags::ValueCache<CholEntry> cache(MAX_CACHE_SIZE);
+
+    /*
+      Returns the cache entry for A, calculating the Cholesky factor
+      if A is not in the cache
+    */
+    CholEntry &getEntry(double const *A, unsigned long n)
+    {
+	unsigned long N = n * n;
+
+	CholEntry *p = cache.find(A, N);
+	if (p) {
+	    return *p;
+	}
+
+	CholEntry &entry = cache.insert(A, N);
+	entry.Ainv.clear();
+	entry.L.assign(A, A + N);
+
+	int info = 0;
+	int ni = jags::asInteger(n);
+	F77_DPOTRF("L", &ni, &entry.L[0], &ni, &info);
+	if (info != 0) {
+	    cache.erase(A);
+	    if (info < 0) {
+		jags::throwLogicError("Illegal argument in CholeskyCache");
+	    }
+	    jags::throwRuntimeError("Non positive definite matrix in "
+				    "CholeskyCache");
+	}
+
+	entry.logdet = 0;
+	for (unsigned long i = 0; i < n; ++i) {
+	    entry.logdet += 2 * log(entry.L[i + n * i]);
+	    for (unsigned long j = 0; j < i; ++j) {
+		entry.L[j + n * i] = 0;
+	    }
+	}
+	cache.charge(A, N * sizeof(double));
+	return entry;
+    }
+
+}
+
+namespace jags {
+namespace bugs {
+
+double const *
+CholeskyCache::factor(double const *A, unsigned long n, double &logdet)
+{
+    CholEntry &entry = getEntry(A, n);
+    logdet = entry.logdet;
+    return &entry.L[0];
+}
+
+double const *
+CholeskyCache::inverse(double const *A, unsigned long n)
+{
+    CholEntry &entry = getEntry(A, n);
+    if (entry.Ainv.empty()) {
+	entry.Ainv = entry.L;
+	int info = 0;
+	int ni = asInteger(n);
+	F77_DPOTRI("L", &ni, &entry.Ainv[0], &ni, &info);
+	if (info != 0) {
+	    entry.Ainv.clear();
+	    throwRuntimeError("Cannot invert matrix in CholeskyCache");
+	}
+	//Copy lower to upper triangle
+	for (unsigned long i = 0; i < n; ++i) {
+	    for (unsigned long j = 0; j < i; ++j) {
+		entry.Ainv[j + n * i] = entry.Ainv[i + n * j];
+	    }
+	}
+	cache.charge(A, n * n * sizeof(double));
+    }
+    return &entry.Ainv[0];
+}
+
+}}
@@ -0,0 +1,58 @@
+#ifndef CHOLESKY_CACHE_H_
+#define CHOLESKY_CACHE_H_
+
+namespace jags {
+namespace bugs {
+
+/**
+ * @short Cache of Cholesky factorisations of parameter matrices
+ *
+ * CholeskyCache keeps the Cholesky factor and log determinant of
+ * recently used symmetric positive definite matrices in a ValueCache
+ * for each thread, so the factorisation of a fixed parameter matrix
+ * is calculated once. The inverse is calculated on demand and stored
+ * in the same entry.
+ */
+class CholeskyCache {
+  public:
+    /**
+     * Returns the Cholesky factor of a symmetric positive definite
+     * matrix. A runtime error is thrown if the matrix is not positive
+     * definite.
+     *
+     * @param A Pointer to an array containing the matrix. Only the
+     * lower triangle (in column-major order) is used.
+     *
+     * @param n Number of rows or columns in the matrix
+     *
+     * @param logdet Log determinant of the matrix, on exit
+     *
+     * @return Pointer to an array of length n squared holding the
+     * lower triangular factor L, such that A = L %*% t(L), with zeros
+     * in the upper triangle. It remains valid until the next call
+     * from the same thread.
+     */
+    static double const *factor(double const *A, unsigned long n,
+				double &logdet);
+    /**
+     * Returns the inverse of a symmetric positive definite matrix,
+     * calculated from its cached Cholesky factor. The inverse is
+     * stored in the same cache entry as the factor, so it is
+     * calculated once for a fixed matrix. A runtime error is thrown
+     * if the matrix is not positive definite.
+     *
+     * @param A Pointer to an array containing the matrix. Only the
+     * lower triangle (in column-major order) is used.
+     *
+     * @param n Number of rows or columns in the matrix
+     *
+     * @return Pointer to an array of length n squared holding the
+     * full inverse matrix. It remains valid until the next call from
+     * the same thread.
+     */
+    static double const *inverse(double const *A, unsigned long n);
+};
+
+}}
+
+#endif /* CHOLESKY_CACHE_H_ */
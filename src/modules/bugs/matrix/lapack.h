@@ -21,6 +21,9 @@
 #define F77_DTRTRI F77_FUNC(dtrtri, DTRTRI)
 #define F77_DTRMM  F77_FUNC(dtrmm, DTRMM)
 #define F77_DSYRK  F77_FUNC(dsyrk, DSYRK)
+#define F77_DTRSV  F77_FUNC(dtrsv, DTRSV)
+#define F77_DTRMV  F77_FUNC(dtrmv, DTRMV)
+#define F77_DTRSM  F77_FUNC(dtrsm, DTRSM)
     
 extern "C" {
 /*
@@ -106,6 +109,19 @@ extern "C" {
 		   const int *k,
 		   const double *alpha, const double *a, const int *lda,
 		   const double *beta, double *c, const int *ldc);
+
+    void F77_DTRSV(const char *uplo, const char *trans, const char *diag,
+		   const int *n, const double *a, const int *lda,
+		   double *x, const int *incx);
+
+    void F77_DTRMV(const char *uplo, const char *trans, const char *diag,
+		   const int *n, const double *a, const int *lda,
+		   double *x, const int *incx);
+
+    void F77_DTRSM(const char *side, const char *uplo, const char *transa,
+		   const char *diag, const int *m, const int *n,
+		   const double *alpha, const double *a, const int *lda,
+		   double *b, const int *ldb);
 }
 
 #endif
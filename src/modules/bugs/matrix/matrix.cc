@@ -12,49 +12,197 @@
 #include "matrix.h"
 
 using std::log;
+using std::sqrt;
 using std::fabs;
 using std::copy;
 using std::vector;
+using std::swap;
+
+/*
+  Matrices up to this size are factorized and inverted with the
+  unblocked algorithms below, on arrays allocated on the stack. For
+  such small matrices, the overhead of calling LAPACK - and of
+  allocating workspace - dominates the cost of the arithmetic.
+*/
+#define SMALL_MATRIX 8
+
+namespace {
+
+    /*
+      Cholesky factorization of the n x n matrix A in place. Only the
+      lower triangle is used and overwritten.  Returns false if A is
+      not positive definite.
+    */
+    bool chol_small(double *A, unsigned long n)
+    {
+	for (unsigned long j = 0; j < n; ++j) {
+	    double d = A[j + n * j];
+	    for (unsigned long k = 0; k < j; ++k) {
+		d -= A[j + n * k] * A[j + n * k];
+	    }
+	    if (!(d > 0)) return false;
+	    d = sqrt(d);
+	    A[j + n * j] = d;
+	    for (unsigned long i = j + 1; i < n; ++i) {
+		double s = A[i + n * j];
+		for (unsigned long k = 0; k < j; ++k) {
+		    s -= A[i + n * k] * A[j + n * k];
+		}
+		A[i + n * j] = s / d;
+	    }
+	}
+	return true;
+    }
+
+    /*
+      Inverts the n x n symmetric positive definite matrix A, putting
+      the result in X. Returns false if A is not positive definite.
+    */
+    bool inverse_chol_small(double *X, double const *A, unsigned long n)
+    {
+	double L[SMALL_MATRIX * SMALL_MATRIX];
+	copy(A, A + n * n, L);
+	if (!chol_small(L, n)) return false;
+
+	//Inverse of the lower triangular factor, by columns
+	double W[SMALL_MATRIX * SMALL_MATRIX];
+	for (unsigned long j = 0; j < n; ++j) {
+	    W[j + n * j] = 1 / L[j + n * j];
+	    for (unsigned long i = j + 1; i < n; ++i) {
+		double s = 0;
+		for (unsigned long k = j; k < i; ++k) {
+		    s -= L[i + n * k] * W[k + n * j];
+		}
+		W[i + n * j] = s / L[i + n * i];
+	    }
+	}
+
+	//X = t(W) %*% W
+	for (unsigned long j = 0; j < n; ++j) {
+	    for (unsigned long i = j; i < n; ++i) {
+		double s = 0;
+		for (unsigned long k = i; k < n; ++k) {
+		    s += W[k + n * i] * W[k + n * j];
+		}
+		X[i + n * j] = X[j + n * i] = s;
+	    }
+	}
+	return true;
+    }
+
+    /*
+      Inverts the n x n matrix A by Gaussian elimination with partial
+      pivoting, putting the result in X. Returns false if A is
+      singular.
+    */
+    bool inverse_lu_small(double *X, double const *A, unsigned long n)
+    {
+	double B[SMALL_MATRIX * SMALL_MATRIX];
+	copy(A, A + n * n, B);
+	for (unsigned long i = 0; i < n * n; ++i) {
+	    X[i] = 0;
+	}
+	for (unsigned long i = 0; i < n; ++i) {
+	    X[i + n * i] = 1;
+	}
+
+	for (unsigned long k = 0; k < n; ++k) {
+	    unsigned long p = k;
+	    for (unsigned long i = k + 1; i < n; ++i) {
+		if (fabs(B[i + n * k]) > fabs(B[p + n * k])) p = i;
+	    }
+	    if (B[p + n * k] == 0) return false;
+	    if (p != k) {
+		for (unsigned long j = 0; j < n; ++j) {
+		    swap(B[k + n * j], B[p + n * j]);
+		    swap(X[k + n * j], X[p + n * j]);
+		}
+	    }
+	    for (unsigned long i = k + 1; i < n; ++i) {
+		double f = B[i + n * k] / B[k + n * k];
+		for (unsigned long j = k + 1; j < n; ++j) {
+		    B[i + n * j] -= f * B[k + n * j];
+		}
+		for (unsigned long j = 0; j < n; ++j) {
+		    X[i + n * j] -= f * X[k + n * j];
+		}
+	    }
+	}
+
+	//Back substitution
+	for (unsigned long j = 0; j < n; ++j) {
+	    for (unsigned long k = n; k-- > 0; ) {
+		double s = X[k + n * j];
+		for (unsigned long l = k + 1; l < n; ++l) {
+		    s -= B[k + n * l] * X[l + n * j];
+		}
+		X[k + n * j] = s / B[k + n * k];
+	    }
+	}
+	return true;
+    }
+
+}
 
 namespace jags {
 namespace bugs {
 
 double logdet(double const *a, unsigned long n)
 {
-   // Log determinant of n x n symmetric positive-definite matrix a */
+  // Log determinant of n x n symmetric positive-definite matrix a,
+  // from the diagonal of its Cholesky factor
+
+  if (n <= SMALL_MATRIX) {
+      double L[SMALL_MATRIX * SMALL_MATRIX];
+      copy(a, a + n * n, L);
+      if (!chol_small(L, n)) {
+	  throwRuntimeError("Non positive definite matrix in call to logdet");
+      }
+      double logdet = 0;
+      for (unsigned long i = 0; i < n; i++) {
+	  logdet += 2 * log(L[i + n * i]);
+      }
+      return logdet;
+  }
   
   unsigned long N = n*n;
   vector <double> acopy(N);
   copy(a, a + N, acopy.begin());
 
-  vector<double> w(n);
-  int lwork = -1;
-  double worktest = 0;
   int info = 0;
   int ni = asInteger(n);
-  F77_DSYEV("N","L", &ni, &acopy[0], &ni, &w[0], &worktest, &lwork, &info);
-  if (info != 0) {
-    throwRuntimeError("unable to calculate workspace size for dsyev");
+  F77_DPOTRF("L", &ni, &acopy[0], &ni, &info);
+  if (info < 0) {
+    throwLogicError("Illegal argument in logdet");
   }
-  lwork = static_cast<int>(worktest);
-  vector<double> work(lwork);
-  F77_DSYEV("N","L", &ni, &acopy[0], &ni, &w[0], &work[0], &lwork, &info);
-  if (info != 0) {
-    throwRuntimeError("unable to calculate eigenvalues in dsyev");
-  }
-
-  if (w[0] <= 0) {
-      throwRuntimeError("Non positive definite matrix in call to logdet");
+  else if (info > 0) {
+    throwRuntimeError("Non positive definite matrix in call to logdet");
   }
 
   double logdet = 0;
   for (unsigned long i = 0; i < n; i++) {
-    logdet += log(w[i]);
+    logdet += 2 * log(acopy[i + n * i]);
   }
 
   return logdet;
 }
 
+void chol_update(double *L, double *v, unsigned long n)
+{
+    /* Sequence of Givens rotations, as in LINPACK dchud */
+    for (unsigned long k = 0; k < n; ++k) {
+	double *Lk = L + k * n; //kth column of L
+	double r = sqrt(Lk[k] * Lk[k] + v[k] * v[k]);
+	double c = r / Lk[k];
+	double s = v[k] / Lk[k];
+	Lk[k] = r;
+	for (unsigned long i = k + 1; i < n; ++i) {
+	    Lk[i] = (Lk[i] + s * v[i]) / c;
+	    v[i] = c * v[i] - s * Lk[i];
+	}
+    }
+}
+
 bool check_symmetric_ispd(double const *a, unsigned long n)
 {
     /* Checks that an n x n symmetric matrix is positive definite.
@@ -144,6 +292,13 @@ bool inverse_chol (double *X, double const *A, unsigned long n)
 {
     /* invert n x n symmetric positive definite matrix A. Put result in X*/
     //FIXME: This needs testing after being rewritten
+
+    if (n <= SMALL_MATRIX) {
+	if (!inverse_chol_small(X, A, n)) {
+	    throwRuntimeError("Cannot invert matrix: not positive definite");
+	}
+	return true;
+    }
     
     unsigned long N = n*n;
     copy(A, A + N, X);
@@ -177,6 +332,10 @@ bool inverse_lu (double *X, double const *A, unsigned long n)
 {
     /* invert n x n matrix A. Put result in X */
 
+    if (n <= SMALL_MATRIX) {
+	return inverse_lu_small(X, A, n);
+    }
+
     unsigned long N = n*n;
     vector<double> Acopy(N);
     copy(A, A + N, Acopy.begin());
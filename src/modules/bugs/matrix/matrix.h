@@ -5,7 +5,9 @@ namespace jags {
 namespace bugs {
 
 /**
- * Inverts a general square matrix using the LAPACK routine DGESV
+ * Inverts a general square matrix using the LAPACK routine DGESV.
+ * Small matrices are inverted directly by Gaussian elimination with
+ * partial pivoting.
  *
  * @param X Pointer to an array of length n squared, which will contain
  * the inverse on exit.
@@ -18,7 +20,8 @@ bool inverse_lu (double *X, double const *A, unsigned long n);
 
 /**
  * Inverts a symmetrix positive definite matrix by Cholesky
- * decomposition using the LAPACK routines DPOTRF and DPOTRI.
+ * decomposition using the LAPACK routines DPOTRF and DPOTRI. Small
+ * matrices are factorized and inverted directly.
  * 
  * @param X Pointer to an array of length n squared, which will contain
  * the inverse on exit.
@@ -40,6 +43,21 @@ bool inverse_chol (double *X, double const *A, unsigned long n);
  */
 double logdet(double const *A, unsigned long n);
 
+/**
+ * Rank one update of a Cholesky factorization. If L is the lower
+ * triangular Cholesky factor of A, then on exit it is the Cholesky
+ * factor of A + v %*% t(v).
+ *
+ * @param L pointer to an array of length n squared containing the
+ * factor in its lower triangle (in column-major order). The upper
+ * triangle is not used.
+ *
+ * @param v pointer to an array of length n, which is overwritten
+ *
+ * @param n number of rows or columns in the matrix
+ */
+void chol_update(double *L, double *v, unsigned long n);
+
 }}
 
 #endif /* MATRIX_H_ */
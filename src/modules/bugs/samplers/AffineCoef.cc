@@ -0,0 +1,135 @@
+#include <config.h>
+
+#include "AffineCoef.h"
+
+#include <graph/StochasticNode.h>
+#include <graph/DeterministicNode.h>
+#include <sampler/Linear.h>
+#include <sampler/SingletonGraphView.h>
+#include <module/ModuleError.h>
+#include <util/nainf.h>
+
+#include <set>
+
+using std::vector;
+using std::set;
+
+namespace jags {
+namespace bugs {
+
+static bool isPureScale(SingletonGraphView const *gv)
+{
+    //Scale mixtures are allowed by checkScale, but then a parameter
+    //may not depend on the sampled node at all, so we cannot
+    //calculate the coefficient as a ratio.
+    vector<DeterministicNode *> const &dnodes = gv->deterministicChildren();
+    set<Node const*> ancestors;
+    ancestors.insert(gv->node());
+    for (unsigned int j = 0; j < dnodes.size(); ++j) {
+	if (!dnodes[j]->isClosed(ancestors, DNODE_SCALE, false)) {
+	    return false;
+	}
+	ancestors.insert(dnodes[j]);
+    }
+    return true;
+}
+
+AffineCoef::AffineCoef(SingletonGraphView const *gv,
+		       vector<unsigned int> const &param, bool scale)
+    : _gv(gv), _param(param), _length(0), _scale(scale && isPureScale(gv))
+{
+    vector<StochasticNode *> const &children = gv->stochasticChildren();
+    if (param.size() != children.size()) {
+	throwLogicError("Invalid parameter vector in AffineCoef");
+    }
+    for (unsigned int i = 0; i < children.size(); ++i) {
+	_length += children[i]->parents()[param[i]]->length();
+    }
+
+    bool fixed = scale ? checkScale(gv, true) : checkLinear(gv, true);
+    if (fixed) {
+	//One-off calculation of fixed coefficients
+	_coef.resize(_length);
+	double xold = gv->node()->value(0)[0];
+	calculate(&_coef[0], 0);
+	gv->setValue(&xold, 1, 0);
+    }
+}
+
+void AffineCoef::calculate(double *coef, unsigned int chain) const
+{
+    vector<StochasticNode *> const &children = _gv->stochasticChildren();
+    const double xold = _gv->node()->value(chain)[0];
+
+    if (_scale && xold != 0) {
+	double *cp = coef;
+	for (unsigned int i = 0; i < children.size(); ++i) {
+	    Node const *par = children[i]->parents()[_param[i]];
+	    double const *v = par->value(chain);
+	    for (unsigned long j = 0; j < par->length(); ++j) {
+		cp[j] = v[j] / xold;
+	    }
+	    cp += par->length();
+	}
+	return;
+    }
+
+    //Shift x by one unit, unless the support of the sampled node is
+    //too narrow, in which case we take a smaller step towards the
+    //centre of the support
+    double lower = JAGS_NEGINF, upper = JAGS_POSINF;
+    _gv->node()->support(&lower, &upper, 1, chain);
+    double delta = 1;
+    if (upper - lower < 2) {
+	delta = 0.4 * (upper - lower);
+	if (xold > (lower + upper) / 2) delta = -delta;
+    }
+    else if (xold + 1 > upper) {
+	delta = -1;
+    }
+
+    double *cp = coef;
+    for (unsigned int i = 0; i < children.size(); ++i) {
+	Node const *par = children[i]->parents()[_param[i]];
+	double const *v = par->value(chain);
+	for (unsigned long j = 0; j < par->length(); ++j) {
+	    cp[j] = -v[j];
+	}
+	cp += par->length();
+    }
+
+    double xnew = xold + delta;
+    _gv->setValue(&xnew, 1, chain);
+
+    cp = coef;
+    for (unsigned int i = 0; i < children.size(); ++i) {
+	Node const *par = children[i]->parents()[_param[i]];
+	double const *v = par->value(chain);
+	for (unsigned long j = 0; j < par->length(); ++j) {
+	    cp[j] = (cp[j] + v[j]) / delta;
+	}
+	cp += par->length();
+    }
+}
+
+unsigned long AffineCoef::length() const
+{
+    return _length;
+}
+
+bool AffineCoef::isFixed() const
+{
+    return !_coef.empty();
+}
+
+double const *AffineCoef::coef(vector<double> &work, unsigned int chain) const
+{
+    if (isFixed()) {
+	return &_coef[0];
+    }
+    work.resize(_length);
+    calculate(&work[0], chain);
+    return &work[0];
+}
+
+}}
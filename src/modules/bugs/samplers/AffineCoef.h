@@ -0,0 +1,87 @@
+#ifndef AFFINE_COEF_H_
+#define AFFINE_COEF_H_
+
+#include <vector>
+
+namespace jags {
+
+class SingletonGraphView;
+
+namespace bugs {
+
+/**
+ * @short Coefficients of the parameters of stochastic children
+ *
+ * Conjugate samplers for a scalar node x need to know how one
+ * parameter of each stochastic child depends on x. When all
+ * deterministic children are linear functions, the parameter takes
+ * the form alpha + beta * x, and when they are all scale
+ * transformations, it takes the form beta * x. AffineCoef calculates
+ * the coefficients beta for all stochastic children, concatenated
+ * into a single array.
+ *
+ * The coefficients are calculated once in the constructor, and
+ * cached, if the relevant parents of the deterministic children are
+ * fixed. Otherwise they are calculated on demand. For pure scale
+ * transformations, beta is the ratio of the parameter to x, which
+ * requires no evaluation of the deterministic children. In other
+ * cases the node is shifted to x + 1, which requires a single pass
+ * over the deterministic children. If the support of the node is
+ * narrower than this, a smaller shift within the support is used.
+ * The node is NOT shifted back, as conjugate samplers always set a
+ * new value at the end of the update.
+ *
+ * For mixture models, a coefficient is zero if the parameter does
+ * not depend on x for the current values of the mixture indices.
+ */
+class AffineCoef {
+    SingletonGraphView const *_gv;
+    std::vector<unsigned int> _param;
+    unsigned long _length;
+    bool _scale;
+    std::vector<double> _coef;
+    void calculate(double *coef, unsigned int chain) const;
+public:
+    /**
+     * Constructor.
+     *
+     * @param gv View of the sampled node. The deterministic children
+     * must be either linear functions or scale transformations.
+     *
+     * @param param Vector of the same length as the stochastic
+     * children of gv, giving the index of the parameter of each
+     * child that depends on the sampled node.
+     *
+     * @param scale Flag indicating whether the deterministic
+     * children are scale transformations (true) or linear
+     * functions (false).
+     */
+    AffineCoef(SingletonGraphView const *gv,
+	       std::vector<unsigned int> const &param, bool scale);
+    /**
+     * Returns the length of the array of coefficients, i.e. the sum
+     * of the lengths of the parameters.
+     */
+    unsigned long length() const;
+    /**
+     * Returns true if the coefficients are fixed, and have been
+     * cached by the constructor.
+     */
+    bool isFixed() const;
+    /**
+     * Returns a pointer to an array of coefficients for the given
+     * chain. If the coefficients are not fixed they are calculated
+     * in the supplied workspace, which is resized if necessary.
+     *
+     * After this function is called, the sampled node may have a
+     * different value from the one it had before. The caller must
+     * either read the value of the node again, or treat the
+     * parameters of the stochastic children as undefined until a
+     * new value is set.
+     */
+    double const *coef(std::vector<double> &work, unsigned int chain) const;
+};
+
+}}
+
+#endif /* AFFINE_COEF_H_ */
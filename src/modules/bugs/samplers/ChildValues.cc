@@ -0,0 +1,91 @@
+#include <config.h>
+
+#include "ChildValues.h"
+
+#include <graph/StochasticNode.h>
+#include <sampler/GraphView.h>
+#include <sampler/SingletonGraphView.h>
+
+#include <map>
+
+using std::vector;
+using std::map;
+
+namespace jags {
+namespace bugs {
+
+ChildValues::ChildValues(SingletonGraphView const *gv,
+			 vector<ConjugateDist> const &dist,
+			 unsigned int nparam)
+{
+    vector<StochasticNode *> const &children = gv->stochasticChildren();
+
+    //Sort children by distribution, keeping the original order
+    //within each group
+    map<ConjugateDist, vector<unsigned int> > groups;
+    for (unsigned int i = 0; i < children.size(); ++i) {
+	groups[dist[i]].push_back(i);
+    }
+    for (map<ConjugateDist, vector<unsigned int> >::const_iterator p =
+	     groups.begin(); p != groups.end(); ++p)
+    {
+	_dist.push_back(p->first);
+	_begin.push_back(_index.size());
+	_index.insert(_index.end(), p->second.begin(), p->second.end());
+    }
+    _begin.push_back(_index.size());
+
+    unsigned int nchain = jags::nchain(gv);
+    unsigned long N = _index.size();
+    _value.assign(nchain, vector<double const *>(N));
+    _param.assign(nchain, vector<vector<double const *> >(nparam,
+		  vector<double const *>(N, 0)));
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	for (unsigned long j = 0; j < N; ++j) {
+	    StochasticNode const *child = children[_index[j]];
+	    _value[ch][j] = child->value(ch);
+	    vector<Node const *> const &par = child->parents();
+	    for (unsigned int k = 0; k < nparam && k < par.size(); ++k) {
+		_param[ch][k][j] = par[k]->value(ch);
+	    }
+	}
+    }
+}
+
+unsigned int ChildValues::ngroup() const
+{
+    return _dist.size();
+}
+
+ConjugateDist ChildValues::dist(unsigned int g) const
+{
+    return _dist[g];
+}
+
+unsigned long ChildValues::begin(unsigned int g) const
+{
+    return _begin[g];
+}
+
+unsigned long ChildValues::end(unsigned int g) const
+{
+    return _begin[g+1];
+}
+
+unsigned int const *ChildValues::index() const
+{
+    return _index.data();
+}
+
+double const * const *ChildValues::value(unsigned int chain) const
+{
+    return _value[chain].data();
+}
+
+double const * const *
+ChildValues::param(unsigned int k, unsigned int chain) const
+{
+    return _param[chain][k].data();
+}
+
+}}
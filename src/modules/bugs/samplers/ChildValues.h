@@ -0,0 +1,126 @@
+#ifndef CHILD_VALUES_H_
+#define CHILD_VALUES_H_
+
+#include "ConjugateMethod.h"
+
+#include <vector>
+#include <algorithm>
+
+/* Number of children in a chunk of the sum of sufficient statistics.
+   Chunks are summed in parallel when OpenMP is enabled. */
+#define CONJ_CHUNK 16384
+
+namespace jags {
+
+class SingletonGraphView;
+
+namespace bugs {
+
+/**
+ * @short Gathered values and parameters of stochastic children
+ *
+ * Conjugate samplers accumulate sufficient statistics over all the
+ * stochastic children of the sampled node. When there are very many
+ * children, the cost is dominated by following pointers of the form
+ * child->parents()[k]->value(chain). ChildValues gathers pointers to
+ * the values and parameters of the children into compact arrays, for
+ * each chain, so that they only need to be found once.
+ *
+ * The children are sorted into groups with the same distribution,
+ * so that the sufficient statistics can be accumulated by a simple
+ * loop over each group. The index function gives the original
+ * position of each sorted child.
+ */
+class ChildValues {
+    std::vector<unsigned int> _index;
+    std::vector<ConjugateDist> _dist;
+    std::vector<unsigned long> _begin;
+    std::vector<std::vector<double const *> > _value;
+    std::vector<std::vector<std::vector<double const *> > > _param;
+public:
+    /**
+     * Constructor.
+     *
+     * @param gv View of the sampled node
+     * @param dist Distributions of the stochastic children of gv
+     * @param nparam Number of parameters to gather. If a child has
+     * fewer parameters then the missing pointers are NULL.
+     */
+    ChildValues(SingletonGraphView const *gv,
+		std::vector<ConjugateDist> const &dist, unsigned int nparam);
+    /**
+     * Number of groups of children with the same distribution
+     */
+    unsigned int ngroup() const;
+    /**
+     * Distribution of the children in group g
+     */
+    ConjugateDist dist(unsigned int g) const;
+    /**
+     * Position of the first sorted child in group g
+     */
+    unsigned long begin(unsigned int g) const;
+    /**
+     * Position after the last sorted child in group g
+     */
+    unsigned long end(unsigned int g) const;
+    /**
+     * Original positions of the sorted children
+     */
+    unsigned int const *index() const;
+    /**
+     * Pointers to the values of the sorted children
+     */
+    double const * const *value(unsigned int chain) const;
+    /**
+     * Pointers to parameter k of the sorted children
+     */
+    double const * const *param(unsigned int k, unsigned int chain) const;
+};
+
+/**
+ * Adds the sufficient statistics for children first to last - 1 to
+ * s1 and s2. The Terms class must have a member function
+ *
+ * bool sum(unsigned long first, unsigned long last,
+ *          double &s1, double &s2) const;
+ *
+ * which returns false if the distribution of the children is not
+ * valid. Exceptions cannot safely leave a parallel region, so the
+ * caller is responsible for throwing an error in this case.
+ *
+ * Large ranges are divided into chunks that are summed in parallel,
+ * and the chunk totals are then added in order, so the result does
+ * not depend on the number of threads.
+ *
+ * @return true on success, false if any call to Terms::sum failed
+ */
+template<class Terms>
+bool sumTerms(Terms const &terms, unsigned long first, unsigned long last,
+	      double &s1, double &s2)
+{
+    if (last - first <= CONJ_CHUNK) {
+	return terms.sum(first, last, s1, s2);
+    }
+
+    long nchunk = (last - first + CONJ_CHUNK - 1) / CONJ_CHUNK;
+    std::vector<double> p1(nchunk, 0), p2(nchunk, 0);
+
+    bool ok = true;
+    #pragma omp parallel for reduction(&&:ok)
+    for (long k = 0; k < nchunk; ++k) {
+	unsigned long a = first + k * CONJ_CHUNK;
+	unsigned long b = std::min(a + CONJ_CHUNK, last);
+	ok = terms.sum(a, b, p1[k], p2[k]) && ok;
+    }
+
+    for (long k = 0; k < nchunk; ++k) {
+	s1 += p1[k];
+	s2 += p2[k];
+    }
+    return ok;
+}
+
+}}
+
+#endif /* CHILD_VALUES_H_ */
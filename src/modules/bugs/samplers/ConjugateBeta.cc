@@ -27,6 +27,66 @@ using std::string;
 namespace jags {
 namespace bugs {
 
+/*
+   Contribution of a group of stochastic children with the same
+   distribution to the parameters of the posterior. For mixture
+   models, C[i] is non-zero if child i depends on the sampled node
+   and 0 otherwise.
+*/
+struct BetaTerms {
+    const ConjugateDist dist;
+    double const * const * const Y; // values
+    double const * const * const N; // sizes
+    double const * const C;
+    unsigned int const * const index;
+    BetaTerms(ConjugateDist d, double const * const *y,
+	      double const * const *n, double const *c,
+	      unsigned int const *i)
+	: dist(d), Y(y), N(n), C(c), index(i) {}
+    bool sum(unsigned long first, unsigned long last,
+	     double &a, double &b) const;
+};
+
+bool BetaTerms::sum(unsigned long first, unsigned long last,
+		    double &a, double &b) const
+{
+    double a1 = 0, b1 = 0;
+    switch(dist) {
+    case BIN:
+        #pragma omp simd reduction(+:a1,b1)
+	for (unsigned long i = first; i < last; ++i) {
+	    if (!C || C[index[i]] != 0) {
+		a1 += *Y[i];
+		b1 += *N[i] - *Y[i];
+	    }
+	}
+	break;
+    case NEGBIN:
+        #pragma omp simd reduction(+:a1,b1)
+	for (unsigned long i = first; i < last; ++i) {
+	    if (!C || C[index[i]] != 0) {
+		a1 += *N[i];
+		b1 += *Y[i];
+	    }
+	}
+	break;
+    case BERN:
+        #pragma omp simd reduction(+:a1,b1)
+	for (unsigned long i = first; i < last; ++i) {
+	    if (!C || C[index[i]] != 0) {
+		a1 += *Y[i];
+		b1 += 1 - *Y[i];
+	    }
+	}
+	break;
+    default:
+	return false;
+    }
+    a += a1;
+    b += b1;
+    return true;
+}
+
 bool ConjugateBeta::canSample(StochasticNode *snode, Graph const &graph)
 {
     switch(getDist(snode)) {
@@ -82,14 +142,14 @@ bool ConjugateBeta::canSample(StochasticNode *snode, Graph const &graph)
 
 
 ConjugateBeta::ConjugateBeta(SingletonGraphView const *gv)
-    : ConjugateMethod(gv)
+    : ConjugateMethod(gv), _children(gv, _child_dist, 2),
+      _coef(gv, vector<unsigned int>(gv->stochasticChildren().size(), 0),
+	    true)
 {
 }
 
 void ConjugateBeta::update(unsigned int chain, RNG *rng) const
 {
-    vector<StochasticNode *> const &stoch_children = 
-	_gv->stochasticChildren();
     StochasticNode const *snode = _gv->node();
 
     double a=0, b=0; //-Wall
@@ -105,51 +165,21 @@ void ConjugateBeta::update(unsigned int chain, RNG *rng) const
     default:
 	throwLogicError("Invalid distribution in ConjugateBeta sampler");
     }
-    unsigned long Nchild = stoch_children.size();
 
     /* For mixture models, we count only stochastic children that
-       depend on snode */
-    double *C = 0;
-    bool is_mix = !_gv->deterministicChildren().empty();
-    if (is_mix) {
-	C = new double[Nchild];
-	for (unsigned long i = 0; i < Nchild; ++i) {
-	    C[i] = *stoch_children[i]->parents()[0]->value(chain);
-	}
-	// Perturb current value, keeping in the legal range [0,1]
-	double x = *snode->value(chain);
-	x = x > 0.5 ? x - 0.4 : x + 0.4;
-	_gv->setValue(&x, 1, chain);
-	// C[i] == 1 if parameter of child i has changed (so depends on snode)
-	// C[i] == 0 otherwise
-	for (unsigned long i = 0; i < Nchild; ++i) {
-	    C[i] = (*stoch_children[i]->parents()[0]->value(chain) != C[i]);
-	}
+       depend on snode, i.e. those with a non-zero coefficient */
+    double const *C = 0;
+    vector<double> work;
+    if (!_gv->deterministicChildren().empty()) {
+	C = _coef.coef(work, chain);
     }
 
 
-    for (unsigned int i = 0; i < stoch_children.size(); ++i) {
-	if (!(is_mix && C[i] == 0)) {
-	    double y = *stoch_children[i]->value(chain);
-	    double n;
-	    switch(_child_dist[i]) {
-	    case BIN:
-		n = *stoch_children[i]->parents()[1]->value(chain);
-		a += y;
-		b += n - y;
-		break;
-	    case NEGBIN:
-		n = *stoch_children[i]->parents()[1]->value(chain);
-		a += n;
-		b += y;
-		break;
-	    case BERN:
-		a += y;
-		b += 1 - y;
-		break;
-	    default:
-		throwLogicError("Invalid distribution in Conjugate Beta sampler");
-	    }
+    for (unsigned int g = 0; g < _children.ngroup(); ++g) {
+	BetaTerms terms(_children.dist(g), _children.value(chain),
+			_children.param(1, chain), C, _children.index());
+	if (!sumTerms(terms, _children.begin(g), _children.end(g), a, b)) {
+	    throwLogicError("Invalid distribution in ConjugateBeta sampler");
 	}
     }
 
@@ -170,7 +200,6 @@ void ConjugateBeta::update(unsigned int chain, RNG *rng) const
 	for (int i = 0; i < 4; i++) {
 	    if (xnew >= lower && xnew <= upper) {
 		_gv->setValue(&xnew, 1, chain);
-                if (is_mix) delete [] C;
 		return;
 	    }
 	    xnew = rbeta(a, b, rng);
@@ -182,10 +211,6 @@ void ConjugateBeta::update(unsigned int chain, RNG *rng) const
 	xnew = qbeta(p, a, b, 1, 0);   
     }
     _gv->setValue(&xnew, 1, chain);
-
-    if (is_mix) {
-	delete [] C;
-    }
 }
 
 }}
@@ -2,6 +2,8 @@
 #define CONJUGATE_BETA_H_
 
 #include "ConjugateMethod.h"
+#include "ChildValues.h"
+#include "AffineCoef.h"
 
 namespace jags {
 
@@ -19,6 +21,8 @@ namespace bugs {
  * sample size parameter must not depend on snode.
  */
 class ConjugateBeta : public ConjugateMethod {
+    ChildValues _children;
+    AffineCoef _coef;
 public:
     ConjugateBeta(SingletonGraphView const *gv);
     void update(unsigned int chain, RNG *rng) const;
@@ -4,7 +4,6 @@
 #include <graph/LogicalNode.h>
 #include <graph/StochasticNode.h>
 #include <graph/MixtureNode.h>
-#include <graph/NodeError.h>
 #include <graph/Graph.h>
 #include <sarray/SArray.h>
 #include <sampler/Linear.h>
@@ -28,64 +27,134 @@ using std::string;
 namespace jags {
 namespace bugs {
 
-static double 
-getScale(StochasticNode const *snode, ConjugateDist d, unsigned int chain)
+/* 
+   Contribution of a group of stochastic children with the same
+   distribution to the shape (r) and rate (mu) of the posterior.
+   Children with a zero coefficient do not depend on the sampled node
+   and contribute nothing.
+*/
+struct GammaTerms {
+    const ConjugateDist dist;
+    double const * const * const Y; // values
+    double const * const * const M; // location parameters
+    double const * const coef;
+    unsigned int const * const index;
+    GammaTerms(ConjugateDist d, double const * const *y,
+	       double const * const *m, double const *c,
+	       unsigned int const *i)
+	: dist(d), Y(y), M(m), coef(c), index(i) {}
+    bool sum(unsigned long first, unsigned long last,
+	     double &r, double &mu) const;
+};
+
+bool GammaTerms::sum(unsigned long first, unsigned long last,
+		     double &r, double &mu) const
 {
-    //Get scale parameter of snode
-    switch(d) {
-    case GAMMA: case NORM: case DEXP: case WEIB: case LNORM:
-	return *snode->parents()[1]->value(chain);
+    double r1 = 0, mu1 = 0;
+    switch(dist) {
+    case GAMMA:
+        #pragma omp simd reduction(+:r1,mu1)
+	for (unsigned long i = first; i < last; ++i) {
+	    double c = coef ? coef[index[i]] : 1;
+	    if (c > 0) {
+		r1 += *M[i];
+		mu1 += c * *Y[i];
+	    }
+	}
+	break;
+    case EXP:
+        #pragma omp simd reduction(+:r1,mu1)
+	for (unsigned long i = first; i < last; ++i) {
+	    double c = coef ? coef[index[i]] : 1;
+	    if (c > 0) {
+		r1 += 1;
+		mu1 += c * *Y[i];
+	    }
+	}
+	break;
+    case NORM:
+        #pragma omp simd reduction(+:r1,mu1)
+	for (unsigned long i = first; i < last; ++i) {
+	    double c = coef ? coef[index[i]] : 1;
+	    if (c > 0) {
+		double d = *Y[i] - *M[i];
+		r1 += 0.5;
+		mu1 += c * d * d / 2;
+	    }
+	}
 	break;
-    case EXP: case POIS:
-	return *snode->parents()[0]->value(chain);
+    case POIS:
+        #pragma omp simd reduction(+:r1,mu1)
+	for (unsigned long i = first; i < last; ++i) {
+	    double c = coef ? coef[index[i]] : 1;
+	    if (c > 0) {
+		r1 += *Y[i];
+		mu1 += c;
+	    }
+	}
+	break;
+    case DEXP:
+        #pragma omp simd reduction(+:r1,mu1)
+	for (unsigned long i = first; i < last; ++i) {
+	    double c = coef ? coef[index[i]] : 1;
+	    if (c > 0) {
+		r1 += 1;
+		mu1 += c * fabs(*Y[i] - *M[i]);
+	    }
+	}
+	break;
+    case WEIB:
+	for (unsigned long i = first; i < last; ++i) {
+	    double c = coef ? coef[index[i]] : 1;
+	    if (c > 0) {
+		r1 += 1;
+		mu1 += c * pow(*Y[i], *M[i]);
+	    }
+	}
+	break;
+    case LNORM:
+	for (unsigned long i = first; i < last; ++i) {
+	    double c = coef ? coef[index[i]] : 1;
+	    if (c > 0) {
+		double d = log(*Y[i]) - *M[i];
+		r1 += 0.5;
+		mu1 += c * d * d / 2;
+	    }
+	}
 	break;
     default:
-	throwNodeError(snode, 
-		       "Can't get scale parameter: invalid distribution");
-	return 0; //-Wall
-	
-    } 
-}
-
-
-static void calCoef(double *coef, SingletonGraphView const *gv,
-		    vector<ConjugateDist> const &child_dist, unsigned int chain)
-{   
-    const double xold = gv->node()->value(chain)[0];
-    vector<StochasticNode *> const &stoch_children =
-        gv->stochasticChildren();
-    unsigned long nchildren = stoch_children.size();
-    
-    for (unsigned long i = 0; i < nchildren; ++i) {
-        coef[i] = -getScale(stoch_children[i], child_dist[i], chain);
-    }
-    double val = xold + 1;
-    gv->setValue(&val, 1, chain);
-    for (unsigned long i = 0; i < nchildren; ++i) {
-        coef[i] += getScale(stoch_children[i], child_dist[i], chain);
+	return false;
     }
-    gv->setValue(&xold, 1, chain);
+    r += r1;
+    mu += mu1;
+    return true;
 }
 
-
-ConjugateGamma::ConjugateGamma(SingletonGraphView const *gv)
-    : ConjugateMethod(gv), _coef(0)
+static vector<unsigned int> scaleParams(vector<ConjugateDist> const &dist)
 {
-    if(!gv->deterministicChildren().empty() && checkScale(gv, true)) 
-    {
-	//One-off calculation of fixed scale transformation
-	_coef = new double[gv->stochasticChildren().size()];
-	calCoef(_coef, gv, _child_dist, 0);
+    //Index of the scale parameter of each stochastic child
+    vector<unsigned int> param(dist.size());
+    for (unsigned int i = 0; i < dist.size(); ++i) {
+	switch(dist[i]) {
+	case GAMMA: case NORM: case DEXP: case WEIB: case LNORM:
+	    param[i] = 1;
+	    break;
+	case EXP: case POIS:
+	    param[i] = 0;
+	    break;
+	default:
+	    throwLogicError("Invalid distribution in ConjugateGamma method");
+	}
     }
-
+    return param;
 }
 
-ConjugateGamma::~ConjugateGamma()
+ConjugateGamma::ConjugateGamma(SingletonGraphView const *gv)
+    : ConjugateMethod(gv), _coef(gv, scaleParams(_child_dist), true),
+      _children(gv, _child_dist, 1)
 {
-    delete [] _coef;
 }
 
-
 bool ConjugateGamma::canSample(StochasticNode *snode, Graph const &graph)
 {
     switch (getDist(snode)) {
@@ -130,10 +199,6 @@ bool ConjugateGamma::canSample(StochasticNode *snode, Graph const &graph)
 
 void ConjugateGamma::update(unsigned int chain, RNG *rng) const
 {
-    vector<StochasticNode *> const &stoch_children = 
-	_gv->stochasticChildren();
-    unsigned long nchildren = stoch_children.size();
-
     //Need to initialize these for -Wall
     double r=0; // shape
     double mu=0; // 1/scale
@@ -158,64 +223,17 @@ void ConjugateGamma::update(unsigned int chain, RNG *rng) const
     }
 
     // likelihood 
-    double *coef = 0;
     bool empty = _gv->deterministicChildren().empty();
-    bool temp_coef = false;
-    if (!empty && _coef == 0) {
-	    temp_coef = true;
-	    coef = new double[nchildren];
-	    calCoef(coef, _gv, _child_dist, chain);
-    }
-    else {
-	coef = _coef;
-    }
+    vector<double> work;
+    double const *coef = empty ? 0 : _coef.coef(work, chain);
 
-    for (unsigned long i = 0; i < nchildren; ++i) {
-
-	double coef_i = empty ? 1 : coef[i];
-	if (coef_i > 0) {
-
-	    StochasticNode const *schild = stoch_children[i];
-	    vector<Node const*> const &cparam = schild->parents();
-	    double Y = *schild->value(chain);
-	    double m = *cparam[0]->value(chain); //location parameter 
-	    switch(_child_dist[i]) {
-	    case GAMMA:
-		r += m;
-		mu += coef_i * Y ;
-		break;
-	    case EXP:
-		r += 1;
-		mu += coef_i * Y;
-		break;
-	    case NORM:
-		r += 0.5;
-		mu += coef_i * (Y - m) * (Y - m) / 2;
-		break;
-	    case POIS:
-		r += Y;
-		mu += coef_i;
-		break;
-	    case DEXP:
-		r += 1;
-		mu += coef_i * fabs(Y - m);
-		break;
-	    case WEIB:
-		r += 1; 
-		mu += coef_i * pow(Y, m);
-		break;
-	    case LNORM:
-		r+= 0.5;
-		mu += coef_i * (log(Y) - m) * (log(Y) - m) / 2;
-		break;
-	    default:
-		throwLogicError("Invalid distribution in Conjugate Gamma method"); 
-	    }
+    for (unsigned int g = 0; g < _children.ngroup(); ++g) {
+	GammaTerms terms(_children.dist(g), _children.value(chain),
+			 _children.param(0, chain), coef, _children.index());
+	if (!sumTerms(terms, _children.begin(g), _children.end(g), r, mu)) {
+	    throwLogicError("Invalid distribution in ConjugateGamma method");
 	}
     }
-    if (temp_coef) {
-	delete [] coef;
-    }
 
     // Sample from the posterior
     double xnew;
@@ -2,6 +2,8 @@
 #define CONJUGATE_GAMMA_H_
 
 #include "ConjugateMethod.h"
+#include "AffineCoef.h"
+#include "ChildValues.h"
 
 namespace jags {
     
@@ -10,10 +12,10 @@ namespace jags {
 namespace bugs {
 
 class ConjugateGamma : public ConjugateMethod {
-    double *_coef;
+    AffineCoef _coef;
+    ChildValues _children;
 public:
     ConjugateGamma(SingletonGraphView const *gv);
-    ~ConjugateGamma();
     static bool canSample(StochasticNode *snode, Graph const &graph);
     void update(unsigned int chain, RNG *rng) const;
 };
@@ -26,66 +26,54 @@ using std::sqrt;
 namespace jags {
 namespace bugs {
 
-static void calBeta(double *beta, SingletonGraphView const *gv, 
-		    unsigned int chain)
-{
-    StochasticNode *snode = gv->node();
-
-    const double xold = *snode->value(chain);
-    vector<StochasticNode *> const &stoch_children = 
-	gv->stochasticChildren();
-
-    double xnew = xold + 1;
-    gv->setValue(&xnew, 1, chain);
-
-    double *bp = beta;    
-    for (unsigned int i = 0; i < stoch_children.size(); ++i) {
-	StochasticNode const *child = stoch_children[i];
-	unsigned long nrow = child->length();
-	double const *mu = child->parents()[0]->value(chain);
-	for (unsigned long j = 0; j < nrow; ++j) {
-	    bp[j] = mu[j];
-	}
-	bp += nrow;
-    }
-
-    gv->setValue(&xold, 1, chain);
-
-    bp = beta;    
-    for (unsigned int i = 0; i < stoch_children.size(); ++i) {
-	StochasticNode const *child = stoch_children[i];
-	unsigned long nrow = child->length();
-	double const *mu = child->parents()[0]->value(chain);
-	for (unsigned long j = 0; j < nrow; ++j) {
-	    bp[j] -= mu[j];
+/*
+   Contribution of univariate normal children to the weighted sum of
+   means (A) and the posterior precision (B)
+*/
+struct NormalTerms {
+    double const * const * const Y; // values
+    double const * const * const alpha; // means
+    double const * const * const tau; // precisions
+    double const * const beta;
+    unsigned int const * const index;
+    NormalTerms(double const * const *y, double const * const *a,
+		double const * const *t, double const *b,
+		unsigned int const *i)
+	: Y(y), alpha(a), tau(t), beta(b), index(i) {}
+    bool sum(unsigned long first, unsigned long last,
+	     double &A, double &B) const
+    {
+	double A1 = 0, B1 = 0;
+        #pragma omp simd reduction(+:A1,B1)
+	for (unsigned long i = first; i < last; ++i) {
+	    double b = beta ? beta[index[i]] : 1;
+	    if (b != 0) {
+		double tau_beta = *tau[i] * b;
+		A1 += (*Y[i] - *alpha[i]) * tau_beta;
+		B1 += b * tau_beta;
+	    }
 	}
-	bp += nrow;
+	A += A1;
+	B += B1;
+	return true;
     }
-}
+};
 
-ConjugateNormal::ConjugateNormal(SingletonGraphView const *gv)
-    : ConjugateMethod(gv), _betas(0), _length_betas(0)
+static bool allScalar(SingletonGraphView const *gv)
 {
-    if (!gv->deterministicChildren().empty()) {
-
-	//Need to allocate vector of coefficients
-	vector<StochasticNode *> const &children = 
-	    gv->stochasticChildren();
-	for (unsigned int i = 0; i < children.size(); ++i) {
-	    _length_betas += children[i]->length();
-	}
-
-	if (checkLinear(gv, true)) {
-	    //One-time calculation of fixed coefficients
-	    _betas = new double[_length_betas];
-	    calBeta(_betas, gv, 0);
-	}
+    vector<StochasticNode *> const &children = gv->stochasticChildren();
+    for (unsigned int i = 0; i < children.size(); ++i) {
+	if (children[i]->length() != 1) return false;
     }
+    return true;
 }
 
-ConjugateNormal::~ConjugateNormal()
+ConjugateNormal::ConjugateNormal(SingletonGraphView const *gv)
+    : ConjugateMethod(gv),
+      _betas(gv, vector<unsigned int>(gv->stochasticChildren().size(), 0),
+	     false),
+      _children(gv, _child_dist, 2), _scalar(allScalar(gv))
 {
-    delete [] _betas;
 }
 
 bool ConjugateNormal::canSample(StochasticNode *snode, Graph const &graph)
@@ -134,8 +122,16 @@ void ConjugateNormal::update(unsigned int chain, RNG *rng) const
     unsigned long nchildren = stoch_children.size();
     StochasticNode *snode = _gv->node();
 
+    /* Calculating the coefficients may change the value of snode,
+       so this must be done first */
+    vector<double> work;
+    double const *beta = 0;
+    if (!_gv->deterministicChildren().empty()) {
+	beta = _betas.coef(work, chain);
+    }
+
     /* For convenience in the following computations, we shift the
-       origin to xold, the previous value of the node */
+       origin to xold, the current value of the node */
 
     const double xold = *snode->value(chain);
     double A=0, B=0; //-Wall
@@ -153,31 +149,18 @@ void ConjugateNormal::update(unsigned int chain, RNG *rng) const
 	throwLogicError("Invalid distribution in conjugate normal method");
     }
 
-    if (_gv->deterministicChildren().empty()) {
-
-	// This can only happen if the stochastic children are all
-	// univariate normal. We know alpha = 0, beta = 1.
+    if (_scalar) {
 
-	for (unsigned long i = 0; i < nchildren; ++i) {
-	    double Y = *stoch_children[i]->value(chain);
-	    double tau = *stoch_children[i]->parents()[1]->value(chain);
-	    A += (Y - xold) * tau;
-	    B += tau;
-	}
+	// All stochastic children are univariate normal. If there are
+	// no deterministic children then alpha = xold, beta = 1.
+	
+	NormalTerms terms(_children.value(chain), _children.param(0, chain),
+			  _children.param(1, chain), beta, _children.index());
+	sumTerms(terms, 0, nchildren, A, B);
 
     }
     else {
 
-	double *beta;
-	bool temp_beta = (_betas == 0);
-	if (temp_beta) {
-	    beta = new double[_length_betas];
-	    calBeta(beta, _gv, chain);
-	}
-	else {
-	    beta = _betas;
-	}
-
 	double const *bp = beta;
 	for (unsigned long i = 0; i < nchildren; ++i) {
 
@@ -199,10 +182,6 @@ void ConjugateNormal::update(unsigned int chain, RNG *rng) const
 	    
 	    bp += nrow;
 	}
-
-	if (temp_beta) {
-	    delete [] beta;
-	}
     }
 
     // Draw the sample
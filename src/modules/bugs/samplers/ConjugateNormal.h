@@ -2,6 +2,8 @@
 #define CONJUGATE_NORMAL_H_
 
 #include "ConjugateMethod.h"
+#include "AffineCoef.h"
+#include "ChildValues.h"
 
 namespace jags {
 
@@ -18,11 +20,11 @@ namespace bugs {
  * snode.
  */
 class ConjugateNormal : public ConjugateMethod {
-    double *_betas;
-    unsigned long _length_betas;
+    AffineCoef _betas;
+    ChildValues _children;
+    bool _scalar;
 public:
     ConjugateNormal(SingletonGraphView const *gv);
-    ~ConjugateNormal();
     void update(unsigned int chain, RNG *rng) const;
     static bool canSample(StochasticNode *snode, Graph const &graph);
 };
@@ -10,6 +10,11 @@
 #include <sampler/Linear.h>
 #include <sampler/SingletonGraphView.h>
 #include <util/integer.h>
+#include <module/ModuleError.h>
+
+#include "lapack.h"
+#include "matrix.h"
+#include "CholeskyCache.h"
 
 #include <set>
 #include <vector>
@@ -98,8 +103,6 @@ ConjugateWishart::update(unsigned int chain, RNG *rng) const
     unsigned long nrow = param[0]->dim()[0];
 
     unsigned long N = nrow * nrow;
-    vector<double> R(N);
-    copy(Rprior, Rprior + N, R.begin());
 
     //Logical mask to determine which stochastic children are active.
     vector<bool> active(nchildren, true);
@@ -127,24 +130,52 @@ ConjugateWishart::update(unsigned int chain, RNG *rng) const
 	}
     }
 
+    //Residuals of active children, stored as columns of D
+    vector<double> D;
     for (unsigned long i = 0; i < nchildren; ++i) {
 	if (active[i]) {
 	    StochasticNode const *schild = stoch_children[i];
 	    double const *Y = schild->value(chain);
 	    double const *mu = schild->parents()[0]->value(chain);
-	    
 	    for (unsigned long j = 0; j < nrow; j++) {
-		for (unsigned long k = 0; k < nrow; k++) {
-		    R[j*nrow + k] += (Y[j] - mu[j]) * (Y[k] - mu[k]);
-		}
+		D.push_back(Y[j] - mu[j]);
 	    }
 	    df += 1;
 	}
     }
+    unsigned long nactive = D.size() / nrow;
+
+    /* 
+       The posterior parameter is R = Rprior + D %*% t(D). We need
+       only its Cholesky factor L. The factor of Rprior is cached, as
+       it is usually fixed. With few children, we update it with one
+       rank-one modification per child, at a cost of O(nrow^2)
+       each. Otherwise we form R with a single BLAS call and factorize
+       it.
+    */
+    double ldet = 0;
+    double const *L0 = CholeskyCache::factor(Rprior, nrow, ldet);
+    vector<double> L(L0, L0 + N);
+    if (3 * nactive < nrow) {
+	for (unsigned long i = 0; i < nactive; ++i) {
+	    chol_update(&L[0], &D[i * nrow], nrow);
+	}
+    }
+    else if (nactive > 0) {
+	copy(Rprior, Rprior + N, L.begin());
+	int ni = asInteger(nrow);
+	int nc = asInteger(nactive);
+	double one = 1;
+	F77_DSYRK("L", "N", &ni, &nc, &one, &D[0], &ni, &one, &L[0], &ni);
+	int info = 0;
+	F77_DPOTRF("L", &ni, &L[0], &ni, &info);
+	if (info != 0) {
+	    throwRuntimeError("Failed to get Cholesky decomposition of R");
+	}
+    }
 
     vector<double> xnew(N);
-
-    DWish::randomSample(&xnew[0], N, &R[0], df, nrow, rng);
+    DWish::randomSampleChol(&xnew[0], &L[0], df, nrow, rng);
     _gv->setValue(xnew, chain);
 }
 
@@ -0,0 +1,170 @@
+#include <config.h>
+
+#include "EllipticalSlice.h"
+
+#include <sampler/GraphView.h>
+#include <graph/StochasticNode.h>
+#include <distribution/Distribution.h>
+#include <module/ModuleError.h>
+#include <util/integer.h>
+#include <rng/RNG.h>
+
+#include "lapack.h"
+
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+/* Maximum number of shrinkage steps before the update is abandoned */
+#define MAX_SHRINK 1000
+
+using std::vector;
+using std::string;
+using std::equal;
+using std::copy;
+using std::sin;
+using std::cos;
+using std::log;
+using std::sqrt;
+
+namespace jags {
+namespace bugs {
+
+EllipticalSlice::EllipticalSlice(GraphView const *gv, unsigned int chain)
+    : _gv(gv), _chain(chain), _par(gv->nodes().size()),
+      _chol(gv->nodes().size())
+{
+    gv->checkFinite(chain); //Check validity of initial values
+}
+
+bool EllipticalSlice::canSample(StochasticNode const *snode)
+{
+    if (isBounded(snode)) return false;
+
+    string const &name = snode->distribution()->name();
+    return name == "dnorm" || name == "dmnorm" || name == "dmnorm.vcov";
+}
+
+void EllipticalSlice::priorSample(double *nu, double *mu, RNG *rng)
+{
+    // Draws nu from the prior, centred at zero, and copies the prior
+    // mean into mu
+
+    vector<StochasticNode *> const &nodes = _gv->nodes();
+    for (unsigned int i = 0; i < nodes.size(); ++i) {
+
+	StochasticNode const *snode = nodes[i];
+	unsigned long N = snode->length();
+	double const *m = snode->parents()[0]->value(_chain);
+	double const *S = snode->parents()[1]->value(_chain);
+	copy(m, m + N, mu);
+
+	if (N == 1 && snode->distribution()->name() == "dnorm") {
+	    nu[0] = rng->normal() / sqrt(S[0]);
+	}
+	else {
+	    // Refresh the Cholesky factor if the prior has changed
+	    unsigned long NN = N * N;
+	    vector<double> &par = _par[i];
+	    vector<double> &L = _chol[i];
+	    if (par.empty() || !equal(S, S + NN, par.begin())) {
+		par.assign(S, S + NN);
+		L = par;
+		int ni = asInteger(N);
+		int info = 0;
+		F77_DPOTRF("L", &ni, &L[0], &ni, &info);
+		if (info != 0) {
+		    par.clear();
+		    throwRuntimeError("Cholesky decomposition failure in "
+				      "EllipticalSlice");
+		}
+	    }
+
+	    for (unsigned long j = 0; j < N; ++j) {
+		nu[j] = rng->normal();
+	    }
+	    if (snode->distribution()->name() == "dmnorm") {
+		// Precision T = L L', so solve L' nu = z
+		for (unsigned long j = N; j-- > 0; ) {
+		    for (unsigned long k = j + 1; k < N; ++k) {
+			nu[j] -= L[k + N * j] * nu[k];
+		    }
+		    nu[j] /= L[j + N * j];
+		}
+	    }
+	    else {
+		// Variance Sigma = L L', so nu = L z
+		for (unsigned long j = N; j-- > 0; ) {
+		    double s = 0;
+		    for (unsigned long k = 0; k <= j; ++k) {
+			s += L[j + N * k] * nu[k];
+		    }
+		    nu[j] = s;
+		}
+	    }
+	}
+
+	nu += N;
+	mu += N;
+    }
+}
+
+void EllipticalSlice::update(RNG *rng)
+{
+    unsigned long N = _gv->length();
+    vector<double> f(N), mu(N), nu(N), x(N);
+    _gv->getValue(f, _chain);
+    priorSample(&nu[0], &mu[0], rng);
+
+    double logy = _gv->logLikelihood(_chain) + log(rng->uniform());
+
+    // Initial angle and bracket
+    double theta = 2 * M_PI * rng->uniform();
+    double lower = theta - 2 * M_PI;
+    double upper = theta;
+
+    for (unsigned int k = 0; k < MAX_SHRINK; ++k) {
+	double c = cos(theta), s = sin(theta);
+	for (unsigned long j = 0; j < N; ++j) {
+	    x[j] = (f[j] - mu[j]) * c + nu[j] * s + mu[j];
+	}
+	_gv->setValue(x, _chain);
+	if (_gv->logLikelihood(_chain) > logy) {
+	    return;
+	}
+	// Shrink the bracket towards the current value
+	if (theta < 0) {
+	    lower = theta;
+	}
+	else {
+	    upper = theta;
+	}
+	theta = lower + (upper - lower) * rng->uniform();
+    }
+
+    // The bracket has collapsed onto the current value
+    _gv->setValue(f, _chain);
+}
+
+bool EllipticalSlice::isAdaptive() const
+{
+    return false;
+}
+
+void EllipticalSlice::adaptOff()
+{
+}
+
+bool EllipticalSlice::checkAdaptation() const
+{
+    return true;
+}
+
+bool EllipticalSlice::isTemperable() const
+{
+    // The prior is sampled exactly and the slice is defined by
+    // GraphView#logLikelihood, which is tempered
+    return true;
+}
+
+}}
@@ -0,0 +1,54 @@
+#ifndef ELLIPTICAL_SLICE_H_
+#define ELLIPTICAL_SLICE_H_
+
+#include <sampler/MutableSampleMethod.h>
+
+#include <vector>
+
+namespace jags {
+
+    class GraphView;
+    class StochasticNode;
+
+namespace bugs {
+
+/**
+ * @short Elliptical slice sampler for nodes with a normal prior
+ *
+ * Updates a block of nodes with multivariate normal (dmnorm,
+ * dmnorm.vcov) or normal (dnorm) prior distributions, and arbitrary
+ * likelihood, using the elliptical slice sampler of Murray, Adams
+ * and MacKay (2010). Each update draws an auxiliary value from the
+ * prior and samples a new value on the ellipse through the current
+ * value and the auxiliary value, shrinking the range of angles until
+ * a point on the slice is found. Only the log likelihood is
+ * evaluated, and there are no tuning parameters.
+ *
+ * The Cholesky factor of the precision or variance matrix of each
+ * multivariate normal prior is cached and only recalculated when
+ * the matrix changes.
+ */
+class EllipticalSlice : public MutableSampleMethod
+{
+    GraphView const *_gv;
+    unsigned int _chain;
+    std::vector<std::vector<double> > _par;
+    std::vector<std::vector<double> > _chol;
+    void priorSample(double *nu, double *mu, RNG *rng);
+public:
+    EllipticalSlice(GraphView const *gv, unsigned int chain);
+    void update(RNG *rng);
+    bool isAdaptive() const;
+    void adaptOff();
+    bool checkAdaptation() const;
+    bool isTemperable() const;
+    /**
+     * Returns true if the node has a normal or multivariate normal
+     * prior distribution that can be sampled by EllipticalSlice.
+     */
+    static bool canSample(StochasticNode const *snode);
+};
+
+}}
+
+#endif /* ELLIPTICAL_SLICE_H_ */
@@ -0,0 +1,87 @@
+#include <config.h>
+
+#include "EllipticalSlice.h"
+#include "EllipticalSliceFactory.h"
+
+#include <graph/StochasticNode.h>
+#include <sampler/MutableSampler.h>
+#include <sampler/GraphView.h>
+#include <sampler/SingletonGraphView.h>
+#include <sampler/NodeGroups.h>
+
+#include <string>
+#include <vector>
+
+using std::vector;
+using std::list;
+using std::string;
+
+namespace jags {
+namespace bugs {
+
+vector<Sampler*> 
+EllipticalSliceFactory::makeSamplers(list<StochasticNode*> const &nodes, 
+				     Graph const &graph) const
+{
+    vector<StochasticNode*> candidates;
+    for (list<StochasticNode*>::const_iterator p = nodes.begin();
+	 p != nodes.end(); ++p)
+    {
+	if (EllipticalSlice::canSample(*p)) {
+	    candidates.push_back(*p);
+	}
+    }
+
+    // Join scalar candidates with common stochastic children into
+    // groups. Candidates that are stochastic children of other
+    // candidates are not joined, as the prior of the block would no
+    // longer be normal.
+    unsigned int Nc = candidates.size();
+    NodeGroups groups(candidates);
+    vector<bool> single(Nc, false);
+    vector<vector<StochasticNode*> > children(Nc);
+    for (unsigned int i = 0; i < Nc; ++i) {
+	SingletonGraphView view(candidates[i], graph);
+	children[i] = view.stochasticChildren();
+	if (candidates[i]->length() != 1) {
+	    single[i] = true;
+	}
+	for (unsigned int k = 0; k < children[i].size(); ++k) {
+	    unsigned int j = groups.index(children[i][k]);
+	    if (j < Nc) {
+		single[i] = true;
+		single[j] = true;
+	    }
+	}
+    }
+    for (unsigned int i = 0; i < Nc; ++i) {
+	if (!single[i]) {
+	    groups.joinChildren(i, children[i]);
+	}
+    }
+    vector<vector<StochasticNode*> > glist = groups.groups();
+
+    vector<Sampler*> samplers;
+    for (unsigned int g = 0; g < glist.size(); ++g) {
+	vector<StochasticNode*> const &block = glist[g];
+	// Skip nodes without stochastic children, which are always in
+	// a group of their own
+	if (children[groups.index(block[0])].empty()) continue;
+	GraphView *gv = new GraphView(block, graph);
+	unsigned int nchain = block[0]->nchain();
+	vector<MutableSampleMethod*> methods(nchain, 0);
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    methods[ch] = new EllipticalSlice(gv, ch);
+	}
+	samplers.push_back(new MutableSampler(gv, methods,
+					      "bugs::EllipticalSlice"));
+    }
+    return samplers;
+}
+
+string EllipticalSliceFactory::name() const
+{
+    return "bugs::EllipticalSlice";
+}
+
+}}
@@ -0,0 +1,34 @@
+#ifndef ELLIPTICAL_SLICE_FACTORY_H_
+#define ELLIPTICAL_SLICE_FACTORY_H_
+
+#include <sampler/SamplerFactory.h>
+
+namespace jags {
+namespace bugs {
+
+/**
+ * @short Factory object for elliptical slice samplers
+ *
+ * Multivariate normal nodes are sampled individually. Scalar normal
+ * nodes that share stochastic children are grouped into blocks, so
+ * that they are updated jointly. Nodes without stochastic children
+ * are left for other factories.
+ *
+ * Each proposal is drawn from the prior, so elliptical slice
+ * sampling mixes slowly when the prior is vague compared with the
+ * likelihood, e.g. for regression coefficients with a dnorm(0, 1.0E-6)
+ * prior. The factory is inactive when the bugs module is loaded and
+ * must be switched on by the user.
+ */
+class EllipticalSliceFactory : public SamplerFactory
+{
+public:
+    std::vector<Sampler*> 
+	makeSamplers(std::list<StochasticNode*> const &nodes, 
+		     Graph const &graph) const;
+    std::string name() const;
+};
+
+}}
+
+#endif /* ELLIPTICAL_SLICE_FACTORY_H_ */
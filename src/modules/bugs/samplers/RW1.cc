@@ -45,10 +45,10 @@ namespace bugs {
 	unsigned int N = _gv->length();
 
 	vector<double> xnew(N);
+	rng->normal(&xnew[0], N);
 	double S = 0;
 	for (unsigned int i = 0; i < N; ++i) {
-	    double eps = rng->normal();
-	    xnew[i] = xold[i] + eps * step;
+	    xnew[i] = xold[i] + xnew[i] * step;
 	    S += xnew[i];
 	}
 	S /= N;
@@ -0,0 +1,512 @@
+#include "testbugssamp.h"
+
+#include "EllipticalSlice.h"
+#include "ConjugateWishart.h"
+#include "AffineCoef.h"
+#include "ChildValues.h"
+#include "matrix.h"
+#include "lapack.h"
+
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/ArrayStochasticNode.h>
+#include <graph/VectorLogicalNode.h>
+#include <graph/Graph.h>
+#include <sampler/GraphView.h>
+#include <sampler/SingletonGraphView.h>
+#include <MersenneTwisterRNG.h>
+#include <DMNorm.h>
+#include <DMNormVC.h>
+#include <DNorm.h>
+#include <DWish.h>
+#include <DGamma.h>
+#include <Sum.h>
+#include <InProd.h>
+
+#include <vector>
+#include <map>
+#include <cmath>
+
+using std::vector;
+using std::map;
+using std::fabs;
+
+using jags::Node;
+using jags::ArrayDist;
+using jags::ConstantNode;
+using jags::ScalarStochasticNode;
+using jags::ArrayStochasticNode;
+using jags::StochasticNode;
+using jags::Graph;
+using jags::GraphView;
+using jags::SingletonGraphView;
+using jags::base::MersenneTwisterRNG;
+using jags::bugs::EllipticalSlice;
+using jags::bugs::DMNorm;
+using jags::bugs::DMNormVC;
+using jags::bugs::DNorm;
+using jags::bugs::DWish;
+using jags::bugs::DGamma;
+using jags::bugs::Sum;
+using jags::bugs::InProd;
+using jags::bugs::AffineCoef;
+using jags::bugs::ChildValues;
+using jags::bugs::ConjugateDist;
+using jags::bugs::getDist;
+using jags::VectorLogicalNode;
+using jags::bugs::ConjugateWishart;
+using jags::bugs::chol_update;
+using jags::bugs::inverse_chol;
+
+/*
+  Samples f from the posterior of the model
+
+  f ~ prior(0, S)
+  y ~ dmnorm(f, P)
+
+  with y = (1, -1) and P = diag(1, 4), and compares the sample moments
+  with the exact posterior, which is normal with precision T + P and
+  mean (T + P)^-1 P y, where T is the prior precision.
+*/
+static void checkMNorm(ArrayDist const *prior, vector<double> const &S,
+		       vector<double> const &T)
+{
+    vector<unsigned long> d1(1, 2), d2(2, 2);
+    vector<double> zerov(2, 0), Pv = {1, 0, 0, 4};
+    ConstantNode mu(d1, zerov, 1, false), prec(d2, S, 1, false);
+    ConstantNode P(d2, Pv, 1, false);
+    vector<Node const *> fpar = {&mu, &prec};
+    ArrayStochasticNode f(prior, 1, fpar, 0, 0);
+    f.setValue(&zerov[0], 2, 0);
+
+    DMNorm dmnorm;
+    vector<Node const *> ypar = {&f, &P};
+    ArrayStochasticNode y(&dmnorm, 1, ypar, 0, 0);
+    double yv[2] = {1, -1};
+    y.setData(yv, 2);
+
+    Graph graph;
+    graph.insert(&f);
+    graph.insert(&y);
+    vector<StochasticNode*> nodes(1, &f);
+    GraphView gv(nodes, graph, true);
+
+    //Exact posterior
+    double A[4] = {T[0] + 1, T[1], T[2], T[3] + 4};
+    double det = A[0] * A[3] - A[1] * A[2];
+    double V[4] = {A[3] / det, -A[1] / det, -A[2] / det, A[0] / det};
+    double b[2] = {yv[0], 4 * yv[1]};
+    double m[2] = {V[0] * b[0] + V[2] * b[1], V[1] * b[0] + V[3] * b[1]};
+
+    EllipticalSlice ess(&gv, 0);
+    MersenneTwisterRNG rng(1234, jags::KINDERMAN_RAMAGE);
+    unsigned int const N = 20000;
+    double s[2] = {0, 0}, ss[2] = {0, 0}, s12 = 0;
+    for (unsigned int i = 0; i < N; ++i) {
+	ess.update(&rng);
+	double const *v = f.value(0);
+	for (unsigned int k = 0; k < 2; ++k) {
+	    s[k] += v[k];
+	    ss[k] += v[k] * v[k];
+	}
+	s12 += v[0] * v[1];
+    }
+    for (unsigned int k = 0; k < 2; ++k) {
+	double mean = s[k] / N;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(m[k], mean, 0.02);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(V[3 * k], ss[k] / N - mean * mean, 0.02);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(V[1], s12 / N - s[0] * s[1] / (N * N),
+				 0.02);
+}
+
+void BugsSampTest::ess_mnorm()
+{
+    //Prior given as a precision matrix (dmnorm) and as the
+    //equivalent variance matrix (dmnorm.vcov)
+    vector<double> T = {2, 0.5, 0.5, 1};
+    double det = T[0] * T[3] - T[1] * T[2];
+    vector<double> V = {T[3] / det, -T[1] / det, -T[2] / det, T[0] / det};
+
+    DMNorm dmnorm;
+    checkMNorm(&dmnorm, T, T);
+    DMNormVC dmnormvc;
+    checkMNorm(&dmnormvc, V, T);
+}
+
+void BugsSampTest::ess_norm()
+{
+    /*
+      a ~ dnorm(0, 2); y ~ dnorm(a, 4) with y = 1. The posterior of a
+      is normal with mean 2/3 and variance 1/6
+    */
+
+    DNorm dnorm;
+    ConstantNode zero(0, 1, false), two(2, 1, false), four(4, 1, false);
+    vector<Node const *> apar = {&zero, &two};
+    ScalarStochasticNode a(&dnorm, 1, apar, 0, 0);
+    double a0 = 0;
+    a.setValue(&a0, 1, 0);
+    vector<Node const *> ypar = {&a, &four};
+    ScalarStochasticNode y(&dnorm, 1, ypar, 0, 0);
+    double yv = 1;
+    y.setData(&yv, 1);
+
+    Graph graph;
+    graph.insert(&a);
+    graph.insert(&y);
+    vector<StochasticNode*> nodes(1, &a);
+    GraphView gv(nodes, graph, true);
+
+    EllipticalSlice ess(&gv, 0);
+    MersenneTwisterRNG rng(4321, jags::KINDERMAN_RAMAGE);
+    unsigned int const N = 20000;
+    double s = 0, ss = 0;
+    for (unsigned int i = 0; i < N; ++i) {
+	ess.update(&rng);
+	double v = a.value(0)[0];
+	s += v;
+	ss += v * v;
+    }
+    double mean = s / N;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0/3, mean, 0.02);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0/6, ss / N - mean * mean, 0.02);
+}
+
+/*
+  Returns the lower triangular Cholesky factor of A, with zeros in
+  the upper triangle
+*/
+static vector<double> cholesky(vector<double> const &A, int n)
+{
+    vector<double> L(A);
+    int info = 0;
+    F77_DPOTRF("L", &n, &L[0], &n, &info);
+    CPPUNIT_ASSERT(info == 0);
+    for (int j = 1; j < n; ++j) {
+	for (int i = 0; i < j; ++i) {
+	    L[i + n * j] = 0;
+	}
+    }
+    return L;
+}
+
+void BugsSampTest::cholupdate()
+{
+    //Successive rank-one updates of a Cholesky factor must agree
+    //with a fresh factorization of the updated matrix
+
+    int const n = 5;
+    vector<double> A(n * n, 0);
+    for (int i = 0; i < n; ++i) {
+	for (int j = 0; j < n; ++j) {
+	    A[i + n * j] = 1.0 / (1 + i + j);
+	}
+	A[i + n * i] += 1;
+    }
+    vector<double> L = cholesky(A, n);
+
+    for (unsigned int r = 0; r < 3; ++r) {
+	vector<double> v(n);
+	for (int i = 0; i < n; ++i) {
+	    v[i] = (i % 2 ? -1.0 : 1.0) * (r + 1) * (i + 0.5);
+	}
+	for (int i = 0; i < n; ++i) {
+	    for (int j = 0; j < n; ++j) {
+		A[i + n * j] += v[i] * v[j];
+	    }
+	}
+	chol_update(&L[0], &v[0], n);
+
+	vector<double> L2 = cholesky(A, n);
+	for (int j = 0; j < n; ++j) {
+	    for (int i = j; i < n; ++i) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(L2[i + n * j], L[i + n * j],
+					     1.0E-10 * (1 + fabs(L2[i + n * j])));
+	    }
+	}
+    }
+}
+
+void BugsSampTest::wishart_rank1()
+{
+    /*
+      Omega ~ dwish(R, k); y ~ dmnorm(0, Omega) with one observed y.
+      The posterior is Wishart with parameters R + y %*% t(y) and k +
+      1, and mean (k + 1) * inverse(R + y %*% t(y)). With one child
+      and 4 rows, ConjugateWishart updates the Cholesky factor of R by
+      a rank-one modification instead of factorizing the posterior
+      parameter.
+    */
+    unsigned int const n = 4;
+    vector<unsigned long> d1(1, n), d2(2, n);
+    vector<double> Rv(n * n, 0), zerov(n, 0), I(n * n, 0);
+    for (unsigned int i = 0; i < n; ++i) {
+	for (unsigned int j = 0; j < n; ++j) {
+	    Rv[i + n * j] = (i == j) ? 4 : 1;
+	}
+	I[i + n * i] = 1;
+    }
+    double const k = 6;
+    ConstantNode R(d2, Rv, 1, false), df(k, 1, false);
+    ConstantNode mu(d1, zerov, 1, false);
+
+    DWish dwish;
+    vector<Node const *> opar = {&R, &df};
+    ArrayStochasticNode omega(&dwish, 1, opar, 0, 0);
+    omega.setValue(&I[0], n * n, 0);
+
+    DMNorm dmnorm;
+    vector<Node const *> ypar = {&mu, &omega};
+    ArrayStochasticNode y(&dmnorm, 1, ypar, 0, 0);
+    double yv[n] = {1, -2, 0.5, 3};
+    y.setData(yv, n);
+
+    Graph graph;
+    graph.insert(&omega);
+    graph.insert(&y);
+    CPPUNIT_ASSERT(ConjugateWishart::canSample(&omega, graph));
+    SingletonGraphView gv(&omega, graph);
+    ConjugateWishart method(&gv);
+
+    //Exact posterior mean
+    vector<double> R1(Rv), M(n * n);
+    for (unsigned int i = 0; i < n; ++i) {
+	for (unsigned int j = 0; j < n; ++j) {
+	    R1[i + n * j] += yv[i] * yv[j];
+	}
+    }
+    CPPUNIT_ASSERT(inverse_chol(&M[0], &R1[0], n));
+
+    MersenneTwisterRNG rng(5678, jags::KINDERMAN_RAMAGE);
+    unsigned int const N = 20000;
+    vector<double> S(n * n, 0);
+    for (unsigned int r = 0; r < N; ++r) {
+	method.update(0, &rng);
+	double const *v = omega.value(0);
+	for (unsigned int i = 0; i < n * n; ++i) {
+	    S[i] += v[i];
+	}
+    }
+    for (unsigned int i = 0; i < n * n; ++i) {
+	CPPUNIT_ASSERT_DOUBLES_EQUAL((k + 1) * M[i], S[i] / N, 0.02);
+    }
+}
+
+/*
+  Coefficients of the parameters of the stochastic children,
+  calculated as the conjugate samplers did before AffineCoef: the
+  sampled node is shifted to x + 1 and back, and the difference in
+  each parameter is taken.
+*/
+static vector<double> shiftCoef(SingletonGraphView const &gv,
+				vector<unsigned int> const &param)
+{
+    vector<StochasticNode *> const &children = gv.stochasticChildren();
+    double x = gv.node()->value(0)[0];
+    vector<double> coef;
+    for (unsigned int i = 0; i < children.size(); ++i) {
+	Node const *par = children[i]->parents()[param[i]];
+	for (unsigned long j = 0; j < par->length(); ++j) {
+	    coef.push_back(-par->value(0)[j]);
+	}
+    }
+    double x1 = x + 1;
+    gv.setValue(&x1, 1, 0);
+    unsigned int k = 0;
+    for (unsigned int i = 0; i < children.size(); ++i) {
+	Node const *par = children[i]->parents()[param[i]];
+	for (unsigned long j = 0; j < par->length(); ++j) {
+	    coef[k++] += par->value(0)[j];
+	}
+    }
+    gv.setValue(&x, 1, 0);
+    return coef;
+}
+
+static void checkCoef(SingletonGraphView const &gv,
+		      vector<unsigned int> const &param, bool scale,
+		      bool fixed, map<Node const *, double> const &expected)
+{
+    vector<StochasticNode *> const &children = gv.stochasticChildren();
+    double x = gv.node()->value(0)[0];
+    vector<double> fd = shiftCoef(gv, param);
+
+    AffineCoef ac(&gv, param, scale);
+    CPPUNIT_ASSERT_EQUAL(fixed, ac.isFixed());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned long>(expected.size()),
+			 ac.length());
+    vector<double> work;
+    double const *coef = ac.coef(work, 0);
+    for (unsigned int i = 0; i < children.size(); ++i) {
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(fd[i], coef[i], 1.0E-10);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.find(children[i])->second,
+				     coef[i], 1.0E-10);
+    }
+    gv.setValue(&x, 1, 0);
+}
+
+void BugsSampTest::affine_coef()
+{
+    DNorm dnorm;
+    DGamma dgamma;
+    Sum sum;
+    InProd inprod;
+    ConstantNode zero(0, 1, false), one(1, 1, false), c(2.5, 1, false);
+    ConstantNode a(3, 1, false);
+
+    /*
+      Linear model with fixed coefficients:
+      y1 ~ dnorm(x + c, 1), y2 ~ dnorm(a * x + c, 1), y3 ~ dnorm(x, 1)
+      Then the same model with a stochastic coefficient a, for which
+      the coefficients are calculated on demand.
+    */
+    for (unsigned int k = 0; k < 2; ++k) {
+	vector<Node const *> apar = {&zero, &one};
+	ScalarStochasticNode as(&dnorm, 1, apar, 0, 0);
+	double av = 3;
+	as.setValue(&av, 1, 0);
+	Node const *ak = k == 0 ? static_cast<Node const*>(&a) : &as;
+
+	vector<Node const *> xpar = {&zero, &one};
+	ScalarStochasticNode x(&dnorm, 1, xpar, 0, 0);
+	vector<Node const *> p1 = {&x, &c}, p2 = {ak, &x};
+	VectorLogicalNode m1(&sum, 1, p1), m2(&inprod, 1, p2);
+	vector<Node const *> p3 = {&m2, &c};
+	VectorLogicalNode m3(&sum, 1, p3);
+	vector<Node const *> y1par = {&m1, &one}, y2par = {&m3, &one};
+	vector<Node const *> y3par = {&x, &one};
+	ScalarStochasticNode y1(&dnorm, 1, y1par, 0, 0);
+	ScalarStochasticNode y2(&dnorm, 1, y2par, 0, 0);
+	ScalarStochasticNode y3(&dnorm, 1, y3par, 0, 0);
+	double yv = 1;
+	y1.setData(&yv, 1);
+	y2.setData(&yv, 1);
+	y3.setData(&yv, 1);
+
+	Graph graph;
+	graph.insert(&as);
+	graph.insert(&x);
+	graph.insert(&m1);
+	graph.insert(&m2);
+	graph.insert(&m3);
+	graph.insert(&y1);
+	graph.insert(&y2);
+	graph.insert(&y3);
+	SingletonGraphView gv(&x, graph);
+	double x0 = 0.7;
+	gv.setValue(&x0, 1, 0);
+
+	vector<unsigned int> param(3, 0);
+	map<Node const *, double> expected = {{&y1, 1}, {&y2, 3}, {&y3, 1}};
+	checkCoef(gv, param, false, k == 0, expected);
+    }
+
+    /*
+      Scale model with a stochastic coefficient:
+      y1 ~ dnorm(0, a * t), y2 ~ dnorm(0, t)
+    */
+    vector<Node const *> apar = {&zero, &one};
+    ScalarStochasticNode as(&dnorm, 1, apar, 0, 0);
+    double av = 3;
+    as.setValue(&av, 1, 0);
+    vector<Node const *> tpar = {&one, &one};
+    ScalarStochasticNode t(&dgamma, 1, tpar, 0, 0);
+    vector<Node const *> p1 = {&as, &t};
+    VectorLogicalNode m1(&inprod, 1, p1);
+    vector<Node const *> y1par = {&zero, &m1}, y2par = {&zero, &t};
+    ScalarStochasticNode y1(&dnorm, 1, y1par, 0, 0);
+    ScalarStochasticNode y2(&dnorm, 1, y2par, 0, 0);
+    double yv = 1;
+    y1.setData(&yv, 1);
+    y2.setData(&yv, 1);
+
+    Graph graph;
+    graph.insert(&as);
+    graph.insert(&t);
+    graph.insert(&m1);
+    graph.insert(&y1);
+    graph.insert(&y2);
+    SingletonGraphView gv(&t, graph);
+    double t0 = 0.8;
+    gv.setValue(&t0, 1, 0);
+
+    vector<unsigned int> param(2, 1);
+    map<Node const *, double> expected = {{&y1, 3}, {&y2, 1}};
+    checkCoef(gv, param, true, false, expected);
+}
+
+void BugsSampTest::child_values()
+{
+    DNorm dnorm;
+    DGamma dgamma;
+    Sum sum;
+    unsigned int nchain = 2;
+    ConstantNode zero(0, nchain, false), one(1, nchain, false);
+    ConstantNode c(2.5, nchain, false);
+
+    /*
+      Children with different distributions, and with parameters that
+      are either the sampled node t or a deterministic function of it:
+      y1 ~ dnorm(t + c, t), y2 ~ dgamma(1, t), y3 ~ dnorm(0, t)
+    */
+    vector<Node const *> tpar = {&one, &one};
+    ScalarStochasticNode t(&dgamma, nchain, tpar, 0, 0);
+    vector<Node const *> mpar = {&t, &c};
+    VectorLogicalNode m(&sum, nchain, mpar);
+    vector<Node const *> y1par = {&m, &t}, y2par = {&one, &t};
+    vector<Node const *> y3par = {&zero, &t};
+    ScalarStochasticNode y1(&dnorm, nchain, y1par, 0, 0);
+    ScalarStochasticNode y2(&dgamma, nchain, y2par, 0, 0);
+    ScalarStochasticNode y3(&dnorm, nchain, y3par, 0, 0);
+    double yv[3] = {-1.5, 0.5, 2};
+    y1.setData(yv, 1);
+    y2.setData(yv + 1, 1);
+    y3.setData(yv + 2, 1);
+
+    Graph graph;
+    graph.insert(&t);
+    graph.insert(&m);
+    graph.insert(&y1);
+    graph.insert(&y2);
+    graph.insert(&y3);
+    SingletonGraphView gv(&t, graph);
+
+    vector<StochasticNode *> const &children = gv.stochasticChildren();
+    vector<ConjugateDist> dist;
+    for (unsigned int i = 0; i < children.size(); ++i) {
+	dist.push_back(getDist(children[i]));
+    }
+    ChildValues cv(&gv, dist, 2);
+
+    CPPUNIT_ASSERT_EQUAL(2U, cv.ngroup());
+    CPPUNIT_ASSERT_EQUAL(0UL, cv.begin(0));
+    CPPUNIT_ASSERT_EQUAL(3UL, cv.end(cv.ngroup() - 1));
+    for (unsigned int g = 0; g < cv.ngroup(); ++g) {
+	for (unsigned long j = cv.begin(g); j < cv.end(g); ++j) {
+	    CPPUNIT_ASSERT_EQUAL(cv.dist(g), dist[cv.index()[j]]);
+	}
+    }
+
+    /*
+      After the sampled node changes, the gathered pointers must give
+      the same values as a fresh read from the children
+    */
+    for (unsigned int r = 0; r < 3; ++r) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double tv = 0.5 + r + ch;
+	    gv.setValue(&tv, 1, ch);
+	}
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    for (unsigned long j = 0; j < children.size(); ++j) {
+		StochasticNode const *child = children[cv.index()[j]];
+		CPPUNIT_ASSERT_EQUAL(child->value(ch)[0],
+				     cv.value(ch)[j][0]);
+		for (unsigned int k = 0; k < 2; ++k) {
+		    CPPUNIT_ASSERT_EQUAL(child->parents()[k]->value(ch)[0],
+					 cv.param(k, ch)[j][0]);
+		}
+	    }
+	}
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef BUGS_SAMP_TEST_H
+#define BUGS_SAMP_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+class BugsSampTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( BugsSampTest );
+    CPPUNIT_TEST( ess_mnorm );
+    CPPUNIT_TEST( ess_norm );
+    CPPUNIT_TEST( cholupdate );
+    CPPUNIT_TEST( wishart_rank1 );
+    CPPUNIT_TEST( affine_coef );
+    CPPUNIT_TEST( child_values );
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void ess_mnorm();
+    void ess_norm();
+    void cholupdate();
+    void wishart_rank1();
+    void affine_coef();
+    void child_values();
+};
+
+#endif  // BUGS_SAMP_TEST_H
@@ -1,9 +1,13 @@
 #include "testbugs.h"
 #include "functions/testbugsfun.h"
 #include "distributions/testbugsdist.h"
+#include "distributions/testbugsgrad.h"
+#include "samplers/testbugssamp.h"
 #include <cppunit/extensions/HelperMacros.h>
 
 void init_bugs_test() {
     CPPUNIT_TEST_SUITE_REGISTRATION( BugsFunTest );
     //CPPUNIT_TEST_SUITE_REGISTRATION( BugsDistTest );
+    CPPUNIT_TEST_SUITE_REGISTRATION( BugsGradTest );
+    CPPUNIT_TEST_SUITE_REGISTRATION( BugsSampTest );
 }
@@ -40,11 +40,7 @@ namespace glm {
 	//   of the sampled nodes, as the origin
 
 	// Update outcomes
-	for (vector<Outcome*>::const_iterator p = _outcomes.begin();
-	     p != _outcomes.end(); ++p)
-	{
-	    (*p)->update(rng);
-	}
+	updateOutcomes(rng);
 	
 	double *b = 0;
 	cholmod_sparse *A = 0;
@@ -54,7 +50,7 @@ namespace glm {
 	A->stype = -1;
         #pragma omp critical
 	{
-	    int ok = cholmod_factorize(A, _factor, glm_wk);
+	    int ok = updateFactor(A);
 	    cholmod_free_sparse(&A, glm_wk);
 	    if (!ok) {
 		throwRuntimeError("Cholesky decomposition failure in GLMBlock");
@@ -82,10 +78,12 @@ namespace glm {
 	updateAuxiliary(u1, _factor, rng);
 
 	double *u1x = static_cast<double*>(u1->x);
+	vector<double> eps(nrow);
+	rng->normal(&eps[0], nrow);
 	if (_factor->is_ll) {
 	    // LL' decomposition
 	    for (unsigned int r = 0; r < nrow; ++r) {
-		u1x[r] += rng->normal();
+		u1x[r] += eps[r];
 	    }
 	}
 	else {
@@ -94,7 +92,7 @@ namespace glm {
 	    int *fp = static_cast<int*>(_factor->p);
 		double *fx = static_cast<double*>(_factor->x);
 		for (unsigned int r = 0; r < nrow; ++r) {
-		    u1x[r] += rng->normal() * sqrt(fx[fp[r]]);
+		    u1x[r] += eps[r] * sqrt(fx[fp[r]]);
 		}
 	}
 
@@ -18,6 +18,7 @@
 
 #include "GLMBlock.h"
 #include "GLMGibbs.h"
+#include "GLMPerturb.h"
 
 #include <graph/StochasticNode.h>
 #include <graph/LinkNode.h>
@@ -27,11 +28,22 @@
 
 using std::vector;
 
+/*
+  By default, blocks of at least this length are sampled with the
+  matrix-free GLMPerturb method, as the Cholesky factor of the
+  posterior precision may be too large to hold in memory.
+*/
+#define PERTURB_MIN_LENGTH 100000
+
 namespace jags {
 namespace glm {
 
     GLMGenericFactory::GLMGenericFactory()
-	: GLMFactory("glm::Generic")
+	: GLMFactory("glm::Generic"), _perturb_min(PERTURB_MIN_LENGTH)
+    {}
+
+    GLMGenericFactory::GLMGenericFactory(unsigned long perturb_min)
+	: GLMFactory("glm::Generic"), _perturb_min(perturb_min)
     {}
 
     bool GLMGenericFactory::checkOutcome(StochasticNode const *snode) const
@@ -100,6 +112,9 @@ namespace glm {
 	if (gibbs) {
 	    return new GLMGibbs(view, sub_views, outcomes, chain);
 	}
+	else if (view->length() >= _perturb_min) {
+	    return new GLMPerturb(view, sub_views, outcomes, chain);
+	}
 	else {
 	    return new GLMBlock(view, sub_views, outcomes, chain);
 	}
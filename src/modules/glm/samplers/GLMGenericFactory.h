@@ -11,8 +11,20 @@ namespace glm {
      */
     class GLMGenericFactory : public GLMFactory
     {
+	unsigned long _perturb_min;
       public:
+	/**
+	 * Constructor. Blocks with at least 100000 coefficients are
+	 * sampled with the matrix-free GLMPerturb method.
+	 */
 	GLMGenericFactory();
+	/**
+	 * Constructor with a given threshold for the GLMPerturb method.
+	 *
+	 * @param perturb_min Minimum length of a block that is sampled
+	 * with GLMPerturb instead of GLMBlock
+	 */
+	GLMGenericFactory(unsigned long perturb_min);
 	/**
 	 * Returns true if the outcome can be represented as a mixture
 	 * of normals.
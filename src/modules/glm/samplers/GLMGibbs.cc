@@ -39,11 +39,7 @@ namespace glm {
 	// necessary for truncated parameters
 
 	// Update outcomes
-	for (vector<Outcome*>::const_iterator p = _outcomes.begin();
-	     p != _outcomes.end(); ++p)
-	{
-	    (*p)->update(rng);
-	}
+	updateOutcomes(rng);
 	
 	double *b = 0;
 	cholmod_sparse *A = 0;
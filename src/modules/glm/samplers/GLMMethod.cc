@@ -1,9 +1,11 @@
 #include <config.h>
 
 #include <set>
+#include <map>
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <typeinfo>
 
 #include "GLMMethod.h"
 #include "Outcome.h"
@@ -23,11 +25,19 @@
 using std::string;
 using std::vector;
 using std::set;
+using std::map;
 using std::copy;
 using std::sqrt;
 
 extern cholmod_common *glm_wk;
 
+// Maximum rank of a modification to the posterior precision that is
+// handled by updating the existing Cholesky factor
+#define MAX_UPDOWN_RANK 32
+// Number of consecutive low-rank updates after which the posterior
+// precision and its factor are recalculated from scratch
+#define MAX_UPDOWN 100
+
 namespace jags {
 
 static void getIndices(set<StochasticNode *> const &schildren,
@@ -48,6 +58,74 @@ static void getIndices(set<StochasticNode *> const &schildren,
 
 namespace glm {
 
+    /*
+      Structures that are identical for all chains: the sparsity
+      pattern of the design matrix and the symbolic Cholesky factor
+      of the posterior precision. They are calculated by the first
+      GLMMethod to be created for a given GraphView and shared with
+      the GLMMethods for the other chains. The last one to be
+      destroyed frees them.
+    */
+    struct GLMSymbolic {
+	cholmod_sparse *pattern;
+	cholmod_factor *factor;
+	unsigned int count;
+	GLMSymbolic() : pattern(0), factor(0), count(0) {}
+    };
+
+    static map<GraphView const *, GLMSymbolic> &symbolicMap()
+    {
+	static map<GraphView const *, GLMSymbolic> _map;
+	return _map;
+    }
+
+    static cholmod_sparse *
+    makePattern(GraphView const *view,
+		vector<SingletonGraphView const *> const &sub_views)
+    {
+	vector<StochasticNode *> const &schildren = 
+	    view->stochasticChildren();
+
+	vector<unsigned int> rows(schildren.size() + 1);
+	rows[0] = 0;
+	for (unsigned int i = 0; i < schildren.size(); ++i) {
+	    rows[i+1] = rows[i] + schildren[i]->length();
+	}
+	int ncol = view->length();
+	int nrow = rows[schildren.size()];
+	
+	vector<int> Xp(ncol + 1);
+	vector<int> Xi;
+    
+	int c = 0; //column counter
+	int r = 0; //count of number of non-zero entries
+
+	for (unsigned int p = 0; p < sub_views.size(); ++p) {
+
+	    set<StochasticNode *> children_p;
+	    children_p.insert(sub_views[p]->stochasticChildren().begin(),
+			      sub_views[p]->stochasticChildren().end());
+	    vector<int> indices;
+	    getIndices(children_p, schildren, rows, indices);
+
+	    unsigned int length = sub_views[p]->length();
+	    for (unsigned int i = 0; i < length; ++i, ++c) {
+		Xp[c] = r;
+		for (unsigned int j = 0; j < indices.size(); ++j, ++r) {
+		    Xi.push_back(indices[j]);
+		}
+	    }
+	}
+	Xp[c] = r;
+
+	cholmod_sparse *pattern =
+	    cholmod_allocate_sparse(nrow, ncol, r, 1, 1, 0, CHOLMOD_PATTERN,
+				    glm_wk);
+	copy(Xp.begin(), Xp.end(), static_cast<int*>(pattern->p));
+	copy(Xi.begin(), Xi.end(), static_cast<int*>(pattern->i));
+	return pattern;
+    }
+
     void GLMMethod::calDesign() const
     {
 	if (allTrue(_fixed)) return; //Move along, nothing to see here
@@ -119,60 +197,42 @@ namespace glm {
 			 unsigned int chain)
 	: _view(view), _chain(chain), _sub_views(sub_views),
 	  _outcomes(outcomes),
-	  _x(0), _factor(0), _fixed(sub_views.size(), false), 
-	  _length_max(0), _nz_prior(0)
+	  _x(0), _factor(0), _fixed(sub_views.size(), false),
+	  _length_max(0), _nz_prior(0), _cacheable(false),
+	  _tx_cache(0), _A_cache(0), _Cplus(0), _Cminus(0),
+	  _A_version(0), _factor_version(0), _nupdown(0), _factor_stale(false)
     {
 	view->checkFinite(chain); //Check validity of initial values
 	
-	vector<StochasticNode *> const &schildren = 
-	    view->stochasticChildren();
-
-	vector<unsigned int> rows(schildren.size() + 1);
-	rows[0] = 0;
-	for (unsigned int i = 0; i < schildren.size(); ++i) {
-	    rows[i+1] = rows[i] + schildren[i]->length();
-	}
-	int ncol = view->length();
-	int nrow = rows[schildren.size()];
-	
-	vector<int> Xp(ncol + 1);
-	vector<int> Xi;
-    
-	int c = 0; //column counter
-	int r = 0; //count of number of non-zero entries
-
 	for (unsigned int p = 0; p < _sub_views.size(); ++p) {
-
-	    set<StochasticNode *> children_p;
-	    children_p.insert(sub_views[p]->stochasticChildren().begin(),
-			      sub_views[p]->stochasticChildren().end());
-	    vector<int> indices;
-	    getIndices(children_p, schildren, rows, indices);
-
-	    unsigned int length = _sub_views[p]->length();
-	    for (unsigned int i = 0; i < length; ++i, ++c) {
-		Xp[c] = r;
-		for (unsigned int j = 0; j < indices.size(); ++j, ++r) {
-		    Xi.push_back(indices[j]);
-		}
-	    }
-
 	    //Save these values for later calculations
+	    unsigned int length = _sub_views[p]->length();
 	    _nz_prior += length * length; //No. of non-zeros in prior precision
 	    if (length > _length_max) {
 		_length_max = length; //Length of longest sampled node
 	    }
 	}
-	Xp[c] = r;
 
-	//Set up sparse representation of the design matrix
+	//Set up sparse representation of the design matrix, sharing
+	//the sparsity pattern with other chains
+	cholmod_sparse *pattern = 0;
 	#pragma omp critical
-	_x = cholmod_allocate_sparse(nrow, ncol, r, 1, 1, 0, CHOLMOD_REAL, glm_wk);
-	int *_xp = static_cast<int*>(_x->p);
-	int *_xi = static_cast<int*>(_x->i);
-
-	copy(Xp.begin(), Xp.end(), _xp);
-	copy(Xi.begin(), Xi.end(), _xi);
+	{
+	    GLMSymbolic &sym = symbolicMap()[view];
+	    if (sym.pattern == 0) {
+		sym.pattern = makePattern(view, sub_views);
+	    }
+	    sym.count++;
+	    pattern = sym.pattern;
+
+	    _x = cholmod_allocate_sparse(pattern->nrow, pattern->ncol,
+					 pattern->nzmax, 1, 1, 0,
+					 CHOLMOD_REAL, glm_wk);
+	    cholmod_free(_x->ncol + 1, sizeof(int), _x->p, glm_wk);
+	    cholmod_free(_x->nzmax, sizeof(int), _x->i, glm_wk);
+	    _x->p = pattern->p;
+	    _x->i = pattern->i;
+	}
 
 	// At this point, all elements of _fixed are set to false, so
 	// a call to calDesign calculates the whole design matrix
@@ -185,6 +245,27 @@ namespace glm {
 	    // still works correctly for log-linear models.
 	    _fixed[i] = checkLinear(sub_views[i], true, true);
 	}
+
+	// Group consecutive outcomes of the same class into batches
+	// that can be updated together by updateOutcomes
+	_batch.push_back(0);
+	for (unsigned int i = 1; i < _outcomes.size(); ++i) {
+	    if (typeid(*_outcomes[i]) != typeid(*_outcomes[i-1])) {
+		_batch.push_back(i);
+	    }
+	}
+	_batch.push_back(_outcomes.size());
+
+	// The likelihood contribution to the posterior precision can
+	// be cached if it does not depend on the current values of
+	// the sampled nodes or the auxiliary variables
+	_cacheable = allTrue(_fixed);
+	for (unsigned int i = 0; i < _outcomes.size(); ++i) {
+	    if (!_outcomes[i]->fixedA()) {
+		_cacheable = false;
+		break;
+	    }
+	}
     }
 
     GLMMethod::~GLMMethod()
@@ -194,9 +275,38 @@ namespace glm {
 	    _outcomes.pop_back();
 	}
 	#pragma omp critical
-	cholmod_free_sparse(&_x, glm_wk);
+	{
+	    // The sparsity pattern of _x and the symbolic factor belong
+	    // to the shared GLMSymbolic object
+	    _x->p = 0;
+	    _x->i = 0;
+	    cholmod_free_sparse(&_x, glm_wk);
+	    cholmod_free_factor(&_factor, glm_wk);
+	    map<GraphView const *, GLMSymbolic>::iterator p =
+		symbolicMap().find(_view);
+	    if (--p->second.count == 0) {
+		cholmod_free_sparse(&p->second.pattern, glm_wk);
+		cholmod_free_factor(&p->second.factor, glm_wk);
+		symbolicMap().erase(p);
+	    }
+	    cholmod_free_sparse(&_tx_cache, glm_wk);
+	    cholmod_free_sparse(&_A_cache, glm_wk);
+	    cholmod_free_sparse(&_Cplus, glm_wk);
+	    cholmod_free_sparse(&_Cminus, glm_wk);
+	}
     }
     
+    void GLMMethod::updateOutcomes(RNG *rng)
+    {
+	for (unsigned int k = 0; k + 1 < _batch.size(); ++k) {
+	    unsigned int start = _batch[k];
+	    unsigned int n = _batch[k+1] - start;
+	    if (n > 0) {
+		_outcomes[start]->updateBatch(&_outcomes[start], n, rng);
+	    }
+	}
+    }
+
     /* 
        Symbolic analysis of the posterior precision matrix for the
        Cholesky decomposition.
@@ -207,6 +317,20 @@ namespace glm {
        referenced.
     */
     void GLMMethod::symbolic()  
+    {
+	// The symbolic factor is the same for all chains, so it is
+	// calculated once and copied
+	#pragma omp critical
+	{
+	    GLMSymbolic &sym = symbolicMap()[_view];
+	    if (sym.factor == 0) {
+		sym.factor = analyze();
+	    }
+	    _factor = cholmod_copy_factor(sym.factor, glm_wk);
+	}
+    }
+
+    cholmod_factor *GLMMethod::analyze() const
     {
 	unsigned int nrow = _view->length();
 
@@ -251,8 +375,9 @@ namespace glm {
 	cholmod_free_sparse(&Alik, glm_wk);
 	
 	A->stype = -1;
-	_factor = cholmod_analyze(A, glm_wk); 
+	cholmod_factor *F = cholmod_analyze(A, glm_wk); 
 	cholmod_free_sparse(&A, glm_wk);
+	return F;
     }
 
     void GLMMethod::calCoef(double *&b, cholmod_sparse *&A) 
@@ -307,6 +432,40 @@ namespace glm {
 	// Recalculate the design matrix, if necessary
 	calDesign();
 
+	// With a fixed design matrix, A depends only on the prior and
+	// outcome precisions. If these are the same as in the last
+	// call, or differ only in a few places, we can use the cached
+	// values.
+	vector<double> prec;
+	if (_cacheable) {
+	    prec.assign(Ax, Ax + r);
+	    for (unsigned int i = 0; i < _outcomes.size(); ++i) {
+		unsigned int m = _outcomes[i]->length();
+		if (m == 1) {
+		    prec.push_back(_outcomes[i]->precision());
+		}
+		else {
+		    double const *tau = _outcomes[i]->vprecision();
+		    prec.insert(prec.end(), tau, tau + m * m);
+		}
+	    }
+	    if (_A_cache && (prec == _prec_cache || lowRankUpdate(prec))) {
+		#pragma omp critical
+		cholmod_free_sparse(&Aprior, glm_wk);
+		calCoefCached(b, A);
+		return;
+	    }
+	}
+	++_A_version;
+	_nupdown = 0;
+	// Any low-rank modification belongs to an earlier version of A,
+	// so the factor must not be updated with it
+	#pragma omp critical
+	{
+	    cholmod_free_sparse(&_Cplus, glm_wk);
+	    cholmod_free_sparse(&_Cminus, glm_wk);
+	}
+
 	// Likelihood contributions
 	//   
 	//   b += t(X) %*% tau %*% (Y - mu)
@@ -327,6 +486,9 @@ namespace glm {
 	{
 	    t_x = cholmod_transpose(_x, 1, glm_wk);
 	    cholmod_sort(t_x, glm_wk); //Needed for multivariate outcomes
+	    if (_cacheable && !_tx_cache) {
+		_tx_cache = cholmod_copy_sparse(t_x, glm_wk);
+	    }
 	}
 	
 	int *Tp = static_cast<int*>(t_x->p);
@@ -416,13 +578,243 @@ namespace glm {
 	{
 	    cholmod_sparse *Alik = cholmod_ssmult(t_x, _x, CHOLMOD_REAL, 1, 0,
 						  glm_wk);
-	    cholmod_free_sparse(&t_x, glm_wk);
 	    double one[2] = {1, 0};
 	    A = cholmod_add(Aprior, Alik, one, one, 1, 0, glm_wk);
 	    
 	    cholmod_free_sparse(&Aprior, glm_wk);
 	    cholmod_free_sparse(&Alik, glm_wk);
+	    cholmod_free_sparse(&t_x, glm_wk);
+
+	    if (_cacheable) {
+		// Keep A for the next iteration
+		cholmod_free_sparse(&_A_cache, glm_wk);
+		_A_cache = cholmod_copy_sparse(A, glm_wk);
+	    }
+	}
+	if (_cacheable) {
+	    _prec_cache = prec;
+	}
+    }
+
+    void GLMMethod::calCoefCached(double *b, cholmod_sparse *&A) const
+    {
+	//   Likelihood contribution to b, calculated from the cached
+	//   transpose of the design matrix
+	//
+	//   b += t(X) %*% tau %*% (Y - mu)
+
+	int const *Tp = static_cast<int const*>(_tx_cache->p);
+	int const *Ti = static_cast<int const*>(_tx_cache->i);
+	double const *Tx = static_cast<double const*>(_tx_cache->x);
+
+	int c = 0;
+	for (unsigned int i = 0; i < _outcomes.size(); ++i) {
+	    unsigned int m = _outcomes[i]->length();
+	    if (m == 1) {
+		double delta = _outcomes[i]->precision() *
+		    (_outcomes[i]->value() - _outcomes[i]->mean());
+		for (int r = Tp[c]; r < Tp[c+1]; ++r) {
+		    b[Ti[r]] += Tx[r] * delta;
+		}
+	    }
+	    else {
+		double const *tau = _outcomes[i]->vprecision();
+		double const *Y = _outcomes[i]->vvalue();
+		double const *mu = _outcomes[i]->vmean();
+
+		vector<double> delta(m, 0);
+		for (unsigned int j = 0; j < m; ++j) {
+		    for (unsigned int k = 0; k < m; ++k) {
+			delta[j] += tau[m*j+k] * (Y[k] - mu[k]);
+		    }
+		}
+
+		// Columns of t(X) corresponding to the same outcome
+		// have the same non-zero pattern (checked by calCoef)
+		int nzrow = Tp[c+1] - Tp[c];
+		for (int r = Tp[c]; r < Tp[c+1]; ++r) {
+		    for (unsigned int j = 0; j < m; ++j) {
+			b[Ti[r]] += Tx[r + j*nzrow] * delta[j];
+		    }
+		}
+	    }
+	    c += m;
+	}
+
+	#pragma omp critical
+	A = cholmod_copy_sparse(_A_cache, glm_wk);
+    }
+
+    static void addColumn(vector<int> &Cp, vector<int> &Ci,
+			  vector<double> &Cx, int const *rows,
+			  double const *x, int n, double scale)
+    {
+	for (int k = 0; k < n; ++k) {
+	    Ci.push_back(rows[k]);
+	    Cx.push_back(x[k] * scale);
+	}
+	Cp.push_back(Ci.size());
+    }
+
+    static cholmod_sparse *
+    makeSparse(int nrow, vector<int> const &Cp, vector<int> const &Ci,
+	       vector<double> const &Cx)
+    {
+	int ncol = Cp.size() - 1;
+	if (ncol == 0) return 0;
+
+	cholmod_sparse *C = cholmod_allocate_sparse(nrow, ncol, Ci.size(),
+						    1, 1, 0, CHOLMOD_REAL,
+						    glm_wk);
+	copy(Cp.begin(), Cp.end(), static_cast<int*>(C->p));
+	copy(Ci.begin(), Ci.end(), static_cast<int*>(C->i));
+	copy(Cx.begin(), Cx.end(), static_cast<double*>(C->x));
+	return C;
+    }
+
+    static cholmod_sparse *addOuter(cholmod_sparse *A, cholmod_sparse *C,
+				    double sign)
+    {
+	// Returns A + sign * C %*% t(C) and frees A
+	if (C == 0) return A;
+
+	cholmod_sparse *CCt = cholmod_aat(C, 0, 0, 1, glm_wk);
+	double alpha[2] = {1, 0};
+	double beta[2] = {sign, 0};
+	cholmod_sparse *B = cholmod_add(A, CCt, alpha, beta, 1, 1, glm_wk);
+	cholmod_free_sparse(&CCt, glm_wk);
+	cholmod_free_sparse(&A, glm_wk);
+	return B;
+    }
+
+    bool GLMMethod::lowRankUpdate(vector<double> const &prec)
+    {
+	/*
+	  Expresses the change in A since the last call to calCoef as
+	  a low-rank modification
+
+	  A_new = A_old + Cplus %*% t(Cplus) - Cminus %*% t(Cminus)
+
+	  This is possible when the only precisions that have changed
+	  belong to scalar sampled nodes or scalar outcomes. A change d
+	  in the prior precision of the sampled node in column c
+	  contributes sqrt(|d|) * e_c, and a change d in the precision
+	  of a scalar outcome contributes sqrt(|d|) times the
+	  corresponding row of the design matrix.
+
+	  Returns false, without modifying anything, if the change is
+	  not of this form.
+	*/
+	
+	if (_nupdown >= MAX_UPDOWN) {
+	    // Refresh A and its factor to control rounding error
+	    return false;
+	}
+
+	int nrow = _view->length();
+	vector<int> Pp(1, 0), Pi, Mp(1, 0), Mi;
+	vector<double> Px, Mx;
+	unsigned int rank = 0;
+
+	// Prior contributions
+	unsigned int k = 0; // index of prec
+	int c = 0; // column of A
+	vector<StochasticNode*> const &snodes = _view->nodes();
+	for (unsigned int i = 0; i < snodes.size(); ++i) {
+	    unsigned int length = snodes[i]->length();
+	    unsigned int n = length * length;
+	    if (!std::equal(prec.begin() + k, prec.begin() + k + n,
+			    _prec_cache.begin() + k))
+	    {
+		if (length != 1 || ++rank > MAX_UPDOWN_RANK) return false;
+		double d = prec[k] - _prec_cache[k];
+		double one = 1;
+		if (d > 0) addColumn(Pp, Pi, Px, &c, &one, 1, sqrt(d));
+		else addColumn(Mp, Mi, Mx, &c, &one, 1, sqrt(-d));
+	    }
+	    k += n;
+	    c += length;
+	}
+
+	// Likelihood contributions
+	int const *Tp = static_cast<int const*>(_tx_cache->p);
+	int const *Ti = static_cast<int const*>(_tx_cache->i);
+	double const *Tx = static_cast<double const*>(_tx_cache->x);
+	c = 0; // column of t(X)
+	for (unsigned int i = 0; i < _outcomes.size(); ++i) {
+	    unsigned int m = _outcomes[i]->length();
+	    unsigned int n = m * m;
+	    if (!std::equal(prec.begin() + k, prec.begin() + k + n,
+			    _prec_cache.begin() + k))
+	    {
+		if (m != 1 || ++rank > MAX_UPDOWN_RANK) return false;
+		double d = prec[k] - _prec_cache[k];
+		int nz = Tp[c+1] - Tp[c];
+		if (d > 0) {
+		    addColumn(Pp, Pi, Px, Ti + Tp[c], Tx + Tp[c], nz, sqrt(d));
+		}
+		else {
+		    addColumn(Mp, Mi, Mx, Ti + Tp[c], Tx + Tp[c], nz, sqrt(-d));
+		}
+	    }
+	    k += n;
+	    c += m;
+	}
+
+	#pragma omp critical
+	{
+	    cholmod_free_sparse(&_Cplus, glm_wk);
+	    cholmod_free_sparse(&_Cminus, glm_wk);
+	    _Cplus = makeSparse(nrow, Pp, Pi, Px);
+	    _Cminus = makeSparse(nrow, Mp, Mi, Mx);
+	    _A_cache = addOuter(_A_cache, _Cplus, 1);
+	    _A_cache = addOuter(_A_cache, _Cminus, -1);
+	}
+	
+	_prec_cache = prec;
+	++_A_version;
+	++_nupdown;
+	return true;
+    }
+
+    static bool updown(int update, cholmod_sparse *C, cholmod_factor *L)
+    {
+	// Rows of C must be permuted to match the factor
+	if (C == 0) return true;
+	cholmod_sparse *PC = cholmod_submatrix(C, static_cast<int*>(L->Perm),
+					       C->nrow, 0, -1, 1, 1, glm_wk);
+	bool ok = cholmod_updown(update, PC, L, glm_wk);
+	cholmod_free_sparse(&PC, glm_wk);
+	return ok;
+    }
+
+    bool GLMMethod::updateFactor(cholmod_sparse *A, bool current)
+    {
+	if (!current) {
+	    // The factor will not match any version of A
+	    _factor_stale = true;
+	    return cholmod_factorize(A, _factor, glm_wk);
+	}
+
+	if (_cacheable && !_factor_stale && _factor_version == _A_version) {
+	    // Factor is up to date
+	    return true;
+	}
+
+	bool ok = false;
+	if (_cacheable && !_factor_stale && _factor_version + 1 == _A_version
+	    && (_Cplus || _Cminus))
+	{
+	    // A has changed by a low-rank modification since the
+	    // factor was last updated
+	    ok = updown(1, _Cplus, _factor) && updown(0, _Cminus, _factor);
+	}
+	if (!ok) {
+	    ok = cholmod_factorize(A, _factor, glm_wk);
 	}
+	_factor_version = _A_version;
+	_factor_stale = false;
+	return ok;
     }
 
     bool GLMMethod::isAdaptive() const
@@ -46,10 +46,22 @@ namespace glm {
 	cholmod_factor *_factor; //???
 	void symbolic();
 	void calDesign() const;
+	void updateOutcomes(RNG *rng);
     private:
 	std::vector<bool> _fixed;
+	std::vector<unsigned int> _batch;
 	unsigned int _length_max;
 	unsigned _nz_prior;
+	bool _cacheable;
+	std::vector<double> _prec_cache;
+	cholmod_sparse *_tx_cache;
+	cholmod_sparse *_A_cache;
+	cholmod_sparse *_Cplus, *_Cminus;
+	unsigned int _A_version, _factor_version, _nupdown;
+	bool _factor_stale;
+	void calCoefCached(double *b, cholmod_sparse *&A) const;
+	cholmod_factor *analyze() const;
+	bool lowRankUpdate(std::vector<double> const &prec);
 	friend class REMethod2;
     public:
 	/**
@@ -88,8 +100,36 @@ namespace glm {
 	 * is the posterior mean and "A" is the posterior precision.
 	 *
 	 * @param A Posterior precision represented as a sparse matrix.
+	 *
+	 * When the design matrix is fixed and the precisions of all
+	 * outcomes are fixed at any given iteration, A and the
+	 * transpose of the design matrix are cached. If the prior and
+	 * outcome precisions have not changed since the last call, A
+	 * is copied from the cache. If only a few scalar precisions
+	 * have changed, the cached value of A is modified by a
+	 * low-rank update, which is also used by updateFactor.
 	 */
 	void calCoef(double *&b, cholmod_sparse *&A);
+	/**
+	 * Updates the Cholesky factor _factor so that it is the
+	 * factorization of the posterior precision A returned by the
+	 * last call to calCoef. If A is unchanged since _factor was
+	 * last updated, nothing is done. If A differs by a low-rank
+	 * modification, the factor is modified with cholmod_updown.
+	 * Otherwise A is factorized from scratch.
+	 *
+	 * This function must be called inside an OpenMP critical
+	 * section, like other CHOLMOD calls.
+	 *
+	 * @param A Posterior precision
+	 * @param current Indicates whether A was returned by the last
+	 * call to calCoef. If false, A is an earlier value of the
+	 * posterior precision, which is factorized from scratch, and
+	 * the next call must also factorize from scratch.
+	 *
+	 * @return true on success, false if the factorization failed
+	 */
+	bool updateFactor(cholmod_sparse *A, bool current = true);
 	/**
 	 * Returns false. Sampling methods inheriting from GLMMethod
 	 * are not adaptive.
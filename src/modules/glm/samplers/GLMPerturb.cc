@@ -0,0 +1,309 @@
+#include <config.h>
+
+#include "GLMPerturb.h"
+#include "Outcome.h"
+
+#include <sampler/GraphView.h>
+#include <graph/StochasticNode.h>
+#include <module/ModuleError.h>
+#include <rng/RNG.h>
+#include <util/nainf.h>
+
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <utility>
+
+using std::vector;
+using std::map;
+using std::make_pair;
+using std::sqrt;
+using std::copy;
+using std::fill;
+
+// Relative tolerance of the conjugate gradient solver
+#define PCG_TOL 1.0E-10
+
+#define F77_DPOTRF F77_FUNC(dpotrf,DPOTRF)
+
+extern "C" {
+    void F77_DPOTRF (const char *uplo, const int *n, double *a,
+		     const int *lda, const int *info);
+}
+
+/*
+  Adds a random vector with mean zero and variance matrix T, as the
+  perturbation of a prior or likelihood term of the canonical
+  parameter b. We need L %*% z, where L is the Cholesky factor of T
+  and z is a vector of independent standard normals.
+
+  Many terms may share the same matrix T, e.g. the precision of a
+  multivariate normal outcome, so each Cholesky factor is calculated
+  once per update and stored in "factors", keyed on the address of T.
+*/
+static void addNoise(double *b, double const *T, unsigned int n,
+		     map<double const *, vector<double> > &factors,
+		     jags::RNG *rng)
+{
+    if (n == 1) {
+	b[0] += sqrt(T[0]) * rng->normal();
+	return;
+    }
+
+    map<double const *, vector<double> >::iterator p = factors.find(T);
+    if (p == factors.end()) {
+	p = factors.insert(make_pair(T, vector<double>(T, T + n * n))).first;
+	int ni = n;
+	int info = 0;
+	F77_DPOTRF("L", &ni, &p->second[0], &ni, &info);
+	if (info != 0) {
+	    jags::throwRuntimeError("Cholesky decomposition failure in GLMPerturb");
+	}
+    }
+    double const *L = &p->second[0];
+
+    vector<double> z(n);
+    rng->normal(&z[0], n);
+    for (unsigned int i = 0; i < n; ++i) {
+	for (unsigned int j = 0; j <= i; ++j) {
+	    b[i] += L[i + n * j] * z[j];
+	}
+    }
+}
+
+namespace jags {
+
+namespace glm {
+
+    GLMPerturb::GLMPerturb(GraphView const *view,
+			   vector<SingletonGraphView const *> const &sub_views,
+			   vector<Outcome *> const &outcomes,
+			   unsigned int chain)
+	: GLMMethod(view, sub_views, outcomes, chain),
+	  _r(view->length()), _z(view->length()), _p(view->length()),
+	  _Ap(view->length()), _u(_x->nrow)
+    {
+    }
+
+    void GLMPerturb::multA(double const *v, double *Av)
+    {
+	// Calculates Av = A %*% v without forming A, where A is the
+	// posterior precision t(X) %*% tau %*% X + prior precision
+
+	// Prior contribution: the prior precision is block diagonal
+	unsigned int c = 0;
+	vector<StochasticNode*> const &snodes = _view->nodes();
+	for (vector<StochasticNode*>::const_iterator p = snodes.begin();
+	     p != snodes.end(); ++p)
+	{
+	    double const *priorprec = (*p)->parents()[1]->value(_chain);
+	    unsigned int length = (*p)->length();
+	    for (unsigned int i = 0; i < length; ++i) {
+		Av[c + i] = 0;
+		for (unsigned int j = 0; j < length; ++j) {
+		    Av[c + i] += priorprec[i + length * j] * v[c + j];
+		}
+	    }
+	    c += length;
+	}
+
+	// Likelihood contribution
+	int const *Xp = static_cast<int const*>(_x->p);
+	int const *Xi = static_cast<int const*>(_x->i);
+	double const *Xx = static_cast<double const*>(_x->x);
+	unsigned int ncol = _x->ncol;
+
+	// u = X %*% v
+	fill(_u.begin(), _u.end(), 0);
+	for (unsigned int col = 0; col < ncol; ++col) {
+	    double vc = v[col];
+	    for (int k = Xp[col]; k < Xp[col+1]; ++k) {
+		_u[Xi[k]] += Xx[k] * vc;
+	    }
+	}
+
+	// u = tau %*% u
+	unsigned int r = 0;
+	vector<double> tu;
+	for (unsigned int i = 0; i < _outcomes.size(); ++i) {
+	    unsigned int m = _outcomes[i]->length();
+	    if (m == 1) {
+		_u[r] *= _outcomes[i]->precision();
+	    }
+	    else {
+		double const *tau = _outcomes[i]->vprecision();
+		tu.assign(m, 0);
+		for (unsigned int j = 0; j < m; ++j) {
+		    for (unsigned int k = 0; k < m; ++k) {
+			tu[j] += tau[m*j+k] * _u[r + k];
+		    }
+		}
+		copy(tu.begin(), tu.end(), _u.begin() + r);
+	    }
+	    r += m;
+	}
+
+	// Av += t(X) %*% u
+	for (unsigned int col = 0; col < ncol; ++col) {
+	    double s = 0;
+	    for (int k = Xp[col]; k < Xp[col+1]; ++k) {
+		s += Xx[k] * _u[Xi[k]];
+	    }
+	    Av[col] += s;
+	}
+    }
+
+    void GLMPerturb::update(RNG *rng)
+    {
+	//   As in GLMBlock, the log of the full conditional density
+	//   takes the form -(t(x) %*% A %*% x - 2 * b %*% x)/2 and we
+	//   take xold, the current value of the sampled nodes, as the
+	//   origin.
+
+	// Update outcomes
+	updateOutcomes(rng);
+
+	// Recalculate the design matrix, if necessary
+	calDesign();
+
+	unsigned int nrow = _view->length();
+	vector<double> b(nrow); // Perturbed canonical parameter
+	// Jacobi preconditioner. This is the diagonal of A, except that
+	// for outcomes with a precision matrix, the off-diagonal
+	// elements of the precision are ignored.
+	vector<double> d(nrow);
+	map<double const *, vector<double> > factors;
+
+	// Perturbed prior contribution
+	unsigned int c = 0;
+	vector<StochasticNode*> const &snodes = _view->nodes();
+	for (vector<StochasticNode*>::const_iterator p = snodes.begin();
+	     p != snodes.end(); ++p)
+	{
+	    double const *priormean = (*p)->parents()[0]->value(_chain);
+	    double const *priorprec = (*p)->parents()[1]->value(_chain);
+	    double const *xold = (*p)->value(_chain);
+	    unsigned int length = (*p)->length();
+	    for (unsigned int i = 0; i < length; ++i) {
+		b[c + i] = 0;
+		for (unsigned int j = 0; j < length; ++j) {
+		    b[c + i] += priorprec[i + length*j] *
+			(priormean[j] - xold[j]);
+		}
+		d[c + i] = priorprec[i + length*i];
+	    }
+	    addNoise(&b[c], priorprec, length, factors, rng);
+	    c += length;
+	}
+
+	// Perturbed likelihood contribution
+	//   b += t(X) %*% (tau %*% (Y - mu) + e)
+	//   where e has mean zero and variance tau
+	vector<double> taud(_x->nrow); // diagonal of tau
+	unsigned int r = 0;
+	for (unsigned int i = 0; i < _outcomes.size(); ++i) {
+	    unsigned int m = _outcomes[i]->length();
+	    if (m == 1) {
+		double tau = _outcomes[i]->precision();
+		_u[r] = tau * (_outcomes[i]->value() - _outcomes[i]->mean());
+		_u[r] += sqrt(tau) * rng->normal();
+		taud[r] = tau;
+	    }
+	    else {
+		double const *tau = _outcomes[i]->vprecision();
+		double const *Y = _outcomes[i]->vvalue();
+		double const *mu = _outcomes[i]->vmean();
+		for (unsigned int j = 0; j < m; ++j) {
+		    _u[r + j] = 0;
+		    for (unsigned int k = 0; k < m; ++k) {
+			_u[r + j] += tau[m*j+k] * (Y[k] - mu[k]);
+		    }
+		    taud[r + j] = tau[m*j+j];
+		}
+		addNoise(&_u[r], tau, m, factors, rng);
+	    }
+	    r += m;
+	}
+
+	int const *Xp = static_cast<int const*>(_x->p);
+	int const *Xi = static_cast<int const*>(_x->i);
+	double const *Xx = static_cast<double const*>(_x->x);
+	for (unsigned int col = 0; col < nrow; ++col) {
+	    for (int k = Xp[col]; k < Xp[col+1]; ++k) {
+		b[col] += Xx[k] * _u[Xi[k]];
+		d[col] += Xx[k] * Xx[k] * taud[Xi[k]];
+	    }
+	}
+
+	// Solve A %*% x = b by conjugate gradients with a diagonal
+	// (Jacobi) preconditioner, starting from x = 0
+	vector<double> x(nrow, 0);
+	copy(b.begin(), b.end(), _r.begin());
+
+	double bnorm = 0, rz = 0;
+	for (unsigned int i = 0; i < nrow; ++i) {
+	    bnorm += b[i] * b[i];
+	    _z[i] = _r[i] / d[i];
+	    rz += _r[i] * _z[i];
+	}
+	bnorm = sqrt(bnorm);
+	copy(_z.begin(), _z.end(), _p.begin());
+
+	// In exact arithmetic, conjugate gradients converges in at most
+	// nrow iterations. Allow extra iterations for rounding error.
+	unsigned int maxiter = 2 * nrow + 100;
+	double rnorm = bnorm;
+	for (unsigned int iter = 0; rnorm > PCG_TOL * bnorm; ++iter) {
+
+	    if (iter == maxiter) {
+		throwRuntimeError("Conjugate gradient failure in GLMPerturb");
+	    }
+
+	    multA(&_p[0], &_Ap[0]);
+
+	    double pAp = 0;
+	    for (unsigned int i = 0; i < nrow; ++i) {
+		pAp += _p[i] * _Ap[i];
+	    }
+	    if (pAp <= 0) {
+		throwRuntimeError("Posterior precision not positive definite in GLMPerturb");
+	    }
+	    double alpha = rz / pAp;
+
+	    double rz_new = 0;
+	    rnorm = 0;
+	    for (unsigned int i = 0; i < nrow; ++i) {
+		x[i] += alpha * _p[i];
+		_r[i] -= alpha * _Ap[i];
+		_z[i] = _r[i] / d[i];
+		rz_new += _r[i] * _z[i];
+		rnorm += _r[i] * _r[i];
+	    }
+	    rnorm = sqrt(rnorm);
+	    if (!jags_finite(rnorm)) {
+		throwRuntimeError("Conjugate gradient failure in GLMPerturb");
+	    }
+
+	    double beta = rz_new / rz;
+	    for (unsigned int i = 0; i < nrow; ++i) {
+		_p[i] = _z[i] + beta * _p[i];
+	    }
+	    rz = rz_new;
+	}
+
+	//Shift origin back to original scale
+	r = 0;
+	for (vector<StochasticNode*>::const_iterator p = snodes.begin();
+	     p != snodes.end(); ++p)
+	{
+	    unsigned int length = (*p)->length();
+	    double const *xold = (*p)->value(_chain);
+	    for (unsigned int i = 0; i < length; ++i, ++r) {
+		x[r] += xold[i];
+	    }
+	}
+
+	_view->setValue(x, _chain);
+    }
+
+}}
@@ -0,0 +1,72 @@
+#ifndef GLM_PERTURB_H_
+#define GLM_PERTURB_H_
+
+#include "GLMMethod.h"
+
+#include <vector>
+
+namespace jags {
+
+    struct RNG;
+    class GraphView;
+    class SingletonGraphView;
+
+namespace glm {
+
+    class Outcome;
+
+    /**
+     * @short Matrix-free block sampler for very large linear models
+     *
+     * GLMPerturb draws from the same normal full conditional as
+     * GLMBlock, with posterior precision "A" and posterior mean "mu"
+     * solving (A %*% mu = b), but it never forms or factorizes A.
+     * Instead it uses the perturbation-optimization algorithm: the
+     * prior and likelihood terms of "b" are perturbed by Gaussian
+     * noise with variance equal to their contribution to A, and the
+     * perturbed system A %*% x = b is then solved by the method of
+     * preconditioned conjugate gradients. The solution is an exact
+     * draw from N(mu, A^-1) up to the convergence tolerance of the
+     * solver. A runtime error is thrown if the solver does not
+     * converge.
+     *
+     * Only products of A with a vector are required. These are
+     * calculated from the design matrix, its transpose and the prior
+     * precision, so memory use is linear in the number of non-zero
+     * elements of the design matrix. This makes GLMPerturb suitable
+     * for blocks that are so large that the Cholesky factor of A does
+     * not fit in memory, e.g. spatial random effects with 10^6
+     * coefficients.
+     *
+     * See Papandreou G and Yuille A (2010) Gaussian sampling by local
+     * perturbations, Advances in Neural Information Processing Systems
+     * 23, and Orieux F, Feron O and Giovannelli J-F (2012) Sampling
+     * high-dimensional Gaussian distributions for general linear inverse
+     * problems, IEEE Signal Processing Letters 19:251-254.
+     */
+    class GLMPerturb : public GLMMethod {
+	std::vector<double> _r, _z, _p, _Ap, _u;
+	void multA(double const *v, double *Av);
+      public:
+	/**
+	 * Constructor.
+	 *
+	 * @see GLMMethod#GLMMethod
+	 */
+	GLMPerturb(GraphView const *view,
+		   std::vector<SingletonGraphView const *> const &sub_views,
+		   std::vector<Outcome *> const &outcomes,
+		   unsigned int chain);
+	/**
+	 * Updates the regression parameters in a block by solving the
+	 * perturbed normal equations with preconditioned conjugate
+	 * gradients.
+	 *
+	 * @param rng Random number generator used for sampling
+	 */
+	void update(RNG *rng);
+    };
+
+}}
+
+#endif /* GLM_PERTURB_H_ */
@@ -32,11 +32,7 @@ namespace jags {
 	void HolmesHeldGibbs::update(RNG *rng) 
 	{
 	    // Update outcomes
-	    for (vector<Outcome*>::const_iterator p = _outcomes.begin();
-		 p != _outcomes.end(); ++p)
-	    {
-		(*p)->update(rng);
-	    }
+	    updateOutcomes(rng);
 	
 	    double *b = 0;
 	    cholmod_sparse *A = 0;
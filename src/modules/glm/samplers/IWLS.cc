@@ -53,10 +53,12 @@ namespace glm {
     
     double IWLS::logPTransition(vector<double> const &xold, 
 				vector<double> const &xnew,
-				double *b, cholmod_sparse *A)
+				double *b, cholmod_sparse *A, bool current)
     {
 	A->stype = -1;
-	int ok = cholmod_factorize(A, _factor, glm_wk);
+	int ok = 0;
+	#pragma omp critical
+	ok = updateFactor(A, current);
 	if (!ok) {
 	    throwRuntimeError("Cholesky decomposition failure in IWLS");
 	}
@@ -130,8 +132,9 @@ namespace glm {
 	_view->getValue(xnew, _chain);
 	calCoef(b2, A2);
 
-	logp -= logPTransition(xold, xnew, b1, A1);
-	logp += logPTransition(xnew, xold, b2, A2);
+	//A2 is the current posterior precision, but A1 is not
+	logp -= logPTransition(xold, xnew, b1, A1, false);
+	logp += logPTransition(xnew, xold, b2, A2, true);
 
 	cholmod_free_sparse(&A1, glm_wk);
 	cholmod_free_sparse(&A2, glm_wk);
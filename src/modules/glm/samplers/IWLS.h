@@ -26,7 +26,8 @@ namespace glm {
     class IWLS : public GLMBlock {
         double logPTransition(std::vector<double> const &xorig,
                               std::vector<double> const &x,
-                              double *b, cholmod_sparse *A);
+                              double *b, cholmod_sparse *A,
+                              bool current);
     public:
 	IWLS(GraphView const *view, 
 	     std::vector<SingletonGraphView const *> const &sub_views,
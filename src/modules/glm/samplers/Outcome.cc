@@ -43,6 +43,14 @@ namespace glm {
     {
     }
 
+    void Outcome::updateBatch(Outcome * const *batch, unsigned int n,
+			      RNG *rng)
+    {
+	for (unsigned int i = 0; i < n; ++i) {
+	    batch[i]->update(rng);
+	}
+    }
+
     void Outcome::update(double mean, double var, RNG *rng)
     {
     }
@@ -66,6 +66,25 @@ namespace glm {
 	 * @param rng Random number generator
 	 */
 	virtual void update(RNG *rng); 
+	/**
+	 * Updates the auxiliary variables of a batch of outcomes
+	 * using the current values of their linear predictors.
+	 *
+	 * GLM sampling methods call this function once per iteration
+	 * for each run of consecutive outcomes of the same class, so
+	 * that an Outcome class can draw all of its auxiliary
+	 * variables together. The default implementation calls
+	 * update(RNG*) for each element of the batch in turn.
+	 *
+	 * @param batch Array of n outcomes, all of which have the same
+	 * class as this object. The first element is this object.
+	 *
+	 * @param n Length of the batch
+	 *
+	 * @param rng Random number generator
+	 */
+	virtual void updateBatch(Outcome * const *batch, unsigned int n,
+				 RNG *rng);
         /**
 	 * Updates the auxiliary variables marginalizing over the
 	 * distribution of the linear predictor. The default
@@ -7,8 +7,16 @@
 #include <rng/RNG.h>
 #include <module/ModuleError.h>
 
+#include <rng/StreamRNG.h>
+
 #include <cmath>
+#include <climits>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 
+using std::vector;
+using std::min;
 using std::exp;
 using std::log;
 using std::sqrt;
@@ -16,6 +24,10 @@ using std::abs;
 
 static double one = 1;
 
+// Batches of more than this many outcomes are divided into chunks of
+// this size, which may be sampled in parallel
+static const unsigned int PG_CHUNK = 1024;
+
 namespace jags {
     namespace glm {
 
@@ -58,32 +70,51 @@ namespace jags {
 	}
 
 
-	static double rpolya_gamma(double z, RNG *rng)
+	/*
+	  Sampling from the Polya-Gamma distribution PG(1, z) is done
+	  in two stages. The constants of the Devroye sampler depend
+	  only on z, so they are calculated once by pgconst and then
+	  shared by all draws with the same value of z, which is done
+	  by pgdraw. PG(N, z) is the sum of N independent PG(1, z)
+	  variables.
+	*/
+
+	struct PGConst {
+	    double z;    // Half of abs(z) for the Jacobi density
+	    double K;    // Rate of the exponential tail proposal
+	    double ptail;// Probability of sampling from the tail
+	};
+
+	static void pgconst(double lp, PGConst &c)
 	{
-	    /* Sample from Polya-gamma PG(1, abs(z))
-	    
-	       In fact we are sampling from a Jacobi density, exploiting
-	       the fact that PG(1, z) = J(1, z/2)/4; hence the transformation
-	       of z on input and the return value on exit.
+	    /*
+	      PG(1, z) = J(1, z/2)/4, where J is the Jacobi density;
+	      hence the transformation of z here and the return value
+	      in pgdraw.
 	    */
-	    
-	    z = abs(z)/2;
-
+	    double z = abs(lp)/2;
 	    double K = M_PI * M_PI / 8 + z * z / 2;
 	    double p = M_PI * exp(-K*TRUNC) / (2 * K);
 	    double q = 2 * exp(-z) * pigauss(z);
-	    
+
+	    c.z = z;
+	    c.K = K;
+	    c.ptail = p/(p+q);
+	}
+
+	static double pgdraw(PGConst const &c, RNG *rng)
+	{
 	    for (unsigned int i = 0; i < 10; ++i) {
 
 		double X;
-		if (rng->uniform() < p/(p+q)) {
+		if (rng->uniform() < c.ptail) {
 		    // Sample from the tail with an exponential proposal
 		    double E = rng->exponential();
-		    X = TRUNC + E/K;
+		    X = TRUNC + E/c.K;
 		}
 		else {
 		    // Sample from the body with a truncated IG proposal
-		    double mu = 1/z;
+		    double mu = 1/c.z;
 		    X = rigauss(mu, 1, TRUNC, rng);
 		}
 		double S = a(0, X);
@@ -142,13 +173,73 @@ namespace jags {
 	    return _tau;
 	}
 	
-	void PolyaGamma::update(RNG *rng)
+	void PolyaGamma::draw(PGConst const &c, RNG *rng)
 	{
 	    unsigned int N = static_cast<unsigned int>(_n);
 
 	    _tau = 0.0;
 	    for (unsigned int i = 0; i < N; ++i) {
-		_tau += rpolya_gamma(_lp, rng);
+		_tau += pgdraw(c, rng);
+	    }
+	}
+
+	void PolyaGamma::update(RNG *rng)
+	{
+	    PGConst c;
+	    pgconst(_lp, c);
+	    draw(c, rng);
+	}
+
+	void PolyaGamma::updateBatch(Outcome * const *batch, unsigned int n,
+				     RNG *rng)
+	{
+	    if (n <= PG_CHUNK) {
+		Outcome::updateBatch(batch, n, rng);
+		return;
+	    }
+
+	    vector<PolyaGamma*> pg(n);
+	    vector<double> lp(n);
+	    for (unsigned int i = 0; i < n; ++i) {
+		pg[i] = static_cast<PolyaGamma*>(batch[i]);
+		lp[i] = pg[i]->_lp;
+	    }
+
+	    // Calculate the sampler constants for the whole batch in a
+	    // single pass
+	    vector<PGConst> c(n);
+	    for (unsigned int i = 0; i < n; ++i) {
+		pgconst(lp[i], c[i]);
+	    }
+
+	    // Seed one stream per chunk from the chain RNG. Since the
+	    // division into chunks does not depend on the number of
+	    // threads, the samples are reproducible.
+	    unsigned int nchunk = (n + PG_CHUNK - 1) / PG_CHUNK;
+	    vector<unsigned int> seeds(nchunk);
+	    for (unsigned int k = 0; k < nchunk; ++k) {
+		seeds[k] = static_cast<unsigned int>(rng->uniform() * UINT_MAX);
+	    }
+
+	    // Exceptions must not escape from a parallel region
+	    bool fail = false;
+            #pragma omp parallel for
+	    for (int k = 0; k < static_cast<int>(nchunk); ++k) {
+		unsigned int start = k * PG_CHUNK;
+		unsigned int len = min(PG_CHUNK, n - start);
+		StreamRNG chunk_rng(seeds[k]);
+		try {
+		    for (unsigned int i = start; i < start + len; ++i) {
+			pg[i]->draw(c[i], &chunk_rng);
+		    }
+		}
+		catch (std::exception const &) {
+                    #pragma omp critical
+		    fail = true;
+		}
+	    }
+	    if (fail) {
+		throwLogicError("Failed to sample Polya-Gamma");
 	    }
 	}
 
@@ -11,6 +11,8 @@ namespace jags {
     class StochasticNode;
     
     namespace glm {
+
+	struct PGConst;
     
 	/*
 	 * @short Binary outcome with logistic link
@@ -24,11 +26,23 @@ namespace jags {
 	    double const &_y;
 	    double const &_n;
 	    double _tau;
+	    void draw(PGConst const &c, RNG *rng);
 	  public:
 	    PolyaGamma(StochasticNode const *snode, unsigned int chain);
 	    double value() const;
 	    double precision() const;
 	    void update(RNG *rng);
+	    /**
+	     * Draws the Polya-Gamma auxiliary variables for the whole
+	     * batch. The constants of the sampler are calculated in a
+	     * single pass over the batch and then shared by the N
+	     * draws that are summed for each binomial outcome. Batches
+	     * of more than 1024 outcomes are divided into chunks with
+	     * separate random number streams seeded from rng, which are
+	     * sampled in parallel when OpenMP is enabled.
+	     */
+	    void updateBatch(Outcome * const *batch, unsigned int n,
+			     RNG *rng);
 	    static bool canRepresent(StochasticNode const *snode);
 	};
 
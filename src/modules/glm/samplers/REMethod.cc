@@ -70,7 +70,7 @@ namespace jags {
 	
 	    // Get LDL' decomposition of posterior precision
 	    A->stype = -1;
-	    int ok = cholmod_factorize(A, _factor, glm_wk);
+	    int ok = updateFactor(A);
 	    cholmod_free_sparse(&A, glm_wk);
 	    if (!ok) {
 		throwRuntimeError("Cholesky decomposition failure in REMethod");
@@ -92,10 +92,12 @@ namespace jags {
 
 	    cholmod_dense *u1 = cholmod_solve(CHOLMOD_L, _factor, w, glm_wk);
 	    double *u1x = static_cast<double*>(u1->x);
+	    vector<double> eps(nrow);
+	    rng->normal(&eps[0], nrow);
 	    if (_factor->is_ll) {
 		// LL' decomposition
 		for (unsigned int r = 0; r < nrow; ++r) {
-		    u1x[r] += rng->normal();
+		    u1x[r] += eps[r];
 		}
 	    }
 	    else {
@@ -104,7 +106,7 @@ namespace jags {
 		int *fp = static_cast<int*>(_factor->p);
 		double *fx = static_cast<double*>(_factor->x);
 		for (unsigned int r = 0; r < nrow; ++r) {
-		    u1x[r] += rng->normal() * sqrt(fx[fp[r]]);
+		    u1x[r] += eps[r] * sqrt(fx[fp[r]]);
 		}
 	    }
 
@@ -180,11 +182,7 @@ namespace jags {
 	void REMethod::update(RNG *rng) {
 	    
 	    // Update outcomes
-	    for (vector<Outcome*>::const_iterator p = _outcomes.begin();
-		 p != _outcomes.end(); ++p)
-	    {
-		(*p)->update(rng);
-	    }
+	    updateOutcomes(rng);
 	    
 	    updateEps(rng); //Update random effects
 	    updateTau(rng); //Sufficient parameterization
@@ -1,15 +1,44 @@
 #include "testglmsamp.h"
 #include "LGMix.h"
+#include "GLMBlock.h"
+#include "GLMPerturb.h"
+#include "GLMGenericFactory.h"
+#include "NormalLinear.h"
+#include "PolyaGamma.h"
+
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/ArrayStochasticNode.h>
+#include <graph/VectorLogicalNode.h>
+#include <graph/Graph.h>
+#include <sampler/GraphView.h>
+#include <sampler/SingletonGraphView.h>
+#include <MersenneTwisterRNG.h>
+#include <DNorm.h>
+#include <DGamma.h>
+#include <DMNorm.h>
+#include <DBin.h>
+#include <Sum.h>
 #include <JRmath.h>
 
 #include <sstream>
+#include <cmath>
 #include <iostream>
 
 using std::vector;
 using std::stringstream;
 
+//Workspace for CHOLMOD. This is defined in glm.cc, which is not
+//part of the test library.
+cholmod_common *glm_wk = 0;
+
 void GLMSampTest::setUp()
 {
+    if (glm_wk == 0) {
+	glm_wk = new cholmod_common;
+	cholmod_start(glm_wk);
+	glm_wk->supernodal = CHOLMOD_SIMPLICIAL;
+    }
 }
 
 void GLMSampTest::tearDown()
@@ -52,3 +81,512 @@ void GLMSampTest::lgmix()
     }
     
 }
+
+namespace {
+
+    //Gives access to the Cholesky factor of the posterior precision
+    class UpdownTest : public jags::glm::GLMBlock {
+      public:
+	UpdownTest(jags::GraphView const *view,
+		   vector<jags::SingletonGraphView const *> const &sub_views,
+		   vector<jags::glm::Outcome *> const &outcomes,
+		   unsigned int chain = 0)
+	    : GLMBlock(view, sub_views, outcomes, chain) {}
+	cholmod_factor *factor() { return _factor; }
+    };
+
+}
+
+void GLMSampTest::updown()
+{
+    //The Cholesky factor of the posterior precision is modified by
+    //low-rank updates when only a few outcome precisions change, and
+    //recalculated when many change or after too many updates in a
+    //row. In all cases it must agree with a fresh factorization.
+
+    jags::bugs::DNorm dnorm;
+    jags::bugs::DGamma dgamma;
+    jags::ConstantNode zero(0, 1, false), one(1, 1, false);
+    jags::Graph graph;
+
+    unsigned int const nb = 3, ny = 60;
+    vector<jags::StochasticNode *> b(nb);
+    vector<jags::SingletonGraphView const *> sub_views(nb);
+    for (unsigned int j = 0; j < nb; ++j) {
+	vector<jags::Node const *> par(2);
+	par[0] = &zero; par[1] = &one;
+	b[j] = new jags::ScalarStochasticNode(&dnorm, 1, par, 0, 0);
+	double v = 0;
+	b[j]->setValue(&v, 1, 0);
+	graph.insert(b[j]);
+    }
+    vector<jags::StochasticNode *> tau(ny), y(ny);
+    for (unsigned int i = 0; i < ny; ++i) {
+	vector<jags::Node const *> par(2);
+	par[0] = &one; par[1] = &one;
+	tau[i] = new jags::ScalarStochasticNode(&dgamma, 1, par, 0, 0);
+	double t = 1;
+	tau[i]->setValue(&t, 1, 0);
+	par[0] = b[i % nb]; par[1] = tau[i];
+	y[i] = new jags::ScalarStochasticNode(&dnorm, 1, par, 0, 0);
+	double v = i % 5;
+	y[i]->setData(&v, 1);
+	graph.insert(tau[i]);
+	graph.insert(y[i]);
+    }
+    for (unsigned int j = 0; j < nb; ++j) {
+	sub_views[j] = new jags::SingletonGraphView(b[j], graph);
+    }
+    jags::GraphView *view = new jags::GraphView(b, graph, true);
+    vector<jags::glm::Outcome *> outcomes;
+    for (unsigned int i = 0; i < ny; ++i) {
+	jags::StochasticNode *child = view->stochasticChildren()[i];
+	outcomes.push_back(new jags::glm::NormalLinear(child, 0));
+    }
+    UpdownTest *method = new UpdownTest(view, sub_views, outcomes);
+
+    jags::RNG *rng = new jags::base::MersenneTwisterRNG(1234567,
+						       jags::KINDERMAN_RAMAGE);
+    cholmod_dense *e = cholmod_ones(nb, 1, CHOLMOD_REAL, glm_wk);
+    for (unsigned int iter = 0; iter < 300; ++iter) {
+	//Single precisions change for the first 150 iterations. After
+	//that, every third iteration changes most of them.
+	unsigned int nchange = (iter >= 150 && iter % 3 == 0) ? 40 : 1;
+	for (unsigned int k = 0; k < nchange; ++k) {
+	    double t = 0.5 + rng->uniform();
+	    tau[(iter + 7 * k) % ny]->setValue(&t, 1, 0);
+	}
+	method->update(rng);
+
+	double *bvec = 0;
+	cholmod_sparse *A = 0;
+	method->calCoef(bvec, A);
+	delete [] bvec;
+	A->stype = -1;
+	cholmod_factor *L = cholmod_analyze(A, glm_wk);
+	cholmod_factorize(A, L, glm_wk);
+	cholmod_dense *x1 =
+	    cholmod_solve(CHOLMOD_A, method->factor(), e, glm_wk);
+	cholmod_dense *x2 = cholmod_solve(CHOLMOD_A, L, e, glm_wk);
+	for (unsigned int j = 0; j < nb; ++j) {
+	    double v1 = static_cast<double*>(x1->x)[j];
+	    double v2 = static_cast<double*>(x2->x)[j];
+	    stringstream msg;
+	    msg << "iteration " << iter;
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(msg.str(), v2, v1, 1.0E-8);
+	}
+	cholmod_free_dense(&x1, glm_wk);
+	cholmod_free_dense(&x2, glm_wk);
+	cholmod_free_factor(&L, glm_wk);
+	cholmod_free_sparse(&A, glm_wk);
+    }
+    cholmod_free_dense(&e, glm_wk);
+    delete rng;
+
+    delete method;
+    delete view;
+    for (unsigned int j = 0; j < nb; ++j) {
+	delete sub_views[j];
+    }
+    for (unsigned int i = ny; i > 0; --i) {
+	delete y[i-1];
+	delete tau[i-1];
+    }
+    for (unsigned int j = nb; j > 0; --j) {
+	delete b[j-1];
+    }
+}
+
+void GLMSampTest::perturb()
+{
+    /*
+      The perturbation-optimization sampler must give draws from the
+      same posterior as the exact sampler. With b[j] ~ dnorm(0, 1) and
+      y[i] ~ dnorm(b[i %% nb], tau[i]), the posterior of b[j] is normal
+      with precision 1 + sum(tau[i]) and mean sum(tau[i] * y[i]) divided
+      by the precision, where the sums are over i with i % nb == j.
+    */
+
+    jags::bugs::DNorm dnorm;
+    jags::ConstantNode zero(0, 1, false), one(1, 1, false);
+    jags::Graph graph;
+
+    unsigned int const nb = 3, ny = 12;
+    vector<jags::StochasticNode *> b(nb);
+    vector<jags::SingletonGraphView const *> sub_views(nb);
+    for (unsigned int j = 0; j < nb; ++j) {
+	vector<jags::Node const *> par(2);
+	par[0] = &zero; par[1] = &one;
+	b[j] = new jags::ScalarStochasticNode(&dnorm, 1, par, 0, 0);
+	double v = 0;
+	b[j]->setValue(&v, 1, 0);
+	graph.insert(b[j]);
+    }
+    vector<jags::ConstantNode *> tau(ny);
+    vector<jags::StochasticNode *> y(ny);
+    vector<double> prec(nb, 1), S(nb, 0);
+    for (unsigned int i = 0; i < ny; ++i) {
+	double t = 0.5 + (i % 4);
+	double v = (i % 5) - 1.5;
+	tau[i] = new jags::ConstantNode(t, 1, false);
+	vector<jags::Node const *> par(2);
+	par[0] = b[i % nb]; par[1] = tau[i];
+	y[i] = new jags::ScalarStochasticNode(&dnorm, 1, par, 0, 0);
+	y[i]->setData(&v, 1);
+	graph.insert(y[i]);
+	prec[i % nb] += t;
+	S[i % nb] += t * v;
+    }
+    for (unsigned int j = 0; j < nb; ++j) {
+	sub_views[j] = new jags::SingletonGraphView(b[j], graph);
+    }
+    jags::GraphView *view = new jags::GraphView(b, graph, true);
+
+    //Blocks are only sampled by GLMPerturb above the threshold
+    jags::glm::GLMGenericFactory factory(nb), default_factory;
+    jags::glm::GLMMethod *block =
+	default_factory.newMethod(view, sub_views, 0, false);
+    CPPUNIT_ASSERT(dynamic_cast<jags::glm::GLMBlock*>(block) != 0);
+    delete block;
+    jags::glm::GLMMethod *method =
+	factory.newMethod(view, sub_views, 0, false);
+    CPPUNIT_ASSERT(dynamic_cast<jags::glm::GLMPerturb*>(method) != 0);
+
+    jags::RNG *rng = new jags::base::MersenneTwisterRNG(1234567,
+						       jags::KINDERMAN_RAMAGE);
+    unsigned int const N = 20000;
+    vector<double> sum(nb, 0), sumsq(nb, 0);
+    for (unsigned int n = 0; n < N; ++n) {
+	method->update(rng);
+	for (unsigned int j = 0; j < nb; ++j) {
+	    double v = b[j]->value(0)[0];
+	    sum[j] += v;
+	    sumsq[j] += v * v;
+	}
+    }
+    for (unsigned int j = 0; j < nb; ++j) {
+	//Draws are independent, so we can use 5 standard errors
+	double mean = sum[j] / N, var = sumsq[j] / N - mean * mean;
+	double sd = sqrt(1 / prec[j]);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(S[j] / prec[j], mean, 5 * sd / sqrt(N));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(1 / prec[j], var,
+				     5 * sqrt(2.0 / N) / prec[j]);
+    }
+    delete rng;
+
+    delete method;
+    delete view;
+    for (unsigned int j = 0; j < nb; ++j) {
+	delete sub_views[j];
+    }
+    for (unsigned int i = ny; i > 0; --i) {
+	delete y[i-1];
+	delete tau[i-1];
+    }
+    for (unsigned int j = nb; j > 0; --j) {
+	delete b[j-1];
+    }
+}
+
+void GLMSampTest::perturb_mnorm()
+{
+    /*
+      Multivariate prior and outcomes: b ~ dmnorm(0, P) and y[i] ~
+      dmnorm(b, Omega) for i = 1 ... ny. The posterior of b is normal
+      with precision A = P + ny * Omega and mean A^-1 %*% Omega %*%
+      sum(y[i])
+    */
+
+    jags::bugs::DMNorm dmnorm;
+    vector<unsigned long> d1(1, 2), d2(2, 2);
+    double const Pv[4] = {1, 0.5, 0.5, 2};
+    double const Ov[4] = {2, -0.8, -0.8, 1};
+    jags::ConstantNode zero(d1, vector<double>(2, 0), 1, false);
+    jags::ConstantNode P(d2, vector<double>(Pv, Pv + 4), 1, false);
+    jags::ConstantNode Omega(d2, vector<double>(Ov, Ov + 4), 1, false);
+    jags::Graph graph;
+
+    vector<jags::Node const *> par(2);
+    par[0] = &zero; par[1] = &P;
+    jags::StochasticNode *b =
+	new jags::ArrayStochasticNode(&dmnorm, 1, par, 0, 0);
+    double b0[2] = {0, 0};
+    b->setValue(b0, 2, 0);
+    graph.insert(b);
+
+    unsigned int const ny = 5;
+    vector<jags::StochasticNode *> y(ny);
+    double Sy[2] = {0, 0};
+    for (unsigned int i = 0; i < ny; ++i) {
+	par[0] = b; par[1] = &Omega;
+	y[i] = new jags::ArrayStochasticNode(&dmnorm, 1, par, 0, 0);
+	double v[2] = {0.5 * i - 1, 1.0 - (i % 3)};
+	y[i]->setData(v, 2);
+	graph.insert(y[i]);
+	Sy[0] += v[0];
+	Sy[1] += v[1];
+    }
+
+    //Exact posterior
+    double A[4];
+    for (unsigned int k = 0; k < 4; ++k) {
+	A[k] = Pv[k] + ny * Ov[k];
+    }
+    double det = A[0] * A[3] - A[1] * A[2];
+    double V[4] = {A[3] / det, -A[1] / det, -A[2] / det, A[0] / det};
+    double c[2] = {Ov[0] * Sy[0] + Ov[2] * Sy[1],
+		   Ov[1] * Sy[0] + Ov[3] * Sy[1]};
+    double mu[2] = {V[0] * c[0] + V[2] * c[1], V[1] * c[0] + V[3] * c[1]};
+
+    vector<jags::StochasticNode *> nodes(1, b);
+    vector<jags::SingletonGraphView const *> sub_views(1);
+    sub_views[0] = new jags::SingletonGraphView(b, graph);
+    jags::GraphView *view = new jags::GraphView(nodes, graph, true);
+    jags::glm::GLMGenericFactory factory(1);
+    jags::glm::GLMMethod *method =
+	factory.newMethod(view, sub_views, 0, false);
+    CPPUNIT_ASSERT(dynamic_cast<jags::glm::GLMPerturb*>(method) != 0);
+
+    jags::RNG *rng = new jags::base::MersenneTwisterRNG(7654321,
+						       jags::KINDERMAN_RAMAGE);
+    unsigned int const N = 20000;
+    double sum[2] = {0, 0}, sumsq[2] = {0, 0}, sum12 = 0;
+    for (unsigned int n = 0; n < N; ++n) {
+	method->update(rng);
+	double const *v = b->value(0);
+	for (unsigned int k = 0; k < 2; ++k) {
+	    sum[k] += v[k];
+	    sumsq[k] += v[k] * v[k];
+	}
+	sum12 += v[0] * v[1];
+    }
+    double mean[2];
+    for (unsigned int k = 0; k < 2; ++k) {
+	mean[k] = sum[k] / N;
+	double var = V[3 * k];
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(mu[k], mean[k], 5 * sqrt(var / N));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(var, sumsq[k] / N - mean[k] * mean[k],
+				     5 * sqrt(2.0 / N) * var);
+    }
+    double cov = sum12 / N - mean[0] * mean[1];
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(V[1], cov,
+				 5 * sqrt((V[0] * V[3] + V[1] * V[1]) / N));
+    delete rng;
+
+    delete method;
+    delete view;
+    delete sub_views[0];
+    for (unsigned int i = ny; i > 0; --i) {
+	delete y[i-1];
+    }
+    delete b;
+}
+
+void GLMSampTest::pgbatch()
+{
+    /*
+      Batches of more than 1024 Polya-Gamma outcomes are divided into
+      chunks that are sampled with separate random number streams.
+      Check the mean of the draws, which is b/(2z) tanh(z/2) for
+      PG(b, z), in each chunk, including a final chunk that is not
+      full, and for draws made one outcome at a time.
+    */
+
+    jags::bugs::DBin dbin;
+    unsigned int const n = 2500, size = 3, nrep = 100;
+    double const z[2] = {0.3, 1.2};
+    jags::ConstantNode lp0(z[0], 1, false), lp1(z[1], 1, false);
+    jags::ConstantNode N(size, 1, false);
+
+    vector<jags::StochasticNode *> y(n);
+    vector<jags::glm::Outcome *> outcomes(n);
+    for (unsigned int i = 0; i < n; ++i) {
+	vector<jags::Node const *> par(2);
+	par[0] = (i % 2) ? &lp1 : &lp0;
+	par[1] = &N;
+	y[i] = new jags::ScalarStochasticNode(&dbin, 1, par, 0, 0);
+	double v = 1;
+	y[i]->setData(&v, 1);
+	outcomes[i] = new jags::glm::PolyaGamma(y[i], 0);
+    }
+
+    jags::RNG *rng = new jags::base::MersenneTwisterRNG(1234567,
+						       jags::KINDERMAN_RAMAGE);
+
+    //Sums of draws by chunk and value of z
+    unsigned int const nchunk = (n + 1023) / 1024;
+    vector<double> S(2 * nchunk, 0), C(2 * nchunk, 0);
+    vector<double> S1(2, 0), C1(2, 0);
+    for (unsigned int r = 0; r < nrep; ++r) {
+	outcomes[0]->updateBatch(&outcomes[0], n, rng);
+	for (unsigned int i = 0; i < n; ++i) {
+	    unsigned int k = 2 * (i / 1024) + i % 2;
+	    S[k] += outcomes[i]->precision();
+	    C[k] += 1;
+	}
+    }
+    for (unsigned int r = 0; r < nrep; ++r) {
+	for (unsigned int i = 0; i < n; ++i) {
+	    outcomes[i]->update(rng);
+	    S1[i % 2] += outcomes[i]->precision();
+	    C1[i % 2] += 1;
+	}
+    }
+
+    for (unsigned int j = 0; j < 2; ++j) {
+	double mean = size * tanh(z[j] / 2) / (2 * z[j]);
+	for (unsigned int c = 0; c < nchunk; ++c) {
+	    stringstream msg;
+	    msg << "chunk " << c << ", z = " << z[j];
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(msg.str(), mean,
+						 S[2*c + j] / C[2*c + j],
+						 0.01);
+	}
+	stringstream msg;
+	msg << "single, z = " << z[j];
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(msg.str(), mean, S1[j] / C1[j],
+					     0.01);
+    }
+
+    delete rng;
+    for (unsigned int i = 0; i < n; ++i) {
+	delete outcomes[i];
+	delete y[i];
+    }
+}
+
+void GLMSampTest::shared_symbolic()
+{
+    //The GLM samplers for different chains share the symbolic
+    //Cholesky factor of the posterior precision. Each chain must
+    //still have its own numeric factor, with the same fill-reducing
+    //permutation and the same values as an independent analysis and
+    //factorization of its own posterior precision.
+
+    jags::bugs::DNorm dnorm;
+    jags::bugs::DGamma dgamma;
+    jags::bugs::Sum sum;
+    unsigned int const nchain = 2;
+    jags::ConstantNode zero(0, nchain, false), one(1, nchain, false);
+    jags::Graph graph;
+
+    unsigned int const nb = 4, ny = 40;
+    vector<jags::StochasticNode *> b(nb);
+    vector<jags::SingletonGraphView const *> sub_views(nb);
+    for (unsigned int j = 0; j < nb; ++j) {
+	vector<jags::Node const *> par(2);
+	par[0] = &zero; par[1] = &one;
+	b[j] = new jags::ScalarStochasticNode(&dnorm, nchain, par, 0, 0);
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double v = 0;
+	    b[j]->setValue(&v, 1, ch);
+	}
+	graph.insert(b[j]);
+    }
+    //Each outcome depends on one or two of the coefficients, so that
+    //the posterior precision is sparse but not diagonal
+    vector<jags::StochasticNode *> tau(ny), y(ny);
+    vector<jags::DeterministicNode *> mu;
+    for (unsigned int i = 0; i < ny; ++i) {
+	vector<jags::Node const *> par(2);
+	par[0] = &one; par[1] = &one;
+	tau[i] = new jags::ScalarStochasticNode(&dgamma, nchain, par, 0, 0);
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double t = 0.5 + ch + (i % 3);
+	    tau[i]->setValue(&t, 1, ch);
+	}
+	graph.insert(tau[i]);
+	jags::Node const *m = b[i % nb];
+	if (i % 4 == 0) {
+	    vector<jags::Node const *> mpar(2);
+	    mpar[0] = b[i % nb]; mpar[1] = b[(i + 1) % nb];
+	    mu.push_back(new jags::VectorLogicalNode(&sum, nchain, mpar));
+	    graph.insert(mu.back());
+	    m = mu.back();
+	}
+	par[0] = m; par[1] = tau[i];
+	y[i] = new jags::ScalarStochasticNode(&dnorm, nchain, par, 0, 0);
+	double v = i % 5;
+	y[i]->setData(&v, 1);
+	graph.insert(y[i]);
+    }
+    for (unsigned int j = 0; j < nb; ++j) {
+	sub_views[j] = new jags::SingletonGraphView(b[j], graph);
+    }
+    jags::GraphView *view = new jags::GraphView(b, graph, true);
+    vector<UpdownTest *> methods(nchain);
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	//Calculate the values of the deterministic nodes
+	vector<double> bv(nb, 0);
+	view->setValue(bv, ch);
+	vector<jags::glm::Outcome *> outcomes;
+	for (unsigned int i = 0; i < ny; ++i) {
+	    jags::StochasticNode *child = view->stochasticChildren()[i];
+	    outcomes.push_back(new jags::glm::NormalLinear(child, ch));
+	}
+	methods[ch] = new UpdownTest(view, sub_views, outcomes, ch);
+    }
+    CPPUNIT_ASSERT(methods[0]->factor() != methods[1]->factor());
+
+    jags::RNG *rng = new jags::base::MersenneTwisterRNG(1234567,
+						       jags::KINDERMAN_RAMAGE);
+    cholmod_dense *e = cholmod_ones(nb, 1, CHOLMOD_REAL, glm_wk);
+    for (unsigned int iter = 0; iter < 5; ++iter) {
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    methods[ch]->update(rng);
+	}
+	for (unsigned int ch = 0; ch < nchain; ++ch) {
+	    double *bvec = 0;
+	    cholmod_sparse *A = 0;
+	    methods[ch]->calCoef(bvec, A);
+	    delete [] bvec;
+	    A->stype = -1;
+	    cholmod_factor *L = cholmod_analyze(A, glm_wk);
+	    cholmod_factorize(A, L, glm_wk);
+
+	    cholmod_factor *F = methods[ch]->factor();
+	    CPPUNIT_ASSERT_EQUAL(L->n, F->n);
+	    CPPUNIT_ASSERT_EQUAL(L->ordering, F->ordering);
+	    int const *lperm = static_cast<int const*>(L->Perm);
+	    int const *fperm = static_cast<int const*>(F->Perm);
+	    for (unsigned int j = 0; j < nb; ++j) {
+		CPPUNIT_ASSERT_EQUAL(lperm[j], fperm[j]);
+	    }
+	    
+	    cholmod_dense *x1 = cholmod_solve(CHOLMOD_A, F, e, glm_wk);
+	    cholmod_dense *x2 = cholmod_solve(CHOLMOD_A, L, e, glm_wk);
+	    for (unsigned int j = 0; j < nb; ++j) {
+		double v1 = static_cast<double*>(x1->x)[j];
+		double v2 = static_cast<double*>(x2->x)[j];
+		stringstream msg;
+		msg << "iteration " << iter << " chain " << ch;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(msg.str(), v2, v1,
+						     1.0E-8);
+	    }
+	    cholmod_free_dense(&x1, glm_wk);
+	    cholmod_free_dense(&x2, glm_wk);
+	    cholmod_free_factor(&L, glm_wk);
+	    cholmod_free_sparse(&A, glm_wk);
+	}
+    }
+    cholmod_free_dense(&e, glm_wk);
+    delete rng;
+
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	delete methods[ch];
+    }
+    delete view;
+    for (unsigned int j = 0; j < nb; ++j) {
+	delete sub_views[j];
+    }
+    for (unsigned int i = ny; i > 0; --i) {
+	delete y[i-1];
+	delete tau[i-1];
+    }
+    for (unsigned int k = mu.size(); k > 0; --k) {
+	delete mu[k-1];
+    }
+    for (unsigned int j = nb; j > 0; --j) {
+	delete b[j-1];
+    }
+}
@@ -8,12 +8,22 @@ class GLMSampTest : public CppUnit::TestFixture , public JAGSFixture
 {
     CPPUNIT_TEST_SUITE( GLMSampTest );
     CPPUNIT_TEST( lgmix );
+    CPPUNIT_TEST( updown );
+    CPPUNIT_TEST( perturb );
+    CPPUNIT_TEST( perturb_mnorm );
+    CPPUNIT_TEST( pgbatch );
+    CPPUNIT_TEST( shared_symbolic );
     CPPUNIT_TEST_SUITE_END();
 
 public:
     void setUp();
     void tearDown();
     void lgmix();
+    void updown();
+    void perturb();
+    void perturb_mnorm();
+    void pgbatch();
+    void shared_symbolic();
 };
 
 #endif  // GLM_SAMP_TEST_H
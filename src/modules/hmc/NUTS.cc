@@ -0,0 +1,399 @@
+#include <config.h>
+
+#include "NUTS.h"
+
+#include <sampler/GraphView.h>
+#include <graph/StochasticNode.h>
+#include <rng/RNG.h>
+#include <util/nainf.h>
+
+#include <cmath>
+
+/* Maximum depth of the trajectory tree */
+#define MAX_DEPTH 10
+/* Error in the Hamiltonian that is treated as a divergence */
+#define DELTA_MAX 1000
+/* Target mean acceptance statistic */
+#define DELTA 0.8
+/* Parameters of the dual averaging algorithm */
+#define GAMMA 0.05
+#define T0 10
+#define KAPPA 0.75
+/* Number of iterations before mass matrix adaptation starts */
+#define INIT_BUFFER 75
+/* Length of the first mass matrix adaptation window */
+#define INIT_WINDOW 25
+/* Minimum number of iterations of step size adaptation with the final
+   mass matrix */
+#define TERM_BUFFER 50
+
+using std::vector;
+using std::exp;
+using std::log;
+using std::log1p;
+using std::sqrt;
+using std::pow;
+
+namespace jags {
+    namespace hmc {
+
+	struct NUTS::Subtree {
+	    Point inner;
+	    vector<double> prop;
+	    double n;
+	    bool s;
+	    double alpha;
+	    unsigned int nalpha;
+	};
+
+	NUTS::NUTS(GraphView const *gv, unsigned int chain)
+	    : _gv(gv), _chain(chain), _N(gv->length()),
+	      _lower(gv->length()), _upper(gv->length()),
+	      _invmetric(gv->length(), 1), _step(0), _adapt(true),
+	      _mu(0), _logstepbar(0), _Hbar(0), _t(0),
+	      _iter(0), _window_size(INIT_WINDOW), _nwindow(0),
+	      _wmean(gv->length(), 0), _wvar(gv->length(), 0), _wn(0),
+	      _last_logstepbar(0), _accept_sum(0), _accept_n(0)
+	{
+	    gv->checkFinite(chain); //Check validity of initial values
+
+	    vector<StochasticNode *> const &nodes = gv->nodes();
+	    double *lp = &_lower[0], *up = &_upper[0];
+	    for (unsigned int i = 0; i < nodes.size(); ++i) {
+		unsigned long len = nodes[i]->length();
+		nodes[i]->support(lp, up, len, chain);
+		lp += len;
+		up += len;
+	    }
+	}
+
+	void NUTS::getTheta(vector<double> &theta) const
+	{
+	    vector<double> x(_N);
+	    _gv->getValue(x, _chain);
+	    theta.resize(_N);
+	    for (unsigned int i = 0; i < _N; ++i) {
+		bool lb = jags_finite(_lower[i]), ub = jags_finite(_upper[i]);
+		if (lb && ub) {
+		    double p = (x[i] - _lower[i]) / (_upper[i] - _lower[i]);
+		    theta[i] = log(p) - log1p(-p);
+		}
+		else if (lb) {
+		    theta[i] = log(x[i] - _lower[i]);
+		}
+		else if (ub) {
+		    theta[i] = log(_upper[i] - x[i]);
+		}
+		else {
+		    theta[i] = x[i];
+		}
+	    }
+	}
+
+	void NUTS::setTheta(vector<double> const &theta) const
+	{
+	    vector<double> x(_N);
+	    for (unsigned int i = 0; i < _N; ++i) {
+		bool lb = jags_finite(_lower[i]), ub = jags_finite(_upper[i]);
+		if (lb && ub) {
+		    double p = 1 / (1 + exp(-theta[i]));
+		    x[i] = _lower[i] + (_upper[i] - _lower[i]) * p;
+		}
+		else if (lb) {
+		    x[i] = _lower[i] + exp(theta[i]);
+		}
+		else if (ub) {
+		    x[i] = _upper[i] - exp(theta[i]);
+		}
+		else {
+		    x[i] = theta[i];
+		}
+	    }
+	    _gv->setValue(x, _chain);
+	}
+
+	void NUTS::logDensity(Point &z) const
+	{
+	    // Calculates the log density and its gradient on the
+	    // transformed scale. Points outside the support, and points
+	    // at which the gradient is not available, have log density
+	    // -Inf and an undefined gradient, so they are never accepted.
+
+	    setTheta(z.theta);
+	    z.lp = _gv->logFullConditional(_chain);
+	    if (!jags_finite(z.lp) ||
+		!_gv->gradLogFullConditional(&z.grad[0], _chain))
+	    {
+		z.lp = JAGS_NEGINF;
+		return;
+	    }
+	    for (unsigned int i = 0; i < _N; ++i) {
+		bool lb = jags_finite(_lower[i]), ub = jags_finite(_upper[i]);
+		double th = z.theta[i];
+		if (lb && ub) {
+		    double w = _upper[i] - _lower[i];
+		    double p = 1 / (1 + exp(-th));
+		    z.grad[i] = z.grad[i] * w * p * (1 - p) + 1 - 2 * p;
+		    z.lp += log(w) - log1p(exp(-th)) - log1p(exp(th));
+		}
+		else if (lb) {
+		    z.grad[i] = z.grad[i] * exp(th) + 1;
+		    z.lp += th;
+		}
+		else if (ub) {
+		    z.grad[i] = 1 - z.grad[i] * exp(th);
+		    z.lp += th;
+		}
+		if (!jags_finite(z.grad[i])) {
+		    z.lp = JAGS_NEGINF;
+		}
+	    }
+	    if (!jags_finite(z.lp)) {
+		z.lp = JAGS_NEGINF;
+	    }
+	}
+
+	void NUTS::leapfrog(Point &z, double eps) const
+	{
+	    for (unsigned int i = 0; i < _N; ++i) {
+		z.r[i] += eps * z.grad[i] / 2;
+		z.theta[i] += eps * _invmetric[i] * z.r[i];
+	    }
+	    logDensity(z);
+	    if (z.lp == JAGS_NEGINF) return;
+	    for (unsigned int i = 0; i < _N; ++i) {
+		z.r[i] += eps * z.grad[i] / 2;
+	    }
+	}
+
+	double NUTS::hamiltonian(Point const &z) const
+	{
+	    // Negative of the total energy, so that the target
+	    // density is proportional to exp(H)
+	    if (z.lp == JAGS_NEGINF) return JAGS_NEGINF;
+	    double K = 0;
+	    for (unsigned int i = 0; i < _N; ++i) {
+		K += _invmetric[i] * z.r[i] * z.r[i];
+	    }
+	    return z.lp - K / 2;
+	}
+
+	bool NUTS::noUturn(Point const &minus, Point const &plus) const
+	{
+	    double sminus = 0, splus = 0;
+	    for (unsigned int i = 0; i < _N; ++i) {
+		double d = (plus.theta[i] - minus.theta[i]) * _invmetric[i];
+		sminus += d * minus.r[i];
+		splus += d * plus.r[i];
+	    }
+	    return sminus >= 0 && splus >= 0;
+	}
+
+	void NUTS::buildTree(Point &z, int v, unsigned int depth,
+			     double logu, double H0, RNG *rng,
+			     Subtree &tree) const
+	{
+	    // Extends the trajectory from z by 2^depth leapfrog steps
+	    // in direction v. On exit, z is the new end point of the
+	    // trajectory and tree.inner is the first point of the
+	    // subtree.
+
+	    if (depth == 0) {
+		leapfrog(z, v * _step);
+		double H = hamiltonian(z);
+		tree.inner = z;
+		tree.prop = z.theta;
+		tree.n = (logu <= H) ? 1 : 0;
+		tree.s = (logu < H + DELTA_MAX);
+		tree.alpha = (H > H0) ? 1 : exp(H - H0);
+		tree.nalpha = 1;
+		return;
+	    }
+
+	    buildTree(z, v, depth - 1, logu, H0, rng, tree);
+	    if (!tree.s) return;
+
+	    Subtree tree2;
+	    buildTree(z, v, depth - 1, logu, H0, rng, tree2);
+	    if (tree2.n > 0 && rng->uniform() * (tree.n + tree2.n) < tree2.n) {
+		tree.prop.swap(tree2.prop);
+	    }
+	    tree.n += tree2.n;
+	    tree.alpha += tree2.alpha;
+	    tree.nalpha += tree2.nalpha;
+	    tree.s = tree2.s && (v > 0 ? noUturn(tree.inner, z) :
+				 noUturn(z, tree.inner));
+	}
+
+	void NUTS::initStep(vector<double> const &theta, RNG *rng)
+	{
+	    // Heuristic for a reasonable initial step size (Hoffman
+	    // and Gelman, 2014, Algorithm 4) followed by a restart of
+	    // the dual averaging algorithm
+
+	    Point z;
+	    z.theta = theta;
+	    z.r.resize(_N);
+	    z.grad.resize(_N);
+	    logDensity(z);
+	    for (unsigned int i = 0; i < _N; ++i) {
+		z.r[i] = rng->normal() / sqrt(_invmetric[i]);
+	    }
+	    double H0 = hamiltonian(z);
+
+	    _step = 1;
+	    Point z1 = z;
+	    leapfrog(z1, _step);
+	    double dH = hamiltonian(z1) - H0;
+	    int a = (dH > -M_LN2) ? 1 : -1;
+	    for (unsigned int k = 0; k < 100 && a * dH > -a * M_LN2; ++k) {
+		_step = (a == 1) ? 2 * _step : _step / 2;
+		z1 = z;
+		leapfrog(z1, _step);
+		dH = hamiltonian(z1) - H0;
+	    }
+
+	    _mu = log(10 * _step);
+	    _logstepbar = log(_step);
+	    _Hbar = 0;
+	    _t = 0;
+	}
+
+	void NUTS::adapt(vector<double> const &theta, double accept, RNG *rng)
+	{
+	    _accept_sum += accept;
+	    _accept_n++;
+
+	    // Dual averaging of the log step size
+	    _t++;
+	    double eta = 1.0 / (_t + T0);
+	    _Hbar = (1 - eta) * _Hbar + eta * (DELTA - accept);
+	    double logstep = _mu - sqrt(static_cast<double>(_t)) * _Hbar / GAMMA;
+	    double xeta = pow(static_cast<double>(_t), -KAPPA);
+	    _logstepbar = xeta * logstep + (1 - xeta) * _logstepbar;
+	    _step = exp(logstep);
+
+	    // Running variance of the transformed values
+	    if (++_iter <= INIT_BUFFER) return;
+	    _wn++;
+	    for (unsigned int i = 0; i < _N; ++i) {
+		double d = theta[i] - _wmean[i];
+		_wmean[i] += d / _wn;
+		_wvar[i] += d * (theta[i] - _wmean[i]);
+	    }
+	    if (_wn < _window_size) return;
+
+	    // End of window: keep the current mass matrix and step size
+	    // in case adaptation ends before the step size has been
+	    // adapted to the new mass matrix (see adaptOff)
+	    _last_invmetric = _invmetric;
+	    _last_logstepbar = _logstepbar;
+
+	    // Regularize the variance estimate towards a small value,
+	    // as in Stan, and restart
+	    double n = _wn;
+	    for (unsigned int i = 0; i < _N; ++i) {
+		double var = _wvar[i] / (n - 1);
+		_invmetric[i] = (n / (n + 5)) * var + 1e-3 * (5 / (n + 5));
+		_wmean[i] = 0;
+		_wvar[i] = 0;
+	    }
+	    _wn = 0;
+	    _window_size *= 2;
+	    _nwindow++;
+	    _accept_sum = 0;
+	    _accept_n = 0;
+	    initStep(theta, rng);
+	}
+
+	void NUTS::update(RNG *rng)
+	{
+	    vector<double> x0(_N);
+	    _gv->getValue(x0, _chain);
+
+	    Point z0;
+	    getTheta(z0.theta);
+	    z0.r.resize(_N);
+	    z0.grad.resize(_N);
+	    logDensity(z0);
+	    if (z0.lp == JAGS_NEGINF) {
+		// The gradient is not available at the current value,
+		// e.g. because a node sampled by another method has moved
+		// to a value at which the density is not differentiable.
+		// Reject the transition and keep the current value.
+		_gv->setValue(x0, _chain);
+		return;
+	    }
+	    if (_step == 0) {
+		initStep(z0.theta, rng);
+	    }
+
+	    for (unsigned int i = 0; i < _N; ++i) {
+		z0.r[i] = rng->normal() / sqrt(_invmetric[i]);
+	    }
+	    double H0 = hamiltonian(z0);
+	    double logu = H0 + log(rng->uniform());
+
+	    Point minus = z0, plus = z0;
+	    vector<double> theta = z0.theta;
+	    double n = 1;
+	    bool s = true;
+	    Subtree tree;
+	    tree.alpha = 0;
+	    tree.nalpha = 1;
+	    for (unsigned int depth = 0; s && depth < MAX_DEPTH; ++depth) {
+		if (rng->uniform() < 0.5) {
+		    buildTree(minus, -1, depth, logu, H0, rng, tree);
+		}
+		else {
+		    buildTree(plus, 1, depth, logu, H0, rng, tree);
+		}
+		if (tree.s && rng->uniform() * n < tree.n) {
+		    theta.swap(tree.prop);
+		}
+		n += tree.n;
+		s = tree.s && noUturn(minus, plus);
+	    }
+
+	    if (_adapt) {
+		adapt(theta, tree.alpha / tree.nalpha, rng);
+	    }
+	    setTheta(theta);
+	}
+
+	bool NUTS::isAdaptive() const
+	{
+	    return true;
+	}
+
+	void NUTS::adaptOff()
+	{
+	    // The step size is restarted after each update of the mass
+	    // matrix. If adaptation ends soon afterwards then the
+	    // averaged step size is unreliable, so we go back to the
+	    // previous mass matrix and the step size adapted to it.
+	    if (_t < TERM_BUFFER && !_last_invmetric.empty()) {
+		_invmetric.swap(_last_invmetric);
+		_logstepbar = _last_logstepbar;
+	    }
+	    if (_step != 0) {
+		_step = exp(_logstepbar);
+	    }
+	    _adapt = false;
+	}
+
+	bool NUTS::checkAdaptation() const
+	{
+	    // The mass matrix must have been estimated at least once
+	    if (_nwindow == 0) return false;
+	    if (_accept_n == 0) return true;
+	    return _accept_sum / _accept_n > 0.6;
+	}
+
+	bool NUTS::isTemperable() const
+	{
+	    return true;
+	}
+
+    }
+}
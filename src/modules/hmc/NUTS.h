@@ -0,0 +1,89 @@
+#ifndef NUTS_H_
+#define NUTS_H_
+
+#include <sampler/MutableSampleMethod.h>
+
+#include <vector>
+
+namespace jags {
+
+    class GraphView;
+
+    namespace hmc {
+
+	/**
+	 * @short No-U-Turn sampler
+	 *
+	 * Updates a block of continuous nodes with the No-U-Turn
+	 * Sampler of Hoffman and Gelman (2014), a form of Hamiltonian
+	 * Monte Carlo that chooses the length of each trajectory
+	 * automatically. Derivatives of the log full conditional
+	 * density are supplied by GraphView#gradLogFullConditional.
+	 *
+	 * Nodes with bounded support are mapped to the real line: a
+	 * log transformation is used for nodes that are bounded on one
+	 * side and a logit transformation for nodes that are bounded
+	 * on both sides.  The sampler works on the transformed scale,
+	 * adding the log Jacobian of the transformation to the target
+	 * density.
+	 *
+	 * In the adaptive phase, the step size is tuned by dual
+	 * averaging to give a mean acceptance statistic of 0.8.  A
+	 * diagonal mass matrix is estimated from the variance of the
+	 * transformed values in a sequence of windows of doubling
+	 * length. The step size adaptation is restarted at the end of
+	 * each window. If the adaptive phase ends less than 50
+	 * iterations after the mass matrix was last updated, the
+	 * previous mass matrix and step size are used for sampling.
+	 */
+	class NUTS : public MutableSampleMethod
+	{
+	    struct Point {
+		std::vector<double> theta, r, grad;
+		double lp;
+	    };
+	    struct Subtree;
+
+	    GraphView const *_gv;
+	    unsigned int _chain;
+	    unsigned int _N;
+	    std::vector<double> _lower, _upper;
+	    std::vector<double> _invmetric;
+	    double _step;
+	    bool _adapt;
+	    // Dual averaging
+	    double _mu, _logstepbar, _Hbar;
+	    unsigned int _t;
+	    // Mass matrix adaptation
+	    unsigned int _iter, _window_size, _nwindow;
+	    std::vector<double> _wmean, _wvar;
+	    unsigned int _wn;
+	    std::vector<double> _last_invmetric;
+	    double _last_logstepbar;
+	    double _accept_sum;
+	    unsigned int _accept_n;
+
+	    void getTheta(std::vector<double> &theta) const;
+	    void setTheta(std::vector<double> const &theta) const;
+	    void logDensity(Point &z) const;
+	    void leapfrog(Point &z, double eps) const;
+	    double hamiltonian(Point const &z) const;
+	    bool noUturn(Point const &minus, Point const &plus) const;
+	    void buildTree(Point &z, int v, unsigned int depth, double logu,
+			   double H0, RNG *rng, Subtree &tree) const;
+	    void initStep(std::vector<double> const &theta, RNG *rng);
+	    void adapt(std::vector<double> const &theta, double accept,
+		       RNG *rng);
+	  public:
+	    NUTS(GraphView const *gv, unsigned int chain);
+	    void update(RNG *rng);
+	    bool isAdaptive() const;
+	    void adaptOff();
+	    bool checkAdaptation() const;
+	    bool isTemperable() const;
+	};
+
+    }
+}
+
+#endif /* NUTS_H_ */
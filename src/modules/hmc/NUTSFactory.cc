@@ -0,0 +1,123 @@
+#include <config.h>
+
+#include "NUTSFactory.h"
+#include "NUTS.h"
+
+#include <model/Model.h>
+#include <sampler/MutableSampler.h>
+#include <sampler/GraphView.h>
+#include <sampler/SingletonGraphView.h>
+#include <sampler/SingletonFactory.h>
+#include <sampler/NodeGroups.h>
+#include <graph/StochasticNode.h>
+
+using std::vector;
+using std::list;
+using std::pair;
+using std::string;
+
+namespace jags {
+namespace hmc {
+
+    static bool hasConjugateSampler(StochasticNode *snode,
+				    Graph const &graph)
+    {
+	list<pair<SamplerFactory *, bool> > const &sf =
+	    Model::samplerFactories();
+	for (list<pair<SamplerFactory *, bool> >::const_iterator p =
+		 sf.begin(); p != sf.end(); ++p)
+	{
+	    if (!p->second || p->first->name() != "bugs::Conjugate") {
+		continue;
+	    }
+	    SingletonFactory const *f =
+		dynamic_cast<SingletonFactory const *>(p->first);
+	    if (f && f->canSample(snode, graph)) {
+		return true;
+	    }
+	}
+	return false;
+    }
+
+    static bool canSample(StochasticNode *snode, Graph const &graph)
+    {
+	// Nodes must be continuous and unconstrained apart from
+	// fixed bounds on each element
+	if (snode->isDiscreteValued() || snode->df() == 0 ||
+	    snode->df() != snode->length())
+	{
+	    return false;
+	}
+	if (isBounded(snode) || !isSupportFixed(snode)) {
+	    return false;
+	}
+	return !hasConjugateSampler(snode, graph);
+    }
+
+    vector<Sampler*> 
+    NUTSFactory::makeSamplers(list<StochasticNode*> const &nodes, 
+			      Graph const &graph) const
+    {
+	vector<StochasticNode*> candidates;
+	for (list<StochasticNode*>::const_iterator p = nodes.begin();
+	     p != nodes.end(); ++p)
+	{
+	    if (canSample(*p, graph)) {
+		candidates.push_back(*p);
+	    }
+	}
+
+	// Join candidates with common stochastic children, or which
+	// are stochastic children of other candidates, into groups
+	unsigned int Nc = candidates.size();
+	NodeGroups groups(candidates);
+	for (unsigned int i = 0; i < Nc; ++i) {
+	    SingletonGraphView view(candidates[i], graph);
+	    vector<StochasticNode*> const &sch = view.stochasticChildren();
+	    for (unsigned int k = 0; k < sch.size(); ++k) {
+		unsigned int j = groups.index(sch[k]);
+		if (j < Nc) {
+		    groups.join(i, j);
+		}
+	    }
+	    groups.joinChildren(i, sch);
+	}
+	vector<vector<StochasticNode*> > glist = groups.groups();
+
+	vector<Sampler*> samplers;
+	for (unsigned int g = 0; g < glist.size(); ++g) {
+	    vector<StochasticNode*> const &block = glist[g];
+	    GraphView *gv = new GraphView(block, graph, true);
+
+	    // Check that the log density is differentiable at the
+	    // initial values of every chain. If not, the nodes are
+	    // left for other factories.
+	    unsigned int nchain = block[0]->nchain();
+	    vector<double> grad(gv->length());
+	    bool ok = true;
+	    for (unsigned int ch = 0; ch < nchain; ++ch) {
+		if (!gv->gradLogFullConditional(&grad[0], ch)) {
+		    ok = false;
+		    break;
+		}
+	    }
+	    if (!ok) {
+		delete gv;
+		continue;
+	    }
+	    
+	    vector<MutableSampleMethod*> methods(nchain, 0);
+	    for (unsigned int ch = 0; ch < nchain; ++ch) {
+		methods[ch] = new NUTS(gv, ch);
+	    }
+	    samplers.push_back(new MutableSampler(gv, methods, "hmc::NUTS"));
+	}
+	return samplers;
+    }
+
+    string NUTSFactory::name() const
+    {
+	return "hmc::NUTS";
+    }
+
+}}
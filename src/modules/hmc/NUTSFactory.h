@@ -0,0 +1,31 @@
+#ifndef NUTS_FACTORY_H_
+#define NUTS_FACTORY_H_
+
+#include <sampler/SamplerFactory.h>
+
+namespace jags {
+namespace hmc {
+
+    /**
+     * @short Factory object for No-U-Turn samplers
+     *
+     * Continuous nodes with fixed support are grouped into blocks of
+     * nodes that share stochastic children, or that are stochastic
+     * children of one another, and each block is sampled jointly by
+     * a NUTS sampler. A block is only sampled if the gradient of its
+     * log full conditional density is available.
+     *
+     * Nodes that can be updated by the conjugate sampler factory of
+     * the bugs module are left for that factory, when it is active.
+     */
+    class NUTSFactory : public SamplerFactory {
+    public:
+	std::vector<Sampler*> 
+	    makeSamplers(std::list<StochasticNode*> const &nodes, 
+			 Graph const &graph) const;
+	std::string name() const;
+    };
+
+}}
+
+#endif /* NUTS_FACTORY_H_ */
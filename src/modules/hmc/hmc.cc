@@ -0,0 +1,34 @@
+#include <module/Module.h>
+#include "NUTSFactory.h"
+
+using std::vector;
+
+namespace jags {
+namespace hmc {
+
+    class HMCModule : public Module {
+
+    public:
+	HMCModule();
+	~HMCModule();
+    };
+
+    HMCModule::HMCModule() 
+	: Module("hmc") 
+    {
+	//NUTS is opt-in: when switched on, it takes precedence over the
+	//samplers of all modules loaded before hmc
+	insert(new NUTSFactory, false);
+    }
+    
+    HMCModule::~HMCModule() {
+	
+	vector<SamplerFactory*> const &svec = samplerFactories();
+	for (unsigned int i = 0; i < svec.size(); ++i) {
+	    delete svec[i];
+	}
+    }
+    
+}}
+
+jags::hmc::HMCModule _hmc_module;
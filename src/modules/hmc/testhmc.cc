@@ -0,0 +1,7 @@
+#include "testhmc.h"
+#include "testnuts.h"
+#include <cppunit/extensions/HelperMacros.h>
+
+void init_hmc_test() {
+    CPPUNIT_TEST_SUITE_REGISTRATION( NUTSTest );
+}
@@ -0,0 +1,6 @@
+#ifndef HMC_TEST_H_
+#define HMC_TEST_H_
+
+void init_hmc_test();
+
+#endif /* HMC_TEST_H_ */
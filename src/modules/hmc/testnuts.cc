@@ -0,0 +1,232 @@
+#include "testnuts.h"
+#include "NUTS.h"
+#include "NUTSFactory.h"
+
+#include <graph/ConstantNode.h>
+#include <graph/ScalarStochasticNode.h>
+#include <graph/ArrayStochasticNode.h>
+#include <graph/Graph.h>
+#include <sampler/GraphView.h>
+#include <sampler/Sampler.h>
+#include <MersenneTwisterRNG.h>
+#include <DMNorm.h>
+#include <DNorm.h>
+#include <DGamma.h>
+#include <DPois.h>
+
+#include <list>
+#include <vector>
+
+using std::vector;
+using std::list;
+
+using jags::Node;
+using jags::ConstantNode;
+using jags::ScalarStochasticNode;
+using jags::ArrayStochasticNode;
+using jags::StochasticNode;
+using jags::Graph;
+using jags::GraphView;
+using jags::Sampler;
+using jags::hmc::NUTS;
+using jags::hmc::NUTSFactory;
+using jags::base::MersenneTwisterRNG;
+
+void NUTSTest::mnorm()
+{
+    /*
+      x ~ dmnorm(mu, T) with standard deviations 1 and 2 and
+      correlation 0.9. The strong correlation makes this hard for
+      samplers that update one element at a time.
+    */
+
+    double const sd[2] = {1, 2}, rho = 0.9;
+    double const cov = rho * sd[0] * sd[1];
+    double const det = sd[0] * sd[0] * sd[1] * sd[1] - cov * cov;
+    vector<double> T = {sd[1] * sd[1] / det, -cov / det,
+			-cov / det, sd[0] * sd[0] / det};
+    vector<double> muv = {1, -1};
+
+    vector<unsigned long> d1(1, 2), d2(2, 2);
+    ConstantNode mu(d1, muv, 1, false), prec(d2, T, 1, false);
+    jags::bugs::DMNorm dmnorm;
+    vector<Node const *> par = {&mu, &prec};
+    ArrayStochasticNode x(&dmnorm, 1, par, 0, 0);
+    double x0[2] = {0, 0};
+    x.setValue(x0, 2, 0);
+
+    Graph graph;
+    graph.insert(&x);
+    vector<StochasticNode*> nodes(1, &x);
+    GraphView gv(nodes, graph, true);
+
+    NUTS nuts(&gv, 0);
+    MersenneTwisterRNG rng(2718, jags::KINDERMAN_RAMAGE);
+    for (unsigned int i = 0; i < 1000; ++i) {
+	nuts.update(&rng);
+    }
+    CPPUNIT_ASSERT(nuts.checkAdaptation());
+    nuts.adaptOff();
+
+    unsigned int const N = 20000;
+    double S[2] = {0, 0}, SS[2] = {0, 0}, S12 = 0;
+    for (unsigned int i = 0; i < N; ++i) {
+	nuts.update(&rng);
+	double const *v = x.value(0);
+	for (unsigned int k = 0; k < 2; ++k) {
+	    S[k] += v[k];
+	    SS[k] += v[k] * v[k];
+	}
+	S12 += v[0] * v[1];
+    }
+    double m[2];
+    for (unsigned int k = 0; k < 2; ++k) {
+	m[k] = S[k] / N;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(muv[k], m[k], 0.05 * sd[k]);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(sd[k] * sd[k], SS[k] / N - m[k] * m[k],
+				     0.1 * sd[k] * sd[k]);
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(cov, S12 / N - m[0] * m[1], 0.1 * cov);
+}
+
+void NUTSTest::bounded()
+{
+    /*
+      tau ~ dgamma(3, 2); z ~ dnorm(0, tau) with z = 1. The posterior
+      of tau is gamma with shape 3.5 and rate 2.5. The sampler works
+      on the log scale.
+    */
+
+    ConstantNode zero(0, 1, false), two(2, 1, false), three(3, 1, false);
+    jags::bugs::DGamma dgamma;
+    jags::bugs::DNorm dnorm;
+    vector<Node const *> tpar = {&three, &two};
+    ScalarStochasticNode tau(&dgamma, 1, tpar, 0, 0);
+    double tau0 = 1;
+    tau.setValue(&tau0, 1, 0);
+    vector<Node const *> zpar = {&zero, &tau};
+    ScalarStochasticNode z(&dnorm, 1, zpar, 0, 0);
+    double zval = 1;
+    z.setData(&zval, 1);
+
+    Graph graph;
+    graph.insert(&tau);
+    graph.insert(&z);
+    vector<StochasticNode*> nodes(1, &tau);
+    GraphView gv(nodes, graph, true);
+
+    NUTS nuts(&gv, 0);
+    MersenneTwisterRNG rng(3141, jags::KINDERMAN_RAMAGE);
+    //Adaptation ends just after the mass matrix has been updated at
+    //iteration 250, so the previous mass matrix must be used
+    for (unsigned int i = 0; i < 260; ++i) {
+	nuts.update(&rng);
+    }
+    nuts.adaptOff();
+
+    unsigned int const N = 20000;
+    double S = 0, SS = 0;
+    for (unsigned int i = 0; i < N; ++i) {
+	nuts.update(&rng);
+	double t = tau.value(0)[0];
+	CPPUNIT_ASSERT(t > 0);
+	S += t;
+	SS += t * t;
+    }
+    double m = S / N;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.4, m, 0.05);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.56, SS / N - m * m, 0.05);
+}
+
+void NUTSTest::factory()
+{
+    /*
+      mu ~ dnorm(0, 1); y ~ dnorm(mu, s) where s is a discrete node
+      that is not sampled by NUTS. In the second chain, s = 0 is not
+      a valid precision, so the gradient is not available. The
+      factory must then leave mu for other samplers.
+    */
+
+    unsigned int const nchain = 2;
+    ConstantNode zero(0, nchain, false), one(1, nchain, false);
+    jags::bugs::DNorm dnorm;
+    jags::bugs::DPois dpois;
+    vector<Node const *> mpar = {&zero, &one};
+    ScalarStochasticNode mu(&dnorm, nchain, mpar, 0, 0);
+    vector<Node const *> spar = {&one};
+    ScalarStochasticNode s(&dpois, nchain, spar, 0, 0);
+    vector<Node const *> ypar = {&mu, &s};
+    ScalarStochasticNode y(&dnorm, nchain, ypar, 0, 0);
+    double yval = 0.5;
+    y.setData(&yval, 1);
+
+    double mu0 = 0, s0[nchain] = {2, 0};
+    for (unsigned int ch = 0; ch < nchain; ++ch) {
+	mu.setValue(&mu0, 1, ch);
+	s.setValue(s0 + ch, 1, ch);
+    }
+
+    Graph graph;
+    graph.insert(&mu);
+    graph.insert(&s);
+    graph.insert(&y);
+    list<StochasticNode*> free_nodes = {&mu, &s};
+
+    NUTSFactory factory;
+    vector<Sampler*> samplers = factory.makeSamplers(free_nodes, graph);
+    CPPUNIT_ASSERT(samplers.empty());
+
+    //With a valid precision in both chains, mu is sampled by NUTS
+    s0[1] = 1;
+    s.setValue(s0 + 1, 1, 1);
+    samplers = factory.makeSamplers(free_nodes, graph);
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), samplers.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(1), samplers[0]->nodes().size());
+    CPPUNIT_ASSERT(samplers[0]->nodes()[0] == &mu);
+    delete samplers[0];
+}
+
+void NUTSTest::invalid()
+{
+    /*
+      mu ~ dnorm(0, 1); y ~ dnorm(mu, s) where s is not sampled by
+      NUTS. If s moves to 0 then the gradient is not available at the
+      current value of mu. The transition must be rejected, leaving mu
+      unchanged.
+    */
+
+    ConstantNode zero(0, 1, false), one(1, 1, false);
+    jags::bugs::DNorm dnorm;
+    jags::bugs::DPois dpois;
+    vector<Node const *> mpar = {&zero, &one};
+    ScalarStochasticNode mu(&dnorm, 1, mpar, 0, 0);
+    vector<Node const *> spar = {&one};
+    ScalarStochasticNode s(&dpois, 1, spar, 0, 0);
+    vector<Node const *> ypar = {&mu, &s};
+    ScalarStochasticNode y(&dnorm, 1, ypar, 0, 0);
+    double yval = 0.5;
+    y.setData(&yval, 1);
+
+    double mu0 = 0.25, s0 = 1;
+    mu.setValue(&mu0, 1, 0);
+    s.setValue(&s0, 1, 0);
+
+    Graph graph;
+    graph.insert(&mu);
+    graph.insert(&s);
+    graph.insert(&y);
+    vector<StochasticNode*> nodes(1, &mu);
+    GraphView gv(nodes, graph, true);
+
+    NUTS nuts(&gv, 0);
+    MersenneTwisterRNG rng(1618, jags::KINDERMAN_RAMAGE);
+    nuts.update(&rng);
+
+    double mu1 = mu.value(0)[0];
+    s0 = 0;
+    s.setValue(&s0, 1, 0);
+    for (unsigned int i = 0; i < 10; ++i) {
+	nuts.update(&rng);
+	CPPUNIT_ASSERT_EQUAL(mu1, mu.value(0)[0]);
+    }
+}
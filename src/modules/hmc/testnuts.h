@@ -0,0 +1,23 @@
+#ifndef NUTS_TEST_H
+#define NUTS_TEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+class NUTSTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( NUTSTest );
+    CPPUNIT_TEST( mnorm );
+    CPPUNIT_TEST( bounded );
+    CPPUNIT_TEST( factory );
+    CPPUNIT_TEST( invalid );
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void mnorm();
+    void bounded();
+    void factory();
+    void invalid();
+};
+
+#endif  // NUTS_TEST_H
@@ -73,8 +73,8 @@ static void fixState (unsigned int state[6])
 namespace jags {
 namespace lecuyer {
 
-    RngStream::RngStream(unsigned int state[6])
-	: RmathRNG("lecuyer::RngStream", KINDERMAN_RAMAGE)
+    RngStream::RngStream(unsigned int state[6], NormKind norm_kind)
+	: RmathRNG("lecuyer::RngStream", norm_kind)
     {
 	if (!checkState(state)) {
 	    throwLogicError("Invalid initial state in RngStream");
@@ -148,6 +148,13 @@ namespace lecuyer {
 	return ((p1 > p2) ? (p1 - p2) * norm : (p1 - p2 + m1) * norm);
     }
 
+    void RngStream::uniform(double *x, unsigned long n)
+    {
+	for (unsigned long i = 0; i < n; ++i) {
+	    x[i] = RngStream::uniform();
+	}
+    }
+
     void RngStream::init(unsigned int seed)
     {
 	unsigned int state[6];
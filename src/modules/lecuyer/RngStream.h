@@ -22,12 +22,15 @@ namespace lecuyer {
 	 * elements must be less than m1, and the second three must be
 	 * less than m2. The first three elements may not be all zero
 	 * and the second elements may not be all zero.
+	 * @param norm_kind Algorithm for normal random variables
 	 */
-	RngStream(unsigned int state[6]);
+	RngStream(unsigned int state[6],
+		  NormKind norm_kind = KINDERMAN_RAMAGE);
 	void init(unsigned int seed);
 	bool setState(std::vector<int> const &state);
 	void getState(std::vector<int> &state) const;
 	double uniform();
+	void uniform(double *x, unsigned long n);
 	/**
 	 * Generates a state vector from a random seed
 	 */
@@ -155,13 +155,15 @@ namespace lecuyer {
 
     RNG * RngStreamFactory::makeRNG(string const &name)
     {
-	if (name == "lecuyer::RngStream") {
+	string basename;
+	NormKind kind = RmathRNG::normKind(name, basename);
+	if (basename == "lecuyer::RngStream") {
 
 	    unsigned int state[6];
 	    for (int j = 0; j < 6; ++j) {
 		state[j] = static_cast<unsigned int>(Bg[j]);
 	    }
-	    RNG *rng = new RngStream(state);
+	    RNG *rng = new RngStream(state, kind);
 	    nextStream();
 
 	    _rngvec.push_back(rng);
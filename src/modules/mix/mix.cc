@@ -27,6 +27,7 @@ namespace mix {
 	
 	insert(new MixSamplerFactory);
 	insert(new DirichletCatFactory);
+	insert(new LDAFactory(true));
 	insert(new LDAFactory);
     }
 
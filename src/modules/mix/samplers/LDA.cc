@@ -12,15 +12,10 @@
 
 #include <set>
 #include <vector>
-#include <algorithm>
-#include <numeric>
 
 using std::vector;
 using std::set;
 using std::string;
-using std::upper_bound;
-using std::accumulate;
-using std::partial_sum;
 
 namespace jags {
 
@@ -34,11 +29,24 @@ namespace jags {
 
     namespace mix {
 
+	static vector<vector<int> >
+	getTokens(vector<vector<StochasticNode*> > const &nodes, unsigned int ch)
+	{
+	    vector<vector<int> > tokens(nodes.size());
+	    for (unsigned int d = 0; d < nodes.size(); ++d) {
+		for (unsigned int i = 0; i < nodes[d].size(); ++i) {
+		    int value = static_cast<int>(*nodes[d][i]->value(ch)) - 1;
+		    tokens[d].push_back(value);
+		}
+	    }
+	    return tokens;
+	}
+
 	LDA::LDA(vector<vector<StochasticNode*> > const &topics,
 		 vector<vector<StochasticNode*> > const &words,
 		 vector<StochasticNode*> const &topic_priors,
 		 vector<StochasticNode*> const &word_priors,
-		 GraphView const *gv, unsigned int ch)
+		 GraphView const *gv, unsigned int ch, unsigned int nPart)
 	    : _nTopic(word_priors.size()), 
 	      _nWord(word_priors[0]->length()),
 	      _nDoc(topics.size()), 
@@ -46,24 +54,14 @@ namespace jags {
 	      _wordHyper(word_priors[0]->parents()[0]->value(ch)),
 	      _gv(gv), 
 	      _chain(ch),
-	    _topicTokens(_nDoc), 
-	    _wordTokens(_nDoc), 
-	    _topicsByWord(_nWord, vector<int>(_nTopic, 0)),
-	    _topicsByDoc(_nDoc, vector<int>(_nTopic, 0)),
-	    _docSums(_nDoc), _topicSums(_nTopic),
-	    _wordsObserved(true)
+	      _words(words),
+	      _wordsObserved(true),
+	      _sampler(_nTopic, _nWord, getTokens(topics, ch),
+		       getTokens(words, ch)),
+	      _nPart(nPart)
 	{
-	    //Set up tables
 	    for (unsigned int d = 0; d < _nDoc; ++d) {
-		_docSums[d] = topics[d].size();
-		for (unsigned int i = 0; i < _docSums[d]; ++i) {
-		    int topic = static_cast<int>(*topics[d][i]->value(ch)) - 1;
-		    _topicTokens[d].push_back(topic);
-		    _topicsByDoc[d][topic]++;
-		    _topicSums[topic]++;
-		    int word = static_cast<int>(*words[d][i]->value(ch)) - 1;
-		    _wordTokens[d].push_back(word);
-		    _topicsByWord[word][topic]++;
+		for (unsigned int i = 0; i < words[d].size(); ++i) {
 		    if (!isObserved(words[d][i])) _wordsObserved = false;
 		}
 	    }
@@ -72,34 +70,18 @@ namespace jags {
 	    vector<StochasticNode*> const &snodes = gv->nodes();
 	    unsigned int offset = 0;
 	    for (unsigned int doc = 0; doc < _nDoc; ++doc) {
-		for (unsigned int i = 0; i < _docSums[doc]; ++i) {
+		for (unsigned int i = 0; i < topics[doc].size(); ++i) {
 		    if (topics[doc][i] != snodes[offset + i]) {
 			throwLogicError("Bad GraphView in LD constructor");
 		    }
 		}
-		offset += _docSums[doc];
+		offset += topics[doc].size();
 	    }
 	}
 
 	void LDA::rebuildTable()
 	{
-	    for (unsigned int t = 0; t < _nTopic; ++t) {
-		for (unsigned int w = 0; w < _nWord; ++w) {
-		    _topicsByWord[w][t] = 0;
-		}
-	    }
-
-	    vector<StochasticNode *> const &s = _gv->nodes();
-	    unsigned int offset = 0;
-	    for (unsigned int d = 0; d < _nDoc; ++d) {
-		for (unsigned int i = 0; i < _docSums[d]; ++i) {
-		    int topic = _topicTokens[d][i];
-		    int word = static_cast<int>(*s[offset + i]->value(_chain)) 
-			- 1;
-		    _topicsByWord[word][topic]++;
-		}
-		offset += _docSums[d];
-	    }
+	    _sampler.setWords(getTokens(_words, _chain));
 	}
 
 	void LDA::update(RNG *rng)
@@ -108,56 +90,19 @@ namespace jags {
 		rebuildTable();
 	    }
 
-	    double wordHyperSum = 
-		accumulate(_wordHyper, _wordHyper + _nWord, 0.0);
-	    
-	    vector<double> sump(_nTopic);
-	    for (unsigned int doc = 0; doc < _nDoc; ++doc) {
-
-		vector<int> &thisDocTopics = _topicsByDoc[doc];
-
-		for (unsigned int i = 0; i < _docSums[doc]; ++i) {
-
-		    //Find current topic and word values
-		    int &topic = _topicTokens[doc][i];
-		    int const &word = _wordTokens[doc][i];
-
-		    vector<int> &thisWordTopics = _topicsByWord[word];
-
-		    //Remove current value from tables
-		    thisDocTopics[topic]--;
-		    thisWordTopics[topic]--;
-		    _topicSums[topic]--;
-
-		    //Calculate probability vector
-		    vector<double> prob(_nTopic);
-		    for (unsigned int t = 0; t < _nTopic; ++t) {
-			double prior = thisDocTopics[t] + _topicHyper[t];
-			double likelihood = 
-			    (thisWordTopics[t] + _wordHyper[word]) /
-			    (_topicSums[t] + wordHyperSum);
-			prob[t] = prior * likelihood;
-		    }
-		    
-		    //Draw random sample from categorical distribution
-		    partial_sum(prob.begin(), prob.end(), sump.begin());
-		    double p = rng->uniform() * sump.back();
-		    topic = upper_bound(sump.begin(), sump.end(), p) -
-			sump.begin();
-		    if (topic == _nTopic) --topic;
-
-		    //Restore current value to tables
-		    thisDocTopics[topic]++;
-		    thisWordTopics[topic]++;
-		    _topicSums[topic]++;
-		}
+	    if (_nPart > 1) {
+		_sampler.updateParallel(_topicHyper, _wordHyper, rng, _nPart);
+	    }
+	    else {
+		_sampler.update(_topicHyper, _wordHyper, rng);
 	    }
 	    
 	    vector<double> value;
 	    value.reserve(_gv->length());
 	    for (unsigned int d = 0; d < _nDoc; ++d) {
-		for (unsigned int i = 0; i < _docSums[d]; ++i) {
-		    value.push_back(_topicTokens[d][i] + 1);
+		vector<int> const &topics = _sampler.topics(d);
+		for (unsigned int i = 0; i < topics.size(); ++i) {
+		    value.push_back(topics[i] + 1);
 		}
 	    }
 	    _gv->setValue(value, _chain);
@@ -3,6 +3,8 @@
 
 #include <sampler/SampleMethodNoAdapt.h>
 
+#include "SparseLDA.h"
+
 #include <vector>
 
 namespace jags {
@@ -15,6 +17,9 @@ namespace jags {
 	/**
 	 * @short Collapsed sampler for Latent Dirichlet Allocation
 	 * models.
+	 *
+	 * The topic indicators are updated by a SparseLDA object,
+	 * which works on tables of topic counts.
 	 */
 	class LDA : public SampleMethodNoAdapt {
 	    const unsigned int _nTopic, _nWord, _nDoc;
@@ -22,10 +27,10 @@ namespace jags {
 	    double const *_wordHyper;
 	    GraphView const *_gv;
 	    const unsigned int _chain;	    
-	    std::vector<std::vector<int> > _topicTokens, _wordTokens;
-	    std::vector<std::vector<int> > _topicsByWord, _topicsByDoc;
-	    std::vector<unsigned int> _docSums, _topicSums;
+	    std::vector<std::vector<StochasticNode*> > _words;
 	    bool _wordsObserved;
+	    SparseLDA _sampler;
+	    const unsigned int _nPart;
 	    void rebuildTable();
 	  public:
 	    /**
@@ -56,12 +61,18 @@ namespace jags {
 	     *
 	     * @param gv Pointer to the GraphView within which sampling
 	     * takes place. 
+	     *
+	     * @param nPart Number of partitions of the documents. If
+	     * nPart is greater than 1 then the approximate parallel
+	     * update SparseLDA#updateParallel is used instead of the
+	     * exact collapsed Gibbs sampler.
 	     */
 	    LDA(std::vector<std::vector<StochasticNode*> > const &topics,
 		std::vector<std::vector<StochasticNode*> > const &words,
 		std::vector<StochasticNode*> const &topic_priors,
 		std::vector<StochasticNode*> const &word_priors,
-		GraphView const *gv, unsigned int chain);
+		GraphView const *gv, unsigned int chain,
+		unsigned int nPart = 1);
 	    void update(RNG *rng);
 	    /**
 	     * Tests whether a set of topics can be sampled by the LDA
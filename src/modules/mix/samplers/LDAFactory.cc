@@ -24,6 +24,11 @@ using std::map;
 using std::list;
 using std::find;
 
+/* Number of document partitions used by the parallel sampler. This is
+   fixed, rather than set to the number of threads, so that results
+   are reproducible on any machine */
+#define LDA_PARTITIONS 16
+
 namespace jags {
 
     /* Struct to hold Dirichlet nodes that will be marginalized out
@@ -121,6 +126,11 @@ namespace jags {
     }
 
     namespace mix {
+
+	LDAFactory::LDAFactory(bool parallel)
+	    : _parallel(parallel)
+	{
+	}
 	
 	Sampler * 
 	LDAFactory::makeSampler(vector<StochasticNode*> const &topicPriors,
@@ -155,16 +165,17 @@ namespace jags {
 		vector<MutableSampleMethod*> methods(N);
 		for (unsigned int ch = 0; ch < N; ++ch) {
 		    methods[ch] = new LDA(topics, words, topicPriors,
-					  wordPriors, view, ch);
+					  wordPriors, view, ch,
+					  _parallel ? LDA_PARTITIONS : 1);
 		}
-		return new MutableSampler(view, methods, "mix::LDA");
+		return new MutableSampler(view, methods, name());
 	    }
 	    else return 0;
 	}
 
 	string LDAFactory::name() const
 	{
-	    return "mix::LDA";
+	    return _parallel ? "mix::ParallelLDA" : "mix::LDA";
 	}
 
 	vector<Sampler*>  
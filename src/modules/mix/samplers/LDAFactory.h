@@ -8,11 +8,19 @@ namespace jags {
 
 	/**
 	 * @short Factory object for LDA samplers
+	 *
+	 * The parallel factory, named "mix::ParallelLDA", creates
+	 * samplers that use the approximate AD-LDA algorithm within
+	 * each chain. It has lower priority than the exact sampler
+	 * "mix::LDA", so it is only used when "mix::LDA" is switched
+	 * off.
 	 */
 
 	class LDAFactory : public SamplerFactory
 	{
+	    const bool _parallel;
 	  public:
+	    LDAFactory(bool parallel = false);
 	    Sampler *
 		makeSampler(std::vector<StochasticNode*> const &topicPriors,
 			    std::vector<StochasticNode*> const &wordPriors,
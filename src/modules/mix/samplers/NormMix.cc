@@ -241,4 +241,9 @@ namespace mix {
         return _gv->logLikelihood(_chain);
     }
 
+    bool NormMix::isTemperable() const
+    {
+	return true;
+    }
+
 }}
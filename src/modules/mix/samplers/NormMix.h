@@ -54,6 +54,7 @@ namespace mix {
 	double logJacobian(std::vector<double> const &value) const;
 	void step(std::vector<double> &value, double step, RNG *rng) const;
 	static bool canSample(std::vector<StochasticNode *> const &snodes);
+	bool isTemperable() const;
     };
 
 }}
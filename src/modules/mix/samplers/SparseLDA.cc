@@ -0,0 +1,320 @@
+#include <config.h>
+
+#include "SparseLDA.h"
+
+#include <rng/RNG.h>
+#include <rng/StreamRNG.h>
+#include <module/ModuleError.h>
+
+#include <algorithm>
+#include <numeric>
+#include <climits>
+
+using std::vector;
+using std::accumulate;
+using std::find;
+using std::fill;
+
+static void eraseTopic(vector<int> &list, int topic)
+{
+    // Topic lists are unordered, so we can swap with the last element
+    vector<int>::iterator p = find(list.begin(), list.end(), topic);
+    *p = list.back();
+    list.pop_back();
+}
+
+namespace jags {
+    namespace mix {
+
+	SparseLDA::WordTopics::WordTopics(unsigned int nTopic,
+					  unsigned int nWord)
+	    : byWord(nWord, vector<int>(nTopic, 0)), wordList(nWord),
+	      sums(nTopic, 0), qcoef(nTopic), qterm(nTopic), track(false)
+	{
+	}
+
+	void SparseLDA::WordTopics::apply(Move const &m)
+	{
+	    // Moves a token of word m.word from topic m.from to m.to,
+	    // updating the counts and the list of topics for the word
+
+	    vector<int> &counts = byWord[m.word];
+	    if (--counts[m.from] == 0) eraseTopic(wordList[m.word], m.from);
+	    if (counts[m.to]++ == 0) wordList[m.word].push_back(m.to);
+	    sums[m.from]--;
+	    sums[m.to]++;
+	}
+
+	SparseLDA::SparseLDA(unsigned int nTopic, unsigned int nWord,
+			     vector<vector<int> > const &topics,
+			     vector<vector<int> > const &words)
+	    : _nTopic(nTopic), _nWord(nWord), _nDoc(topics.size()),
+	      _topicTokens(topics), _wordTokens(words),
+	      _topicsByDoc(_nDoc, vector<int>(nTopic, 0)),
+	      _docTopicList(_nDoc), _global(nTopic, nWord),
+	      _local_valid(false)
+	{
+	    if (words.size() != _nDoc) {
+		throwLogicError("Dimension mismatch in SparseLDA");
+	    }
+	    for (unsigned int d = 0; d < _nDoc; ++d) {
+		if (words[d].size() != topics[d].size()) {
+		    throwLogicError("Dimension mismatch in SparseLDA");
+		}
+	    }
+	    buildTables();
+	}
+
+	void SparseLDA::buildTables()
+	{
+	    _local_valid = false;
+	    for (unsigned int w = 0; w < _nWord; ++w) {
+		fill(_global.byWord[w].begin(), _global.byWord[w].end(), 0);
+		_global.wordList[w].clear();
+	    }
+	    for (unsigned int d = 0; d < _nDoc; ++d) {
+		fill(_topicsByDoc[d].begin(), _topicsByDoc[d].end(), 0);
+		_docTopicList[d].clear();
+	    }
+	    fill(_global.sums.begin(), _global.sums.end(), 0);
+
+	    for (unsigned int d = 0; d < _nDoc; ++d) {
+		for (unsigned int i = 0; i < _topicTokens[d].size(); ++i) {
+		    int topic = _topicTokens[d][i];
+		    int word = _wordTokens[d][i];
+		    if (_topicsByDoc[d][topic]++ == 0) {
+			_docTopicList[d].push_back(topic);
+		    }
+		    if (_global.byWord[word][topic]++ == 0) {
+			_global.wordList[word].push_back(topic);
+		    }
+		    _global.sums[topic]++;
+		}
+	    }
+	}
+
+	void SparseLDA::setWords(vector<vector<int> > const &words)
+	{
+	    _wordTokens = words;
+	    buildTables();
+	}
+
+	vector<int> const &SparseLDA::topics(unsigned int doc) const
+	{
+	    return _topicTokens[doc];
+	}
+
+	void SparseLDA::adjust(unsigned int doc, int word, int topic,
+			       int delta, WordTopics &wt, double const *alpha,
+			       double B, double &S0, double &R0)
+	{
+	    // Adds delta to the count tables for the given token and
+	    // updates the bucket sums and the q coefficient for topic
+
+	    int &ndt = _topicsByDoc[doc][topic];
+	    int &nwt = wt.byWord[word][topic];
+	    unsigned int &nt = wt.sums[topic];
+
+	    double denom = nt + B;
+	    S0 -= alpha[topic] / denom;
+	    R0 -= ndt / denom;
+
+	    ndt += delta;
+	    nwt += delta;
+	    nt += delta;
+
+	    denom = nt + B;
+	    S0 += alpha[topic] / denom;
+	    R0 += ndt / denom;
+	    wt.qcoef[topic] = (ndt + alpha[topic]) / denom;
+
+	    if (delta < 0) {
+		if (ndt == 0) eraseTopic(_docTopicList[doc], topic);
+		if (nwt == 0) eraseTopic(wt.wordList[word], topic);
+	    }
+	    else {
+		if (ndt == delta) _docTopicList[doc].push_back(topic);
+		if (nwt == delta) wt.wordList[word].push_back(topic);
+	    }
+	}
+
+	void SparseLDA::sweep(unsigned int first, unsigned int last,
+			      WordTopics &wt, double const *alpha,
+			      double const *beta, RNG *rng)
+	{
+	    // Updates the topic indicators for documents first ... last - 1
+
+	    double B = accumulate(beta, beta + _nWord, 0.0);
+
+	    vector<unsigned int> const &topicSums = wt.sums;
+	    vector<double> &qcoef = wt.qcoef;
+	    vector<double> &qterm = wt.qterm;
+
+	    // Sum of the s bucket and coefficients of the q bucket,
+	    // without the contribution of the current document
+	    double S0 = 0;
+	    for (unsigned int t = 0; t < _nTopic; ++t) {
+		double denom = topicSums[t] + B;
+		S0 += alpha[t] / denom;
+		qcoef[t] = alpha[t] / denom;
+	    }
+
+	    for (unsigned int doc = first; doc < last; ++doc) {
+
+		vector<int> const &docTopics = _topicsByDoc[doc];
+		vector<int> const &docList = _docTopicList[doc];
+
+		// Sum of the r bucket and coefficients of the q bucket
+		// for this document. The bucket sums omit the factor
+		// beta[w], which depends on the token.
+		double R0 = 0;
+		for (unsigned int k = 0; k < docList.size(); ++k) {
+		    int t = docList[k];
+		    double denom = topicSums[t] + B;
+		    R0 += docTopics[t] / denom;
+		    qcoef[t] = (docTopics[t] + alpha[t]) / denom;
+		}
+
+		for (unsigned int i = 0; i < _topicTokens[doc].size(); ++i) {
+
+		    int &topic = _topicTokens[doc][i];
+		    int word = _wordTokens[doc][i];
+		    int old = topic;
+		    vector<int> const &wordTopics = wt.byWord[word];
+		    vector<int> const &wordList = wt.wordList[word];
+
+		    //Remove current value from tables
+		    adjust(doc, word, topic, -1, wt, alpha, B, S0, R0);
+
+		    //Calculate bucket sums
+		    double Q = 0;
+		    for (unsigned int k = 0; k < wordList.size(); ++k) {
+			int t = wordList[k];
+			qterm[k] = qcoef[t] * wordTopics[t];
+			Q += qterm[k];
+		    }
+		    double bw = beta[word];
+		    double R = bw * R0;
+		    double S = bw * S0;
+
+		    //Draw random sample, visiting the buckets in
+		    //decreasing order of expected mass
+		    double u = rng->uniform() * (Q + R + S);
+		    if (u < Q) {
+			unsigned int k = 0;
+			for ( ; k + 1 < wordList.size(); ++k) {
+			    u -= qterm[k];
+			    if (u < 0) break;
+			}
+			topic = wordList[k];
+		    }
+		    else if (u - Q < R && !docList.empty()) {
+			u -= Q;
+			unsigned int k = 0;
+			for ( ; k + 1 < docList.size(); ++k) {
+			    int t = docList[k];
+			    u -= bw * docTopics[t] / (topicSums[t] + B);
+			    if (u < 0) break;
+			}
+			topic = docList[k];
+		    }
+		    else {
+			u -= Q + R;
+			unsigned int t = 0;
+			for ( ; t + 1 < _nTopic; ++t) {
+			    u -= bw * alpha[t] / (topicSums[t] + B);
+			    if (u < 0) break;
+			}
+			topic = t;
+		    }
+
+		    //Restore current value to tables
+		    adjust(doc, word, topic, 1, wt, alpha, B, S0, R0);
+		    if (wt.track && topic != old) {
+			Move m = {word, old, topic};
+			wt.moves.push_back(m);
+		    }
+		}
+
+		// Remove the contribution of this document from the
+		// q coefficients
+		for (unsigned int k = 0; k < docList.size(); ++k) {
+		    int t = docList[k];
+		    qcoef[t] = alpha[t] / (topicSums[t] + B);
+		}
+	    }
+	}
+
+	void SparseLDA::update(double const *alpha, double const *beta,
+			       RNG *rng)
+	{
+	    sweep(0, _nDoc, _global, alpha, beta, rng);
+	    _local_valid = false;
+	}
+
+	void SparseLDA::updateParallel(double const *alpha,
+				       double const *beta,
+				       RNG *rng, unsigned int nPart)
+	{
+	    if (nPart > _nDoc) nPart = _nDoc;
+	    if (nPart <= 1) {
+		update(alpha, beta, rng);
+		return;
+	    }
+
+	    if (_local.size() != nPart) {
+		_local.assign(nPart, WordTopics(_nTopic, _nWord));
+		_local_valid = false;
+	    }
+	    if (!_local_valid) {
+		// Give each partition a full copy of the word-topic
+		// counts. After this, the copies are kept in step with
+		// the global counts by exchanging topic changes.
+		for (unsigned int p = 0; p < nPart; ++p) {
+		    WordTopics &wt = _local[p];
+		    wt.byWord = _global.byWord;
+		    wt.wordList = _global.wordList;
+		    wt.sums = _global.sums;
+		    wt.track = true;
+		}
+		_local_valid = true;
+	    }
+
+	    // Seed one stream per partition from the chain RNG
+	    vector<unsigned int> seeds(nPart);
+	    for (unsigned int p = 0; p < nPart; ++p) {
+		seeds[p] = static_cast<unsigned int>(rng->uniform() * UINT_MAX);
+		_local[p].moves.clear();
+	    }
+
+            #pragma omp parallel for
+	    for (int p = 0; p < static_cast<int>(nPart); ++p) {
+		StreamRNG prng(seeds[p]);
+		unsigned int first = (_nDoc * p) / nPart;
+		unsigned int last = (_nDoc * (p + 1)) / nPart;
+		sweep(first, last, _local[p], alpha, beta, &prng);
+	    }
+
+	    // Merge the changes made by each partition into the global
+	    // counts, and into the local counts of the other partitions
+	    for (unsigned int p = 0; p < nPart; ++p) {
+		vector<Move> const &moves = _local[p].moves;
+		for (unsigned int k = 0; k < moves.size(); ++k) {
+		    _global.apply(moves[k]);
+		}
+	    }
+
+            #pragma omp parallel for
+	    for (int p = 0; p < static_cast<int>(nPart); ++p) {
+		for (unsigned int q = 0; q < nPart; ++q) {
+		    if (q == static_cast<unsigned int>(p)) continue;
+		    vector<Move> const &moves = _local[q].moves;
+		    for (unsigned int k = 0; k < moves.size(); ++k) {
+			_local[p].apply(moves[k]);
+		    }
+		}
+	    }
+	}
+
+    }
+}
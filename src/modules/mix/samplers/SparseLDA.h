@@ -0,0 +1,135 @@
+#ifndef SPARSE_LDA_H_
+#define SPARSE_LDA_H_
+
+#include <vector>
+
+namespace jags {
+
+    struct RNG;
+
+    namespace mix {
+
+	/**
+	 * @short Sparse collapsed Gibbs sampler for topic indicators
+	 *
+	 * SparseLDA updates the topic indicators of a Latent Dirichlet
+	 * Allocation model, working directly on tables of topic counts
+	 * by document and by word. The full conditional probability of
+	 * topic t for a token of word w in document d is proportional
+	 * to
+	 *
+	 * (n[d,t] + alpha[t]) * (n[w,t] + beta[w]) / (n[t] + B)
+	 *
+	 * where B = sum(beta) and the counts exclude the token being
+	 * sampled. Following Yao, Mimno and McCallum (2009) "Efficient
+	 * methods for topic model inference on streaming document
+	 * collections", this is split into three buckets:
+	 *
+	 * s[t] = alpha[t] * beta[w] / (n[t] + B)
+	 * r[t] = n[d,t] * beta[w] / (n[t] + B)
+	 * q[t] = (n[d,t] + alpha[t]) * n[w,t] / (n[t] + B)
+	 *
+	 * The sums of s and r are updated incrementally as counts
+	 * change, while r and q are non-zero only for topics that
+	 * occur in document d and in word w respectively. The cost of
+	 * sampling a token therefore depends on the number of distinct
+	 * topics in the document and the word, rather than on the
+	 * total number of topics. The dense s bucket, which must be
+	 * traversed when it is selected, usually carries little
+	 * probability mass.
+	 *
+	 * SparseLDA also provides an approximate parallel update,
+	 * following the AD-LDA algorithm of Newman, Asuncion, Smyth and
+	 * Welling (2009) "Distributed algorithms for topic models".
+	 */
+	class SparseLDA {
+	    /* Change of topic for a token of the given word */
+	    struct Move {
+		int word, from, to;
+	    };
+	    /* Word-topic counts, with working space for sampling */
+	    struct WordTopics {
+		std::vector<std::vector<int> > byWord, wordList;
+		std::vector<unsigned int> sums;
+		std::vector<double> qcoef, qterm;
+		/* Log of topic changes, kept for local copies only */
+		bool track;
+		std::vector<Move> moves;
+		WordTopics(unsigned int nTopic, unsigned int nWord);
+		void apply(Move const &m);
+	    };
+	    const unsigned int _nTopic, _nWord, _nDoc;
+	    std::vector<std::vector<int> > _topicTokens, _wordTokens;
+	    std::vector<std::vector<int> > _topicsByDoc, _docTopicList;
+	    WordTopics _global;
+	    std::vector<WordTopics> _local;
+	    bool _local_valid;
+	    void buildTables();
+	    void sweep(unsigned int first, unsigned int last, WordTopics &wt,
+		       double const *alpha, double const *beta, RNG *rng);
+	    void adjust(unsigned int doc, int word, int topic, int delta,
+			WordTopics &wt, double const *alpha, double B,
+			double &S0, double &R0);
+	  public:
+	    /**
+	     * Constructor
+	     *
+	     * @param nTopic Number of topics
+	     * @param nWord Number of words in the vocabulary
+	     * @param topics Initial topic indicators, organized by
+	     * document, with values in 0 ... nTopic - 1
+	     * @param words Word indicators, organized in the same
+	     * way as topics, with values in 0 ... nWord - 1
+	     */
+	    SparseLDA(unsigned int nTopic, unsigned int nWord,
+		      std::vector<std::vector<int> > const &topics,
+		      std::vector<std::vector<int> > const &words);
+	    /**
+	     * Updates all topic indicators in turn.
+	     *
+	     * @param alpha Array of length nTopic giving the Dirichlet
+	     * hyper-parameter for topics within a document
+	     * @param beta Array of length nWord giving the Dirichlet
+	     * hyper-parameter for words within a topic
+	     * @param rng Random number generator
+	     */
+	    void update(double const *alpha, double const *beta, RNG *rng);
+	    /**
+	     * Updates all topic indicators with the approximate
+	     * parallel AD-LDA algorithm.
+	     *
+	     * The documents are divided into nPart contiguous
+	     * partitions. Each partition is swept using a local copy
+	     * of the word-topic counts, ignoring changes made in other
+	     * partitions, and the local changes are merged at the end
+	     * of the sweep. Partitions are sampled in parallel when
+	     * OpenMP is enabled. Each partition has its own random
+	     * number stream, seeded from rng, so the results depend
+	     * on nPart but not on the number of threads.
+	     *
+	     * The local copies are kept between calls. Only the
+	     * tokens that change topic are exchanged between
+	     * partitions, so the cost of merging is proportional to
+	     * nPart times the number of changes, and does not depend
+	     * on the size of the vocabulary or the number of topics.
+	     * Memory use for the word-topic counts is multiplied by
+	     * nPart + 1.
+	     */
+	    void updateParallel(double const *alpha, double const *beta,
+				RNG *rng, unsigned int nPart);
+	    /**
+	     * Replaces the word indicators and recalculates the tables
+	     * of counts. This is required if the words are not fixed.
+	     */
+	    void setWords(std::vector<std::vector<int> > const &words);
+	    /**
+	     * Returns the current topic indicators for the given
+	     * document.
+	     */
+	    std::vector<int> const &topics(unsigned int doc) const;
+	};
+
+    }
+}
+
+#endif /* SPARSE_LDA_H_ */
@@ -0,0 +1,162 @@
+#include "testmixsamp.h"
+#include "SparseLDA.h"
+
+#include <MersenneTwisterRNG.h>
+#include <JRmath.h>
+
+#include <cmath>
+#include <vector>
+#include <sstream>
+
+using std::vector;
+using std::exp;
+using std::ostringstream;
+
+using jags::mix::SparseLDA;
+
+void MixSampTest::setUp()
+{
+    _rng = new jags::base::MersenneTwisterRNG(1234567,
+					      jags::KINDERMAN_RAMAGE);
+}
+
+void MixSampTest::tearDown()
+{
+    delete _rng;
+}
+
+static double logJoint(vector<vector<int> > const &topics,
+		       vector<vector<int> > const &words,
+		       unsigned int nTopic, unsigned int nWord,
+		       double const *alpha, double const *beta)
+{
+    //Log density of the topic indicators, up to a constant, after
+    //integrating out the Dirichlet distributions of topics within
+    //documents and words within topics.
+
+    vector<vector<int> > byWord(nWord, vector<int>(nTopic, 0));
+    vector<int> sums(nTopic, 0);
+    double B = 0;
+    for (unsigned int w = 0; w < nWord; ++w) {
+	B += beta[w];
+    }
+
+    double y = 0;
+    for (unsigned int d = 0; d < topics.size(); ++d) {
+	vector<int> byDoc(nTopic, 0);
+	for (unsigned int i = 0; i < topics[d].size(); ++i) {
+	    byDoc[topics[d][i]]++;
+	    byWord[words[d][i]][topics[d][i]]++;
+	    sums[topics[d][i]]++;
+	}
+	for (unsigned int t = 0; t < nTopic; ++t) {
+	    y += lgammafn(byDoc[t] + alpha[t]);
+	}
+    }
+    for (unsigned int t = 0; t < nTopic; ++t) {
+	for (unsigned int w = 0; w < nWord; ++w) {
+	    y += lgammafn(byWord[w][t] + beta[w]);
+	}
+	y -= lgammafn(sums[t] + B);
+    }
+    return y;
+}
+
+void MixSampTest::sparselda()
+{
+    //Compare the empirical distribution of the topic indicators
+    //with the exact distribution for a small corpus of 3 tokens
+    //with 3 topics, for which there are 27 possible states
+
+    unsigned int const nTopic = 3, nWord = 2;
+    double alpha[nTopic] = {0.5, 1, 2};
+    double beta[nWord] = {0.3, 0.7};
+
+    vector<vector<int> > words(2), topics(2);
+    words[0].push_back(0); words[0].push_back(1);
+    words[1].push_back(0);
+    topics[0].push_back(0); topics[0].push_back(0);
+    topics[1].push_back(0);
+
+    vector<double> p(27);
+    double S = 0;
+    for (unsigned int k = 0; k < 27; ++k) {
+	vector<vector<int> > z(2);
+	z[0].push_back(k % 3); z[0].push_back((k / 3) % 3);
+	z[1].push_back(k / 9);
+	p[k] = exp(logJoint(z, words, nTopic, nWord, alpha, beta));
+	S += p[k];
+    }
+    
+    SparseLDA lda(nTopic, nWord, topics, words);
+    unsigned int N = 100000;
+    vector<double> freq(27, 0);
+    for (unsigned int n = 0; n < N; ++n) {
+	lda.update(alpha, beta, _rng);
+	vector<int> const &z0 = lda.topics(0);
+	vector<int> const &z1 = lda.topics(1);
+	freq[z0[0] + 3 * z0[1] + 9 * z1[0]] += 1.0 / N;
+    }
+
+    for (unsigned int k = 0; k < 27; ++k) {
+	ostringstream msg;
+	msg << "SparseLDA state " << k;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(msg.str(), p[k]/S, freq[k],
+					     0.01);
+    }
+}
+
+void MixSampTest::sparselda_parallel()
+{
+    //The parallel sampler keeps copies of the word-topic counts in
+    //step by exchanging topic changes between partitions. Check that
+    //the copies are consistent with the topic indicators by comparing
+    //the distribution of the next state with that of a sampler
+    //freshly constructed from the same indicators.
+
+    unsigned int const nTopic = 3, nWord = 2, nPart = 2;
+    double alpha[nTopic] = {0.5, 1, 2};
+    double beta[nWord] = {0.3, 0.7};
+
+    vector<vector<int> > words(2), topics(2);
+    words[0].push_back(0); words[0].push_back(1);
+    words[1].push_back(0);
+    topics[0].push_back(0); topics[0].push_back(0);
+    topics[1].push_back(0);
+
+    //Exchange some topic changes before taking the current state
+    SparseLDA lda(nTopic, nWord, topics, words);
+    for (unsigned int n = 0; n < 10; ++n) {
+	lda.updateParallel(alpha, beta, _rng, nPart);
+    }
+    topics[0] = lda.topics(0);
+    topics[1] = lda.topics(1);
+    SparseLDA fresh(nTopic, nWord, topics, words);
+
+    //A parallel update followed by a sequential update, which uses
+    //the merged global counts
+    unsigned int N = 100000;
+    vector<double> freq1(27, 0), freq2(27, 0);
+    for (unsigned int n = 0; n < N; ++n) {
+	SparseLDA lda1(lda);
+	lda1.updateParallel(alpha, beta, _rng, nPart);
+	lda1.update(alpha, beta, _rng);
+	vector<int> const &z0 = lda1.topics(0);
+	vector<int> const &z1 = lda1.topics(1);
+	freq1[z0[0] + 3 * z0[1] + 9 * z1[0]] += 1.0 / N;
+
+	SparseLDA lda2(fresh);
+	lda2.updateParallel(alpha, beta, _rng, nPart);
+	lda2.update(alpha, beta, _rng);
+	vector<int> const &y0 = lda2.topics(0);
+	vector<int> const &y1 = lda2.topics(1);
+	freq2[y0[0] + 3 * y0[1] + 9 * y1[0]] += 1.0 / N;
+    }
+
+    for (unsigned int k = 0; k < 27; ++k) {
+	ostringstream msg;
+	msg << "SparseLDA parallel state " << k;
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(msg.str(), freq2[k], freq1[k],
+					     0.01);
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef MIX_SAMP_TEST_H
+#define MIX_SAMP_TEST_H
+
+namespace jags {
+    struct RNG;
+}
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+class MixSampTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( MixSampTest );
+    CPPUNIT_TEST( sparselda );
+    CPPUNIT_TEST( sparselda_parallel );
+    CPPUNIT_TEST_SUITE_END();
+
+    jags::RNG *_rng;
+
+  public:
+    void setUp();
+    void tearDown();
+    void sparselda();
+    void sparselda_parallel();
+};
+
+#endif  // MIX_SAMP_TEST_H
@@ -1,11 +1,14 @@
 #include <config.h>
 
 #include "Mexp.h"
-#include "matexp.h"
+#include "MatExpCache.h"
 
 #include <util/dim.h>
 
+#include <algorithm>
+
 using std::vector;
+using std::copy;
 
 namespace jags {
 namespace msm {
@@ -18,7 +21,9 @@ Mexp::Mexp()
 void Mexp::evaluate (double *value, vector<double const *> const &args,
                      vector<vector<unsigned long> > const &dims) const
 {
-    MatrixExpPade(value, args[0], dims[0][0], 1);
+    int n = dims[0][0];
+    double const *P = MatExpCache::expm(args[0], n, 1);
+    copy(P, P + n * n, value);
 }
 
 vector<unsigned long> Mexp::dim (vector <vector<unsigned long> > const &dims,
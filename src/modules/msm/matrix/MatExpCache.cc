@@ -0,0 +1,203 @@
+#include <config.h>
+
+#include "MatExpCache.h"
+#include "matexp.h"
+#include "lapack.h"
+
+#include <util/ValueCache.h>
+
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using std::map;
+using std::vector;
+using std::max;
+using std::fabs;
+using std::exp;
+using std::cos;
+using std::sin;
+
+//Maximum number of bytes held by the cache of each thread
+#define MAX_CACHE_SIZE 8388608
+//Relative tolerance for reconstructing A from its eigen decomposition
+#define EIGEN_TOL 1.0E-10
+//Maximum condition number of the matrix of eigenvectors
+#define MAX_COND 1.0E8
+
+namespace {
+
+    struct ExpEntry {
+	bool eigen;
+	std::vector<double> wr, wi, V, Vinv;
+	std::map<double, std::vector<double> > P;
+    };
+
+    thread_local jags::ValueCache<ExpEntry> cache(MAX_CACHE_SIZE);
+
+    //Maximum absolute column sum of an n x n matrix
+    double norm1(std::vector<double> const &X, int n)
+    {
+	double y = 0;
+	for (int j = 0; j < n; ++j) {
+	    double s = 0;
+	    for (int i = 0; i < n; ++i) {
+		s += fabs(X[i + n * j]);
+	    }
+	    y = max(y, s);
+	}
+	return y;
+    }
+
+    /*
+      Calculates VB = V %*% B where B is block diagonal. A real
+      eigenvalue wr[k] gives a 1x1 block exp(wr[k] * t).  A complex
+      pair wr[k] +/- i * wi[k], with eigenvectors stored by DGEEV in
+      columns k and k + 1 of V, gives the 2x2 block
+
+      exp(wr[k] * t) * ( cos(wi[k] * t)   sin(wi[k] * t) )
+                       ( -sin(wi[k] * t)  cos(wi[k] * t) )
+
+      If expon is false then B is the block diagonal form of A itself,
+      with diagonal wr and off-diagonal elements +/- wi.
+    */
+    void blockProduct(double *VB, ExpEntry const &entry, int n, double t,
+		      bool expon)
+    {
+	double const *V = &entry.V[0];
+	for (int k = 0; k < n; ++k) {
+	    double a = entry.wr[k], b = entry.wi[k];
+	    double const *v1 = V + n * k;
+	    if (b == 0) {
+		double d = expon ? exp(a * t) : a;
+		for (int i = 0; i < n; ++i) {
+		    VB[i + n * k] = v1[i] * d;
+		}
+	    }
+	    else {
+		double const *v2 = v1 + n;
+		double c = a, s = b;
+		if (expon) {
+		    double r = exp(a * t);
+		    c = r * cos(b * t);
+		    s = r * sin(b * t);
+		}
+		for (int i = 0; i < n; ++i) {
+		    VB[i + n * k] = c * v1[i] - s * v2[i];
+		    VB[i + n * (k + 1)] = s * v1[i] + c * v2[i];
+		}
+		++k;
+	    }
+	}
+    }
+
+    /*
+      Finds the decomposition A = V %*% B %*% Vinv where B is the
+      real block diagonal form of the eigenvalues. Returns false if
+      the decomposition does not reproduce A to within the tolerance,
+      which happens when A is defective, or if V is ill-conditioned.
+      In the second case the reconstruction of A may pass the check
+      while exp(A*t) loses accuracy, as errors in exp(B*t) are
+      magnified by up to the condition number of V.
+    */
+    bool decompose(ExpEntry &entry, double const *A, int n)
+    {
+	int N = n * n;
+	vector<double> a(A, A + N);
+	vector<double> vl(1);
+	entry.wr.resize(n);
+	entry.wi.resize(n);
+	entry.V.resize(N);
+
+	int info = 0;
+	int ldvl = 1;
+	int lwork = -1;
+	double worktest = 0;
+	F77_DGEEV("N", "V", &n, &a[0], &n, &entry.wr[0], &entry.wi[0],
+		  &vl[0], &ldvl, &entry.V[0], &n, &worktest, &lwork, &info);
+	if (info != 0) return false;
+	lwork = static_cast<int>(worktest);
+	vector<double> work(lwork);
+	F77_DGEEV("N", "V", &n, &a[0], &n, &entry.wr[0], &entry.wi[0],
+		  &vl[0], &ldvl, &entry.V[0], &n, &work[0], &lwork, &info);
+	if (info != 0) return false;
+
+	//Invert the matrix of eigenvectors
+	entry.Vinv.assign(N, 0);
+	for (int i = 0; i < n; ++i) {
+	    entry.Vinv[i + n * i] = 1;
+	}
+	vector<double> Vcopy(entry.V);
+	vector<int> ipiv(n);
+	F77_DGESV(&n, &n, &Vcopy[0], &n, &ipiv[0], &entry.Vinv[0], &n, &info);
+	if (info != 0) return false;
+	if (!(norm1(entry.V, n) * norm1(entry.Vinv, n) <= MAX_COND)) {
+	    return false;
+	}
+
+	//Check the reconstruction
+	vector<double> VB(N), A2(N);
+	blockProduct(&VB[0], entry, n, 0, false);
+	double one = 1, zero = 0;
+	F77_DGEMM("N", "N", &n, &n, &n, &one, &VB[0], &n, &entry.Vinv[0], &n,
+		  &zero, &A2[0], &n);
+	double amax = 1;
+	for (int i = 0; i < N; ++i) {
+	    amax = max(amax, fabs(A[i]));
+	}
+	for (int i = 0; i < N; ++i) {
+	    if (!(fabs(A2[i] - A[i]) <= EIGEN_TOL * amax)) {
+		return false;
+	    }
+	}
+	return true;
+    }
+
+}
+
+namespace jags {
+namespace msm {
+
+double const *MatExpCache::expm(double const *A, int n, double t)
+{
+    unsigned long N = n * n;
+
+    ExpEntry *p = cache.find(A, N);
+    if (!p) {
+	p = &cache.insert(A, N);
+	p->P.clear();
+	p->eigen = decompose(*p, A, n);
+	cache.charge(A, (p->wr.size() + p->wi.size() + p->V.size() +
+			 p->Vinv.size()) * sizeof(double));
+    }
+    ExpEntry &entry = *p;
+
+    map<double, vector<double> >::const_iterator q = entry.P.find(t);
+    if (q != entry.P.end()) {
+	return &q->second[0];
+    }
+
+    unsigned long bytes = N * sizeof(double);
+    if (!cache.charge(A, bytes)) {
+	//The times stored for this matrix fill the cache on their own
+	cache.release(A, entry.P.size() * bytes);
+	entry.P.clear();
+    }
+    vector<double> &P = entry.P[t];
+    P.resize(N);
+    if (entry.eigen) {
+	//P = V %*% exp(B * t) %*% Vinv
+	vector<double> VD(N);
+	blockProduct(&VD[0], entry, n, t, true);
+	double one = 1, zero = 0;
+	F77_DGEMM("N", "N", &n, &n, &n, &one, &VD[0], &n, &entry.Vinv[0], &n,
+		  &zero, &P[0], &n);
+    }
+    else {
+	MatrixExpPade(&P[0], A, n, t);
+    }
+    return &P[0];
+}
+
+}}
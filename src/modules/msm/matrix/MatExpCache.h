@@ -0,0 +1,48 @@
+#ifndef MAT_EXP_CACHE_H_
+#define MAT_EXP_CACHE_H_
+
+namespace jags {
+namespace msm {
+
+/**
+ * @short Cache of matrix exponentials
+ *
+ * In multi-state models, many observations share the same intensity
+ * matrix, and often the same observation time. MatExpCache keeps,
+ * for each recently used matrix A, the values of exp(A*t) that have
+ * been calculated, so that repeated pairs (A, t) are looked up
+ * without further calculation.
+ *
+ * When A is diagonalizable, its eigen decomposition is also stored,
+ * so that exp(A*t) for a new value of t needs only a matrix
+ * product. Complex eigenvalues are handled with the real block
+ * diagonal form. The Pade approximation of MatrixExpPade is used
+ * instead if A is defective, or if the matrix of eigenvectors is so
+ * badly conditioned that the product would be inaccurate.
+ *
+ * Entries are kept in a ValueCache for each thread. An intensity
+ * matrix that depends on unknown parameters changes at every
+ * iteration, and its stored decomposition and times are discarded as
+ * soon as it does. When the storage limit is reached, the entries for
+ * other matrices are discarded first, and then the times stored for
+ * the current one.
+ */
+class MatExpCache {
+  public:
+    /**
+     * Returns exp(A*t)
+     *
+     * @param A Pointer to an array of length n squared containing a
+     * square matrix in column-major order
+     * @param n Number of rows or columns in the matrix
+     * @param t Time
+     *
+     * @return Pointer to an array of length n squared. It remains
+     * valid until the next call from the same thread.
+     */
+    static double const *expm(double const *A, int n, double t);
+};
+
+}}
+
+#endif /* MAT_EXP_CACHE_H_ */
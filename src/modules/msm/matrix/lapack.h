@@ -6,6 +6,7 @@
 #define F77_DGEMM  F77_FUNC(dgemm,DGEMM)
 #define F77_DSCAL  F77_FUNC(dscal,DSCAL)
 #define F77_DLANGE F77_FUNC(dlange,DLANGE)
+#define F77_DGEEV F77_FUNC(dgeev,DGEEV)
 
 extern "C" {
 
@@ -18,6 +19,12 @@ extern "C" {
     
     double F77_DLANGE (const char *norm, const int *m, const int *n,
 		       const double *a, const int *lda, double *work);
+
+    void F77_DGEEV (const char* jobvl, const char* jobvr,
+		    const int* n, double* a, const int* lda,
+		    double* wr, double* wi, double* vl, const int* ldvl,
+		    double* vr, const int* ldvr,
+		    double* work, const int* lwork, int* info);
     
     /* BLAS routines */
 
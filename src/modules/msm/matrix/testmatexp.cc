@@ -0,0 +1,148 @@
+#include "testmatexp.h"
+#include "MatExpCache.h"
+#include "matexp.h"
+
+#include <vector>
+#include <cmath>
+
+using std::vector;
+using std::fabs;
+
+using jags::msm::MatExpCache;
+using jags::msm::MatrixExpPade;
+
+/*
+  Checks that MatExpCache gives the same value of exp(A*t) as the Pade
+  approximation, both when it is first calculated and when it is
+  looked up again
+*/
+static void checkExp(vector<double> const &A, int n, double t)
+{
+    vector<double> P(n * n);
+    MatrixExpPade(&P[0], &A[0], n, t);
+    for (unsigned int rep = 0; rep < 2; ++rep) {
+	double const *C = MatExpCache::expm(&A[0], n, t);
+	for (int i = 0; i < n * n; ++i) {
+	    CPPUNIT_ASSERT_DOUBLES_EQUAL(P[i], C[i], 1.0E-8);
+	}
+    }
+}
+
+/*
+  Intensity matrix of a multi-state model, with non-negative
+  off-diagonal elements and rows that sum to zero. Some of the
+  transition intensities are zero.
+*/
+static void intensity(vector<double> &Q, int n, unsigned int seed)
+{
+    Q.assign(n * n, 0);
+    for (int i = 0; i < n; ++i) {
+	double s = 0;
+	for (int j = 0; j < n; ++j) {
+	    if (i != j) {
+		unsigned int k = (seed + 7 * i + 3 * j) % 5;
+		Q[i + n * j] = k / 4.0;
+		s += Q[i + n * j];
+	    }
+	}
+	Q[i + n * i] = -s;
+    }
+}
+
+void MatExpTest::cache()
+{
+    double const t[] = {0.1, 0.8, 1.5, 0.8, 3.2};
+    vector<double> Q;
+    for (int n = 2; n < 8; ++n) {
+	for (unsigned int seed = 0; seed < 5; ++seed) {
+	    intensity(Q, n, seed);
+	    for (unsigned int k = 0; k < 5; ++k) {
+		checkExp(Q, n, t[k]);
+	    }
+	}
+    }
+}
+
+void MatExpTest::defective()
+{
+    //Jordan block, for which there is no eigen decomposition
+    double const Qv[9] = {-1, 0, 0, 1, -1, 0, 0, 1, -1};
+    vector<double> Q(Qv, Qv + 9);
+    checkExp(Q, 3, 2.0);
+    checkExp(Q, 3, 0.5);
+}
+
+void MatExpTest::complex()
+{
+    //Cyclic transitions, giving complex eigenvalues
+    double const Qv[9] = {-1, 0, 1, 1, -1, 0, 0, 1, -1};
+    vector<double> Q(Qv, Qv + 9);
+    checkExp(Q, 3, 1.3);
+    checkExp(Q, 3, 4.0);
+}
+
+void MatExpTest::change()
+{
+    //Changing the matrix in place, at the same address, must not
+    //return the values stored for the old matrix, whether or not the
+    //time has been seen before
+    vector<double> Q;
+    intensity(Q, 4, 1);
+    checkExp(Q, 4, 1.0);
+    checkExp(Q, 4, 2.0);
+
+    Q[1] += 0.5;
+    Q[0] -= 0.5;
+    checkExp(Q, 4, 1.0);
+    checkExp(Q, 4, 3.0);
+
+    //Change from a diagonalizable to a defective matrix and back
+    double const Jv[9] = {-1, 0, 0, 1, -1, 0, 0, 1, -1};
+    vector<double> A(Jv, Jv + 9);
+    A[3] = 0.5;
+    A[0] = -0.5;
+    checkExp(A, 3, 2.0);
+    A[3] = 1;
+    A[0] = -1;
+    checkExp(A, 3, 2.0);
+    A[3] = 0.5;
+    A[0] = -0.5;
+    checkExp(A, 3, 2.0);
+}
+
+void MatExpTest::illcond()
+{
+    //Nearly defective matrix. The eigen decomposition reproduces A
+    //accurately, but the eigenvectors are almost parallel, so
+    //exp(A*t) calculated from them would lose accuracy
+    double const Qv[4] = {-1, 0, 1, -1 - 1.0E-9};
+    vector<double> Q(Qv, Qv + 4);
+    checkExp(Q, 2, 1.0);
+    checkExp(Q, 2, 5.0);
+}
+
+void MatExpTest::times()
+{
+    //Many distinct times for the same matrix, which exceed the
+    //storage limit of the cache
+    vector<double> Q;
+    intensity(Q, 6, 2);
+    for (unsigned int k = 0; k < 40000; ++k) {
+	double t = 0.001 * k;
+	double const *C = MatExpCache::expm(&Q[0], 6, t);
+	if (k % 997 == 0) {
+	    checkExp(Q, 6, t);
+	}
+	else {
+	    //Rows of a transition matrix sum to one
+	    for (int i = 0; i < 6; ++i) {
+		double s = 0;
+		for (int j = 0; j < 6; ++j) {
+		    s += C[i + 6 * j];
+		}
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, s, 1.0E-8);
+	    }
+	}
+    }
+    checkExp(Q, 6, 0.5);
+}
@@ -0,0 +1,26 @@
+#ifndef MAT_EXP_TEST_H_
+#define MAT_EXP_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class MatExpTest : public CppUnit::TestFixture
+{
+    CPPUNIT_TEST_SUITE( MatExpTest );
+    CPPUNIT_TEST( cache );
+    CPPUNIT_TEST( defective );
+    CPPUNIT_TEST( complex );
+    CPPUNIT_TEST( change );
+    CPPUNIT_TEST( illcond );
+    CPPUNIT_TEST( times );
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void cache();
+    void defective();
+    void complex();
+    void change();
+    void illcond();
+    void times();
+};
+
+#endif /* MAT_EXP_TEST_H_ */
@@ -0,0 +1,7 @@
+#include "testmsm.h"
+#include "matrix/testmatexp.h"
+#include <cppunit/extensions/HelperMacros.h>
+
+void init_msm_test() {
+    CPPUNIT_TEST_SUITE_REGISTRATION( MatExpTest );
+}
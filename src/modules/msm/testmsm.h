@@ -0,0 +1,6 @@
+#ifndef MSM_TEST_H_
+#define MSM_TEST_H_
+
+void init_msm_test();
+
+#endif /* MSM_TEST_H_ */
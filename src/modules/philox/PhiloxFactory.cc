@@ -0,0 +1,63 @@
+#include <config.h>
+
+#include "PhiloxFactory.h"
+#include "PhiloxRNG.h"
+
+#include <ctime>
+
+using std::vector;
+using std::time;
+using std::string;
+
+namespace jags {
+namespace philox {
+
+    PhiloxFactory::PhiloxFactory()
+	: _seed(static_cast<unsigned int>(time(NULL))), _next(0)
+    {
+    }
+    
+    PhiloxFactory::~PhiloxFactory()
+    {
+	for (unsigned int i = 0; i < _rngvec.size(); ++i) {
+	    delete _rngvec[i];
+	}
+    }
+
+    void PhiloxFactory::setSeed(unsigned int seed)
+    {
+	_seed = seed;
+	_next = 0;
+    }
+
+    vector<RNG *> PhiloxFactory::makeRNGs(unsigned int n)
+    {
+	vector<RNG *> ans;
+	for (unsigned int i = 0; i < n; ++i) {
+	    RNG *rng = new PhiloxRNG(_seed, _next++);
+	    _rngvec.push_back(rng);
+	    ans.push_back(rng);
+	}
+	return ans;
+    }
+
+    RNG * PhiloxFactory::makeRNG(string const &name)
+    {
+	string basename;
+	NormKind kind = RmathRNG::normKind(name, basename);
+	if (basename == "philox::Philox4x32") {
+	    RNG *rng = new PhiloxRNG(_seed, _next++, kind);
+	    _rngvec.push_back(rng);
+	    return rng;
+	}
+	else {
+	    return 0;
+	}
+    }
+
+    string PhiloxFactory::name() const
+    {
+	return "philox::Philox";
+    }
+
+}}
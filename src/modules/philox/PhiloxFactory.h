@@ -0,0 +1,32 @@
+#ifndef PHILOX_FACTORY_H_
+#define PHILOX_FACTORY_H_
+
+#include <rng/RNGFactory.h>
+
+namespace jags {
+namespace philox {
+
+    /**
+     * @short Factory object for Philox RNGs
+     *
+     * All RNGs produced by the factory share the same seed, and are
+     * given consecutive chain numbers, so that they generate
+     * independent streams. The number of chains is not limited.
+     */
+    class PhiloxFactory : public RNGFactory
+    {
+	unsigned int _seed;
+	unsigned int _next;
+	std::vector<RNG*> _rngvec;
+    public:
+	PhiloxFactory();
+	~PhiloxFactory();
+	void setSeed(unsigned int seed);
+	std::vector<RNG *> makeRNGs(unsigned int n);
+	RNG * makeRNG(std::string const &name);
+	std::string name() const;
+    };
+
+}}
+
+#endif /* PHILOX_FACTORY_H_ */
@@ -0,0 +1,142 @@
+#include <config.h>
+
+#include "PhiloxRNG.h"
+
+using std::vector;
+
+/* Multipliers and Weyl sequence constants of Philox4x32 */
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+#define two26 67108864.0              /* 2^26 */
+#define i2_53 1.1102230246251565e-16  /* 2^-53 */
+
+namespace jags {
+namespace philox {
+
+    void PhiloxRNG::block(unsigned int ctr[4], unsigned int const key[2])
+    {
+	unsigned int k0 = key[0], k1 = key[1];
+	for (int r = 0; r < PHILOX_ROUNDS; ++r) {
+	    unsigned long long p0 = 
+		static_cast<unsigned long long>(PHILOX_M0) * ctr[0];
+	    unsigned long long p1 = 
+		static_cast<unsigned long long>(PHILOX_M1) * ctr[2];
+	    unsigned int hi0 = static_cast<unsigned int>(p0 >> 32);
+	    unsigned int lo0 = static_cast<unsigned int>(p0);
+	    unsigned int hi1 = static_cast<unsigned int>(p1 >> 32);
+	    unsigned int lo1 = static_cast<unsigned int>(p1);
+	    ctr[0] = hi1 ^ ctr[1] ^ k0;
+	    ctr[1] = lo1;
+	    ctr[2] = hi0 ^ ctr[3] ^ k1;
+	    ctr[3] = lo0;
+	    k0 += PHILOX_W0;
+	    k1 += PHILOX_W1;
+	}
+    }
+
+    PhiloxRNG::PhiloxRNG(unsigned int seed, unsigned int chain,
+			 NormKind norm_kind)
+	: RmathRNG("philox::Philox4x32", norm_kind)
+    {
+	setStream(seed, chain, 0);
+    }
+
+    void PhiloxRNG::refill()
+    {
+	_buf[0] = static_cast<unsigned int>(_block);
+	_buf[1] = static_cast<unsigned int>(_block >> 32);
+	_buf[2] = _substream;
+	_buf[3] = 0;
+	unsigned int key[2] = {_seed, _chain};
+	block(_buf, key);
+    }
+
+    void PhiloxRNG::setStream(unsigned int seed, unsigned int chain,
+			      unsigned int substream)
+    {
+	_seed = seed;
+	_chain = chain;
+	setSubstream(substream);
+    }
+
+    void PhiloxRNG::setSubstream(unsigned int substream)
+    {
+	_substream = substream;
+	_block = 0;
+	_pos = 0;
+	refill();
+    }
+
+    void PhiloxRNG::init(unsigned int seed)
+    {
+	setStream(seed, _chain, 0);
+    }
+
+    void PhiloxRNG::skip(unsigned long long n)
+    {
+	// Each block holds two uniform random variables
+	unsigned long long k = _pos / 2 + n;
+	_block += k / 2;
+	_pos = 2 * (k % 2);
+	refill();
+    }
+
+    bool PhiloxRNG::setState(vector<int> const &state)
+    {
+	if (state.size() != 6)
+	    return false;
+
+	unsigned int pos = static_cast<unsigned int>(state[5]);
+	if (pos != 0 && pos != 2 && pos != 4)
+	    return false;
+
+	_seed = static_cast<unsigned int>(state[0]);
+	_chain = static_cast<unsigned int>(state[1]);
+	_substream = static_cast<unsigned int>(state[2]);
+	_block = static_cast<unsigned int>(state[3]) |
+	    (static_cast<unsigned long long>(
+		static_cast<unsigned int>(state[4])) << 32);
+	_pos = pos;
+	refill();
+	return true;
+    }
+
+    void PhiloxRNG::getState(vector<int> &state) const
+    {
+	state.clear();
+	state.push_back(static_cast<int>(_seed));
+	state.push_back(static_cast<int>(_chain));
+	state.push_back(static_cast<int>(_substream));
+	state.push_back(static_cast<int>(static_cast<unsigned int>(_block)));
+	state.push_back(static_cast<int>(
+			    static_cast<unsigned int>(_block >> 32)));
+	state.push_back(static_cast<int>(_pos));
+    }
+
+    double PhiloxRNG::uniform()
+    {
+	if (_pos == 4) {
+	    ++_block;
+	    _pos = 0;
+	    refill();
+	}
+	/* Combine 27 and 26 bits and add 1/2 so that the result is
+	   strictly inside (0,1) */
+	double a = _buf[_pos] >> 5;
+	double b = _buf[_pos + 1] >> 6;
+	_pos += 2;
+	return (a * two26 + b + 0.5) * i2_53;
+    }
+
+    void PhiloxRNG::uniform(double *x, unsigned long n)
+    {
+	for (unsigned long i = 0; i < n; ++i) {
+	    x[i] = PhiloxRNG::uniform();
+	}
+    }
+
+}}
@@ -0,0 +1,86 @@
+#ifndef PHILOX_RNG_H_
+#define PHILOX_RNG_H_
+
+#include <rng/RmathRNG.h>
+
+namespace jags {
+namespace philox {
+
+    /**
+     * @short Philox4x32-10 counter-based random number generator
+     *
+     * Philox is a counter-based generator (Salmon JK, Moraes MA, Dror
+     * RO and Shaw DE (2011) Parallel random numbers: as easy as 1, 2,
+     * 3. Proceedings of the International Conference for High
+     * Performance Computing, Networking, Storage and Analysis). Each
+     * block of four 32-bit outputs is a bijective function of a
+     * 128-bit counter and a 64-bit key, so there is no sequential
+     * state other than the counter.
+     *
+     * A stream is identified by a seed, a chain number and a
+     * substream number. The seed and chain form the key and the
+     * substream occupies the third word of the counter, leaving 2^64
+     * blocks for each substream. Any position in a stream can be
+     * reached in constant time, and the state consists only of the
+     * stream indices and the position.
+     *
+     * Each uniform random variable uses two 32-bit outputs, giving 53
+     * bits of precision.
+     */
+    class PhiloxRNG : public RmathRNG {
+	unsigned int _seed, _chain, _substream;
+	unsigned long long _block;
+	unsigned int _buf[4];
+	unsigned int _pos;
+	void refill();
+    public:
+	/**
+	 * Constructor.
+	 *
+	 * @param seed Seed, which forms the first word of the key
+	 * @param chain Chain number, which forms the second word of
+	 * the key
+	 * @param norm_kind Algorithm for normal random variables
+	 */
+	PhiloxRNG(unsigned int seed, unsigned int chain,
+		  NormKind norm_kind = KINDERMAN_RAMAGE);
+	/**
+	 * Moves to the start of substream 0 for the given seed. The
+	 * chain number is not changed, so that generators for
+	 * different chains remain independent after they are
+	 * re-initialized with the same seed.
+	 */
+	void init(unsigned int seed);
+	bool setState(std::vector<int> const &state);
+	void getState(std::vector<int> &state) const;
+	double uniform();
+	void uniform(double *x, unsigned long n);
+	/**
+	 * Moves to the start of the given stream.
+	 */
+	void setStream(unsigned int seed, unsigned int chain, 
+		       unsigned int substream);
+	/**
+	 * Moves to the start of the given substream of the current
+	 * seed and chain. Substreams may be given to independent
+	 * pieces of work within a chain, so that the results do not
+	 * depend on the order in which the pieces are run.
+	 */
+	void setSubstream(unsigned int substream);
+	/**
+	 * Advances the generator by n uniform random variables in
+	 * constant time.
+	 */
+	void skip(unsigned long long n);
+	/**
+	 * Calculates a single block of the Philox4x32-10 function
+	 *
+	 * @param ctr Counter, overwritten with the output
+	 * @param key Key
+	 */
+	static void block(unsigned int ctr[4], unsigned int const key[2]);
+    };
+
+}}
+
+#endif /* PHILOX_RNG_H_ */
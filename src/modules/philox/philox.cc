@@ -0,0 +1,32 @@
+#include <module/Module.h>
+#include "PhiloxFactory.h"
+
+using std::vector;
+
+namespace jags {
+namespace philox {
+
+    class PhiloxModule : public Module {
+
+    public:
+	PhiloxModule();
+	~PhiloxModule();
+    };
+
+    PhiloxModule::PhiloxModule() 
+	: Module("philox") 
+    {
+	insert(new PhiloxFactory);
+    }
+    
+    PhiloxModule::~PhiloxModule() {
+	
+	vector<RNGFactory*> const &rvec = rngFactories();
+	for (unsigned int i = 0; i < rvec.size(); ++i) {
+	    delete rvec[i];
+	}
+    }
+    
+}}
+
+jags::philox::PhiloxModule _philox_module;
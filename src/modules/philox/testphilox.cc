@@ -0,0 +1,7 @@
+#include "testphilox.h"
+#include "testphiloxrng.h"
+#include <cppunit/extensions/HelperMacros.h>
+
+void init_philox_test() {
+    CPPUNIT_TEST_SUITE_REGISTRATION( PhiloxTest );
+}
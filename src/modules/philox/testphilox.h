@@ -0,0 +1,6 @@
+#ifndef PHILOX_TEST_H_
+#define PHILOX_TEST_H_
+
+void init_philox_test();
+
+#endif /* PHILOX_TEST_H_ */
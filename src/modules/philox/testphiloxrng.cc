@@ -0,0 +1,80 @@
+#include "testphiloxrng.h"
+#include "PhiloxRNG.h"
+
+#include <vector>
+
+using std::vector;
+
+using jags::philox::PhiloxRNG;
+
+void PhiloxTest::kat()
+{
+    //Known answer tests for Philox4x32-10 from the Random123 library
+    unsigned int const ctr[3][4] = {
+	{0x00000000U, 0x00000000U, 0x00000000U, 0x00000000U},
+	{0xffffffffU, 0xffffffffU, 0xffffffffU, 0xffffffffU},
+	{0x243f6a88U, 0x85a308d3U, 0x13198a2eU, 0x03707344U}
+    };
+    unsigned int const key[3][2] = {
+	{0x00000000U, 0x00000000U},
+	{0xffffffffU, 0xffffffffU},
+	{0xa4093822U, 0x299f31d0U}
+    };
+    unsigned int const expected[3][4] = {
+	{0x6627e8d5U, 0xe169c58dU, 0xbc57ac4cU, 0x9b00dbd8U},
+	{0x408f276dU, 0x41c83b0eU, 0xa20bc7c6U, 0x6d5451fdU},
+	{0xd16cfe09U, 0x94fdccebU, 0x5001e420U, 0x24126ea1U}
+    };
+
+    for (unsigned int i = 0; i < 3; ++i) {
+	unsigned int x[4] = {ctr[i][0], ctr[i][1], ctr[i][2], ctr[i][3]};
+	PhiloxRNG::block(x, key[i]);
+	for (unsigned int j = 0; j < 4; ++j) {
+	    CPPUNIT_ASSERT_EQUAL(expected[i][j], x[j]);
+	}
+    }
+}
+
+void PhiloxTest::init()
+{
+    //Re-initializing with a seed must keep the chain number, so that
+    //generators for different chains still give different streams
+    PhiloxRNG rng0(1, 0), rng1(1, 1);
+    rng0.init(42);
+    rng1.init(42);
+    CPPUNIT_ASSERT(rng0.uniform() != rng1.uniform());
+
+    PhiloxRNG ref(42, 1);
+    rng1.init(42);
+    for (unsigned int i = 0; i < 10; ++i) {
+	CPPUNIT_ASSERT_EQUAL(ref.uniform(), rng1.uniform());
+    }
+
+    vector<int> state;
+    rng1.getState(state);
+    CPPUNIT_ASSERT_EQUAL(1, state[1]);
+}
+
+void PhiloxTest::state()
+{
+    //Restoring the state and skipping ahead must reproduce the stream
+    PhiloxRNG rng(123, 2);
+    rng.setSubstream(5);
+    rng.uniform();
+    vector<int> state;
+    rng.getState(state);
+
+    vector<double> x(7);
+    rng.uniform(&x[0], x.size());
+
+    PhiloxRNG rng2(0, 0);
+    CPPUNIT_ASSERT(rng2.setState(state));
+    for (unsigned int i = 0; i < x.size(); ++i) {
+	CPPUNIT_ASSERT_EQUAL(x[i], rng2.uniform());
+    }
+
+    PhiloxRNG rng3(123, 2);
+    rng3.setSubstream(5);
+    rng3.skip(4);
+    CPPUNIT_ASSERT_EQUAL(x[3], rng3.uniform());
+}
@@ -0,0 +1,21 @@
+#ifndef PHILOX_RNG_TEST_H_
+#define PHILOX_RNG_TEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <testlib.h>
+
+class PhiloxTest : public CppUnit::TestFixture, public JAGSFixture
+{
+    CPPUNIT_TEST_SUITE( PhiloxTest );
+    CPPUNIT_TEST( kat );
+    CPPUNIT_TEST( init );
+    CPPUNIT_TEST( state );
+    CPPUNIT_TEST_SUITE_END();
+
+  public:
+    void kat();
+    void init();
+    void state();
+};
+
+#endif /* PHILOX_RNG_TEST_H_ */
@@ -0,0 +1,230 @@
+/**
+ * Timing benchmarks for performance-sensitive code.
+ *
+ * These are not part of the test suite run by "make check". Build
+ * them with "make bench" and run "./bench" to time everything, or
+ * "./bench name ..." to time selected benchmarks.
+ */
+
+#include <config.h>
+
+#include <mix/samplers/SparseLDA.h>
+#include <MersenneTwisterRNG.h>
+#include <rng/TruncatedNormal.h>
+#include <util/nainf.h>
+
+#include <ctime>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+
+using std::vector;
+using std::string;
+using std::strcmp;
+
+using jags::RNG;
+using jags::NormKind;
+using jags::base::MersenneTwisterRNG;
+using jags::mix::SparseLDA;
+
+static void report(char const *what, double n, char const *units,
+		   std::clock_t start)
+{
+    double secs = static_cast<double>(std::clock() - start) /
+	CLOCKS_PER_SEC;
+    std::cout << what << ": ";
+    if (secs > 0) {
+	std::cout << n / secs << " " << units << "/sec";
+    }
+    std::cout << std::endl;
+}
+
+static void bulk()
+{
+    //Throughput of single and bulk draws from the Mersenne-Twister
+    //generator
+
+    unsigned int const N = 1000, nrep = 10000;
+    vector<double> x(N);
+    RNG *rng = new MersenneTwisterRNG(1234567, jags::KINDERMAN_RAMAGE);
+    double total = static_cast<double>(N) * nrep;
+
+    std::clock_t start = std::clock();
+    for (unsigned int r = 0; r < nrep; ++r) {
+	for (unsigned int i = 0; i < N; ++i) {
+	    x[i] = rng->uniform();
+	}
+    }
+    report("Single uniform", total, "variates", start);
+
+    start = std::clock();
+    for (unsigned int r = 0; r < nrep; ++r) {
+	rng->uniform(&x[0], N);
+    }
+    report("Bulk uniform", total, "variates", start);
+
+    start = std::clock();
+    for (unsigned int r = 0; r < nrep; ++r) {
+	for (unsigned int i = 0; i < N; ++i) {
+	    x[i] = rng->normal();
+	}
+    }
+    report("Single normal", total, "variates", start);
+
+    start = std::clock();
+    for (unsigned int r = 0; r < nrep; ++r) {
+	rng->normal(&x[0], N);
+    }
+    report("Bulk normal", total, "variates", start);
+
+    delete rng;
+}
+
+static void ziggurat()
+{
+    //Throughput of normal and exponential draws from the
+    //Mersenne-Twister generator for each algorithm
+
+    unsigned int const N = 1000, nrep = 10000;
+    vector<double> x(N);
+    double total = static_cast<double>(N) * nrep;
+    NormKind kinds[4] = {jags::AHRENS_DIETER, jags::BOX_MULLER,
+			 jags::KINDERMAN_RAMAGE, jags::ZIGGURAT};
+    char const *names[4] = {"Ahrens-Dieter", "Box-Muller",
+			    "Kinderman-Ramage", "Ziggurat"};
+
+    for (unsigned int j = 0; j < 4; ++j) {
+	RNG *rng = new MersenneTwisterRNG(1234567, kinds[j]);
+	string what = string(names[j]) + " normal";
+	std::clock_t start = std::clock();
+	for (unsigned int r = 0; r < nrep; ++r) {
+	    rng->normal(&x[0], N);
+	}
+	report(what.c_str(), total, "variates", start);
+	delete rng;
+    }
+
+    //Only the Ziggurat kind changes the exponential algorithm
+    for (unsigned int j = 2; j < 4; ++j) {
+	RNG *rng = new MersenneTwisterRNG(1234567, kinds[j]);
+	string what = string(names[j]) + " exponential";
+	std::clock_t start = std::clock();
+	for (unsigned int r = 0; r < nrep; ++r) {
+	    rng->exponential(&x[0], N);
+	}
+	report(what.c_str(), total, "variates", start);
+	delete rng;
+    }
+}
+
+static void truncnorm()
+{
+    //Throughput of truncated normal draws over the range of
+    //truncation points seen in probit regression
+
+    unsigned int const N = 1000, nrep = 2000;
+    double total = static_cast<double>(N) * nrep;
+    vector<double> left(N);
+    RNG *rng = new MersenneTwisterRNG(1234567, jags::KINDERMAN_RAMAGE);
+    for (unsigned int i = 0; i < N; ++i) {
+	left[i] = 6.0 * i / N - 3;
+    }
+
+    double sum = 0;
+    std::clock_t start = std::clock();
+    for (unsigned int r = 0; r < nrep; ++r) {
+	for (unsigned int i = 0; i < N; ++i) {
+	    sum += jags::lnormal(left[i], rng);
+	}
+    }
+    report("Left truncated normal", total, "variates", start);
+
+    start = std::clock();
+    for (unsigned int r = 0; r < nrep; ++r) {
+	for (unsigned int i = 0; i < N; ++i) {
+	    sum += jags::inormal(left[i], left[i] + 1, rng);
+	}
+    }
+    report("Interval truncated normal", total, "variates", start);
+    if (!jags_finite(sum)) {
+	std::cout << "Non-finite truncated normal draws" << std::endl;
+    }
+
+    delete rng;
+}
+
+static void sparselda()
+{
+    //Throughput of SparseLDA, in tokens per second, for a synthetic
+    //corpus with an increasing number of topics
+
+    unsigned int const nDoc = 200, docLength = 100, nWord = 1000;
+    unsigned int const nSweep = 10;
+    unsigned int nTopic[3] = {50, 500, 5000};
+    RNG *rng = new MersenneTwisterRNG(1234567, jags::KINDERMAN_RAMAGE);
+
+    vector<vector<int> > words(nDoc, vector<int>(docLength));
+    for (unsigned int d = 0; d < nDoc; ++d) {
+	for (unsigned int i = 0; i < docLength; ++i) {
+	    //Zipf-like word frequencies
+	    double u = rng->uniform();
+	    words[d][i] = static_cast<int>(nWord * u * u * u);
+	}
+    }
+    vector<double> beta(nWord, 0.01);
+
+    for (unsigned int k = 0; k < 3; ++k) {
+	unsigned int K = nTopic[k];
+	vector<vector<int> > topics(nDoc, vector<int>(docLength));
+	for (unsigned int d = 0; d < nDoc; ++d) {
+	    for (unsigned int i = 0; i < docLength; ++i) {
+		topics[d][i] = static_cast<int>(K * rng->uniform());
+	    }
+	}
+	vector<double> alpha(K, 50.0 / K);
+
+	SparseLDA lda(K, nWord, topics, words);
+	for (unsigned int n = 0; n < nSweep; ++n) {
+	    //Burn-in, so that the count tables become sparse
+	    lda.update(&alpha[0], &beta[0], rng);
+	}
+	std::clock_t start = std::clock();
+	for (unsigned int n = 0; n < nSweep; ++n) {
+	    lda.update(&alpha[0], &beta[0], rng);
+	}
+	double ntokens = static_cast<double>(nDoc) * docLength * nSweep;
+	std::string what = "SparseLDA K = " + std::to_string(K);
+	report(what.c_str(), ntokens, "tokens", start);
+    }
+    delete rng;
+}
+
+struct Benchmark {
+    char const *name;
+    void (*run)();
+};
+
+static Benchmark const benchmarks[] = {
+    {"sparselda", sparselda},
+    {"bulk", bulk},
+    {"ziggurat", ziggurat},
+    {"truncnorm", truncnorm}
+};
+
+int main(int argc, char *argv[])
+{
+    unsigned int n = sizeof(benchmarks) / sizeof(benchmarks[0]);
+    for (unsigned int i = 0; i < n; ++i) {
+	bool selected = (argc == 1);
+	for (int j = 1; j < argc; ++j) {
+	    if (strcmp(argv[j], benchmarks[i].name) == 0) {
+		selected = true;
+	    }
+	}
+	if (selected) {
+	    benchmarks[i].run();
+	}
+    }
+    return 0;
+}